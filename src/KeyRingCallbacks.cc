@@ -14,8 +14,37 @@
  */
 
 
+#include <memory>
+
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSemaphore>
+#include <QThread>
+
+#include "Logger.h"
 #include "KeyRingCallbacks.h"
 
+// How often a worker thread that waits for the key dialog checks if it
+// should give up
+#define INTERRUPT_CHECK_MILLISEC        100
+
+
+static QAtomicInt keyRingInterrupted( 0 );
+
+
+/**
+ * The answer of the user for a key dialog that was requested from a worker
+ * thread. This is shared between the worker thread and the GUI thread: The
+ * worker thread might have given up before the GUI thread shows the dialog.
+ **/
+struct KeyDialogRequest
+{
+    int        result = QDialog::Rejected;
+    QSemaphore done;
+};
+
 
 KeyRingCallbacks::KeyRingCallbacks()
 {
@@ -27,3 +56,93 @@ KeyRingCallbacks::~KeyRingCallbacks()
 {
     // Each zypp::Callback disconnects automatically in the dtor.
 }
+
+
+void
+KeyRingCallbacks::interrupt()
+{
+    logInfo() << "Not asking about any more GPG keys" << endl;
+    keyRingInterrupted.storeRelease( 1 );
+}
+
+
+bool
+KeyRingCallbacks::isInterrupted()
+{
+    return keyRingInterrupted.loadAcquire() != 0;
+}
+
+
+ZyppKeyTrust
+KeyRingReceiveCallback::askUserToAcceptKey( const zypp::PublicKey  & key,
+                                            const zypp::KeyContext & context )
+{
+#if 0
+    std::cerr << "** Untrusted key **"
+              << "\nFingerprint: "  << zypp::str::gapify( key.fingerprint(), 4 )
+              << "\nRepo: " << context.repoInfo().name()
+              << "\nURL:  " << context.repoInfo().url()
+              << std::endl;
+#endif
+
+    // A repo refresh worker thread and the GUI thread might need a key at
+    // the same time; without this, the dialogs would be nested.
+
+    static QMutex dialogMutex;
+    QMutexLocker  locker( &dialogMutex );
+
+    if ( KeyRingCallbacks::isInterrupted() )
+    {
+        logWarning() << "Not trusting key for repo " << context.repoInfo().name()
+                     << ": Shutting down" << endl;
+
+        return ZyppKeyTrust::KEY_DONT_TRUST;
+    }
+
+    int result = QDialog::Rejected;
+
+    if ( QThread::currentThread() == qApp->thread() )
+    {
+        RepoGpgKeyImportDialog dialog( key, context.repoInfo() );
+        result = dialog.exec();
+    }
+    else
+    {
+        // Not using a BlockingQueuedConnection: On shutdown, the GUI thread
+        // waits for this thread, so it would never show the dialog, and
+        // both threads would wait for each other forever. Wait in small
+        // steps instead so this can give up after interrupt().
+
+        std::shared_ptr<KeyDialogRequest> request( new KeyDialogRequest );
+        zypp::PublicKey                   pubKey = key;
+        ZyppRepoInfo                      repo   = context.repoInfo();
+
+        QMetaObject::invokeMethod( qApp, [request, pubKey, repo]()
+            {
+                if ( ! KeyRingCallbacks::isInterrupted() )
+                {
+                    RepoGpgKeyImportDialog dialog( pubKey, repo );
+                    request->result = dialog.exec();
+                }
+
+                request->done.release();
+            }, Qt::QueuedConnection );
+
+        while ( ! request->done.tryAcquire( 1, INTERRUPT_CHECK_MILLISEC ) )
+        {
+            if ( KeyRingCallbacks::isInterrupted() )
+            {
+                logWarning() << "Not trusting key for repo " << repo.name()
+                             << ": Shutting down" << endl;
+
+                return ZyppKeyTrust::KEY_DONT_TRUST;
+            }
+        }
+
+        result = request->result;
+    }
+
+    return result == QDialog::Accepted ?
+        ZyppKeyTrust::KEY_TRUST_AND_IMPORT :
+        ZyppKeyTrust::KEY_DONT_TRUST;
+}
@@ -37,24 +37,17 @@ typedef zypp::KeyRingReport::KeyTrust  ZyppKeyTrust;
 struct KeyRingReceiveCallback:
     public zypp::callback::ReceiveReport<zypp::KeyRingReport>
 {
+    /**
+     * Ask the user if an unknown key should be trusted.
+     *
+     * This may be called from a worker thread (see RepoRefresher); the
+     * dialog is always shown in the GUI thread, one at a time. The worker
+     * thread does not block the GUI thread while it waits for the answer,
+     * and it gives up (i.e. does not trust the key) after
+     * KeyRingCallbacks::interrupt().
+     **/
     virtual ZyppKeyTrust askUserToAcceptKey( const zypp::PublicKey  & key,
-                                             const zypp::KeyContext & context ) override
-        {
-#if 0
-            std::cerr << "** Untrusted key **"
-                      << "\nFingerprint: "  << zypp::str::gapify( key.fingerprint(), 4 )
-                      << "\nRepo: " << context.repoInfo().name()
-                      << "\nURL:  " << context.repoInfo().url()
-                      << std::endl;
-#endif
-            RepoGpgKeyImportDialog dialog( key, context.repoInfo() );
-            int result = dialog.exec();
-
-            return result == QDialog::Accepted ?
-                ZyppKeyTrust::KEY_TRUST_AND_IMPORT :
-                ZyppKeyTrust::KEY_DONT_TRUST;
-        }
-
+                                             const zypp::KeyContext & context ) override;
 
     virtual bool askUserToAcceptUnsignedFile( const std::string      & file,
                                               const zypp::KeyContext & context ) override
@@ -97,6 +90,21 @@ public:
      **/
     virtual ~KeyRingCallbacks();
 
+    /**
+     * Don't ask the user about any more keys, and make worker threads that
+     * are waiting for an answer give up. Use this before waiting for those
+     * threads when the program is shutting down: The GUI thread won't show
+     * the dialog for them anymore.
+     *
+     * This is permanent for the rest of the program run.
+     **/
+    static void interrupt();
+
+    /**
+     * Return 'true' if interrupt() was called.
+     **/
+    static bool isInterrupted();
+
 
 protected:
 
@@ -11,11 +11,21 @@
 #include <QFile>
 #include <QDir>
 #include <QDateTime>
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QString>
 #include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <streambuf>
 
 #include <string.h>     // strlen()
-#include <stdlib.h>     // abort(), mkdtemp()
+#include <stdlib.h>     // abort(), mkdtemp(), atexit()
+#include <signal.h>     // signal(), raise()
 #include <unistd.h>     // getpid()
 #include <errno.h>
 #include <pwd.h>        // getpwuid()
@@ -26,6 +36,16 @@
 
 #define VERBOSE_ROTATE  0
 
+// Async mode: The writer thread wakes up at least this often to write the
+// pending log lines, or earlier if that many bytes are pending.
+
+#define LOG_WRITER_INTERVAL_MILLISEC    100
+#define LOG_WRITER_BATCH_SIZE           64 * 1024
+
+// Max. time to wait for pending log lines to be written in a crash.
+
+#define LOG_CRASH_FLUSH_MILLISEC        1000
+
 using std::endl;
 using std::cerr;
 
@@ -35,10 +55,249 @@ static void qt_logger( QtMsgType                  msgType,
                        const QMessageLogContext & context,
                        const QString &            msg );
 
+static void installCrashHandlers();
+
+
+/**
+ * Background thread for a logger in async mode: It collects the log lines
+ * of all threads and writes them to the log file in batches.
+ **/
+class LogWriter: public QThread
+{
+public:
+
+    LogWriter( LogStream & logStream )
+        : _logStream( logStream )
+        , _stopping( false )
+        , _finished( false )
+        , _queuedLines( 0 )
+        , _writtenLines( 0 )
+        {}
+
+    /**
+     * Add 'text' (one or more complete lines) to the pending lines.
+     * This is thread-safe and very cheap: It only appends to a string.
+     *
+     * If the thread is already finished (another thread might still have
+     * picked up this writer just before async mode was switched off), the
+     * text is written directly.
+     **/
+    void enqueue( const std::string & text )
+    {
+        QMutexLocker locker( &_mutex );
+
+        if ( _finished )
+        {
+            _logStream.write( text.data(), text.size() );
+            _logStream.flush();
+            return;
+        }
+
+        _pending += text;
+        ++_queuedLines;
+
+        if ( _pending.size() >= LOG_WRITER_BATCH_SIZE )
+            _dataAvailable.wakeOne();
+    }
+
+    /**
+     * Wait until everything that was enqueued until now is written, but
+     * not longer than 'timeoutMillisec'. Return 'true' on success.
+     **/
+    bool flush( int timeoutMillisec = -1 )
+    {
+        QDeadlineTimer deadline( QDeadlineTimer::Forever );
+
+        if ( timeoutMillisec >= 0 )
+            deadline.setRemainingTime( timeoutMillisec );
+
+        // Don't wait for the mutex forever: In a crash, the crashing thread
+        // might be the one holding it.
+
+        if ( ! _mutex.tryLock( deadline ) )
+            return false;
+
+        qint64 target = _queuedLines;
+        _dataAvailable.wakeOne();
+
+        while ( _writtenLines < target && isRunning() )
+        {
+            if ( ! _linesWritten.wait( &_mutex, deadline ) )
+                break;
+        }
+
+        bool success = _writtenLines >= target;
+        _mutex.unlock();
+
+        return success;
+    }
+
+    /**
+     * Write all pending lines and stop the thread.
+     **/
+    void stop()
+    {
+        {
+            QMutexLocker locker( &_mutex );
+            _stopping = true;
+            _dataAvailable.wakeOne();
+        }
+
+        wait();
+    }
+
+protected:
+
+    virtual void run() override
+    {
+        std::string batch;
+        QMutexLocker locker( &_mutex );
+
+        while ( true )
+        {
+            if ( _pending.empty() )
+            {
+                if ( _stopping )
+                    break;
+
+                // Collect log lines for a while, then write them all at once
+
+                _dataAvailable.wait( &_mutex, LOG_WRITER_INTERVAL_MILLISEC );
+                continue;
+            }
+
+            batch.swap( _pending );
+            qint64 queuedLines = _queuedLines;
+
+            // Write without holding the mutex so the other threads can
+            // continue to log in the meantime
+
+            locker.unlock();
+
+            _logStream.write( batch.data(), batch.size() );
+            _logStream.flush();
+            batch.clear();
+
+            locker.relock();
+
+            _writtenLines = queuedLines;
+            _linesWritten.wakeAll();
+        }
+
+        _finished = true;
+    }
+
+private:
+
+    LogStream &    _logStream;
+    QMutex         _mutex;
+    QWaitCondition _dataAvailable;
+    QWaitCondition _linesWritten;
+    std::string    _pending;
+    bool           _stopping;
+    bool           _finished;
+    qint64         _queuedLines;
+    qint64         _writtenLines;
+};
+
+
+/**
+ * Stream buffer for the log lines of one thread and one logger in async
+ * mode: It collects the text of a log line, and when the line is terminated
+ * with 'endl' (which calls sync()), it hands it over to the logger.
+ **/
+class LogLineBuffer: public std::streambuf
+{
+public:
+
+    LogLineBuffer( Logger * logger )
+        : _logger( logger )
+        {}
+
+protected:
+
+    virtual int_type overflow( int_type ch ) override
+    {
+        if ( ! traits_type::eq_int_type( ch, traits_type::eof() ) )
+            _line += traits_type::to_char_type( ch );
+
+        return traits_type::not_eof( ch );
+    }
+
+    virtual std::streamsize xsputn( const char * text, std::streamsize len ) override
+    {
+        _line.append( text, len );
+        return len;
+    }
+
+    virtual int sync() override
+    {
+        if ( ! _line.empty() )
+        {
+            // Don't remember the writer: Async mode might have been
+            // switched off while this line was formatted.
+
+            _logger->writeText( _line );
+            _line.clear();
+        }
+
+        return 0;
+    }
+
+private:
+
+    Logger *    _logger;
+    std::string _line;
+};
+
+
+/**
+ * Log stream of one thread for one logger in async mode.
+ **/
+struct ThreadLogStream
+{
+    ThreadLogStream( Logger * logger )
+        : buffer( logger )
+    {
+        // Not an actual file stream: Everything goes to the buffer
+
+        static_cast<std::ostream &>( stream ).rdbuf( &buffer );
+    }
+
+    LogLineBuffer buffer;
+    LogStream     stream;
+};
+
+
+LogStream & Logger::threadLogStream()
+{
+    // One stream per logger: A log line for another logger (e.g. from a
+    // function called in the middle of the '<<' chain) must not end up in
+    // the line that is being formatted for this one.
+
+    struct ThreadLogStreams
+    {
+        ~ThreadLogStreams() { qDeleteAll( streams ); }
+
+        QHash<const Logger *, ThreadLogStream *> streams;
+    };
+
+    thread_local ThreadLogStreams threadStreams;
+    ThreadLogStream * & threadStream = threadStreams.streams[ this ];
+
+    if ( ! threadStream )
+        threadStream = new ThreadLogStream( this );
+
+    return threadStream->stream;
+}
+
 
 Logger * Logger::_defaultLogger = 0;
 QString  Logger::_lastLogDir;
 
+static QList<Logger *> asyncLoggers;
+static QMutex          asyncLoggersMutex;
+
 
 Logger::Logger( const QString & filename )
 {
@@ -71,6 +330,10 @@ Logger::Logger( const QString & rawLogDir,
 
 Logger::~Logger()
 {
+    setAsync( false );
+
+    qDeleteAll( _retiredWriters );
+
     if ( _logStream.is_open() )
     {
         // logInfo() << "-- Log End --\n" << endl;
@@ -121,7 +384,7 @@ void Logger::openLogFile( const QString & filename )
 
             cerr << "Logging to " << qPrintable( filename ) << endl;
             _logStream << "\n\n";
-            log( __FILE__, __LINE__, __FUNCTION__, LogSeverityInfo )
+            log( LOG_SRC_FILE, __LINE__, __FUNCTION__, LogSeverityInfo )
                 << "-- Log Start --" << endl;
         }
         else
@@ -144,6 +407,20 @@ LogStream & Logger::log( Logger *        logger,
                          int             srcLine,
                          const QString & srcFunction,
                          LogSeverity     severity )
+{
+    return log( logger,
+                srcFile.toUtf8().constData(),
+                srcLine,
+                srcFunction.toUtf8().constData(),
+                severity );
+}
+
+
+LogStream & Logger::log( Logger *     logger,
+                         const char * srcFile,
+                         int          srcLine,
+                         const char * srcFunction,
+                         LogSeverity  severity )
 {
     static LogStream stderrStream;
 
@@ -166,11 +443,23 @@ LogStream & Logger::log( const QString & srcFile,
                          int             srcLine,
                          const QString & srcFunction,
                          LogSeverity     severity )
+{
+    return log( srcFile.toUtf8().constData(),
+                srcLine,
+                srcFunction.toUtf8().constData(),
+                severity );
+}
+
+
+LogStream & Logger::log( const char * srcFile,
+                         int          srcLine,
+                         const char * srcFunction,
+                         LogSeverity  severity )
 {
     if ( severity < _logLevel )
         return _nullStream;
 
-    std::string sev;
+    const char * sev = "";
 
     switch ( severity )
     {
@@ -183,40 +472,29 @@ LogStream & Logger::log( const QString & srcFile,
             // complain about unhandled enum values
     }
 
-    _logStream << Logger::timeStamp() << " "
-               << "[" << (int) getpid() << "] "
-               << sev << " ";
+    LogStream & str = isAsync() ? threadLogStream() : _logStream;
 
-    if ( ! srcFile.isEmpty() )
-    {
-        if ( srcFile.contains( "/") )
-        {
-            // CMake just dumps the whole path wholesale to the compiler
-            // command line which gcc merrily uses as __FILE__;
-            // which results in an abysmal-looking log line.
-            // So let's cut off the path: Use only the last (No. -1)
-            // section delimited with '/'.
+    str << cachedTimeStamp() << " "
+        << "[" << pid() << "] "
+        << sev << " ";
 
-            QString basename = srcFile.section( '/', -1 );
-            _logStream << basename;
+    if ( srcFile && *srcFile )
+    {
+        // The log macros already cut off the path at compile time, but Qt
+        // messages and the QString overloads might still have one.
 
-            // I hate CMake. Seriously, WTF?!
-        }
-        else
-        {
-            _logStream << srcFile;
-        }
+        str << logBasename( srcFile );
 
         if ( srcLine > 0 )
-            _logStream << ":" << srcLine;
+            str << ":" << srcLine;
 
-        _logStream << " ";
+        str << " ";
 
-        if ( ! srcFunction.isEmpty() )
-            _logStream << srcFunction << "():  ";
+        if ( srcFunction && *srcFunction )
+            str << srcFunction << "():  ";
     }
 
-    return _logStream;
+    return str;
 }
 
 
@@ -254,7 +532,139 @@ void Logger::setLogLevel( Logger *logger, LogSeverity newLevel )
 
 void Logger::newline()
 {
-    _logStream << endl;
+    writeText( "\n" );
+}
+
+
+void Logger::writeLine( const std::string & line )
+{
+    writeText( line + "\n" );
+}
+
+
+void Logger::writeText( const std::string & text )
+{
+    LogWriter * writer = _writer.loadAcquire();
+
+    if ( writer )
+        writer->enqueue( text );
+    else
+    {
+        _logStream << text;
+        _logStream.flush();
+    }
+}
+
+
+void Logger::setAsync( bool async )
+{
+    if ( async == isAsync() )
+        return;
+
+    if ( async )
+    {
+        _logStream.flush();
+
+        LogWriter * writer = new LogWriter( _logStream );
+        writer->start();
+        _writer.storeRelease( writer );
+
+        QMutexLocker locker( &asyncLoggersMutex );
+        asyncLoggers << this;
+
+        installCrashHandlers();
+    }
+    else
+    {
+        {
+            QMutexLocker locker( &asyncLoggersMutex );
+            asyncLoggers.removeAll( this );
+        }
+
+        // From now on, write directly to the log file again
+
+        LogWriter * writer = _writer.fetchAndStoreOrdered( 0 );
+        writer->stop(); // Write all pending lines
+
+        // Other threads might just have picked up that writer for a log
+        // line, so it can't be deleted yet; a finished writer writes
+        // directly to the log file.
+
+        _retiredWriters << writer;
+    }
+}
+
+
+void Logger::flush( int timeoutMillisec )
+{
+    LogWriter * writer = _writer.loadAcquire();
+
+    if ( writer )
+        writer->flush( timeoutMillisec );
+    else
+        _logStream.flush();
+}
+
+
+void Logger::flushAll()
+{
+    QMutexLocker locker( &asyncLoggersMutex );
+
+    for ( Logger * logger: asyncLoggers )
+        logger->flush();
+}
+
+
+/**
+ * Flush all async loggers when the program exits with exit() without
+ * destroying them first.
+ **/
+static void flushAllAtExit()
+{
+    Logger::flushAll();
+}
+
+
+/**
+ * Write the pending log lines of all async loggers, if possible, when the
+ * program crashes, then let the signal do what it would normally do
+ * (typically terminate the program with a core dump).
+ **/
+static void crashHandler( int sig )
+{
+    // This is not strictly async-signal-safe, but the alternative is losing
+    // the last log lines which are the most interesting ones after a crash.
+    // Use timeouts so this can't block forever if the crash happened in the
+    // middle of logging.
+
+    if ( asyncLoggersMutex.tryLock( LOG_CRASH_FLUSH_MILLISEC ) )
+    {
+        for ( Logger * logger: asyncLoggers )
+        {
+            if ( logger->isAsync() )
+                logger->flush( LOG_CRASH_FLUSH_MILLISEC );
+        }
+
+        asyncLoggersMutex.unlock();
+    }
+
+    signal( sig, SIG_DFL );
+    raise( sig );
+}
+
+
+static void installCrashHandlers()
+{
+    static bool installed = false;
+
+    if ( installed )
+        return;
+
+    installed = true;
+    atexit( flushAllAtExit );
+
+    for ( int sig: { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT } )
+        signal( sig, crashHandler );
 }
 
 
@@ -264,6 +674,31 @@ QString Logger::timeStamp()
 }
 
 
+const std::string & Logger::cachedTimeStamp()
+{
+    thread_local qint64      lastMillisec = -1;
+    thread_local std::string timeStampCache;
+
+    qint64 millisec = QDateTime::currentMSecsSinceEpoch();
+
+    if ( millisec != lastMillisec )
+    {
+        lastMillisec   = millisec;
+        timeStampCache = timeStamp().toStdString();
+    }
+
+    return timeStampCache;
+}
+
+
+int Logger::pid()
+{
+    static int cachedPid = (int) getpid();
+
+    return cachedPid;
+}
+
+
 QString Logger::prefixLines( const QString & prefix,
                              const QString & multiLineText )
 {
@@ -15,12 +15,17 @@
 #include <iostream>
 #include <fstream>
 
+#include <QAtomicPointer>
+#include <QList>
 #include <QString>
 #include <QStringList>
 
 
 typedef std::ofstream LogStream;
 
+class LogWriter;
+class LogLineBuffer;
+
 
 // Define NO_USING_STD_ENDL before including this header (or on the compiler
 // command line) if you are anal about this in your own code, but do not remove
@@ -48,6 +53,46 @@ enum LogSeverity
 };
 
 
+/**
+ * Return the file name part of 'path', i.e. everything after the last '/'.
+ *
+ * CMake passes the complete path of each source file to the compiler which
+ * uses it for __FILE__. Since this is constexpr, the compiler can cut off the
+ * path at compile time rather than the logger doing that for each log line.
+ **/
+constexpr const char * logBasename( const char * path )
+{
+    const char * basename = path;
+
+    for ( const char * pos = path; *pos; ++pos )
+    {
+        if ( *pos == '/' )
+            basename = pos + 1;
+    }
+
+    return basename;
+}
+
+
+// Source file name without the path for the log macros.
+// Newer compilers (gcc 12, clang 9) have that built in.
+
+#ifdef __FILE_NAME__
+#  define LOG_SRC_FILE  __FILE_NAME__
+#else
+#  define LOG_SRC_FILE  logBasename( __FILE__ )
+#endif
+
+
+// Lowest severity that is compiled in at all. Anything below that is dead
+// code that the compiler removes completely. Use the LOG_NO_DEBUG CMake
+// option for release builds without logVerbose() and logDebug().
+
+#ifndef LOG_MIN_SEVERITY
+#  define LOG_MIN_SEVERITY      LogSeverityVerbose
+#endif
+
+
 // Log macros for stream (LogStream) output.
 //
 // Unlike qDebug() etc., they also record the location in the source code that
@@ -59,15 +104,37 @@ enum LogSeverity
 // Usage example:
 //
 //   logDebug() << "Result: " << result << endl;
-
-#define logVerbose()    Logger::log( 0, __FILE__, __LINE__, __FUNCTION__, LogSeverityVerbose   )
-#define logDebug()      Logger::log( 0, __FILE__, __LINE__, __FUNCTION__, LogSeverityDebug     )
-#define logInfo()       Logger::log( 0, __FILE__, __LINE__, __FUNCTION__, LogSeverityInfo      )
-#define logWarning()    Logger::log( 0, __FILE__, __LINE__, __FUNCTION__, LogSeverityWarning   )
-#define logError()      Logger::log( 0, __FILE__, __LINE__, __FUNCTION__, LogSeverityError     )
+//
+// If the severity is below the log level of the default logger (or below
+// LOG_MIN_SEVERITY), nothing on the right side of logDebug() is evaluated,
+// so there is no runtime cost for formatting anything.
+//
+// This uses the ?: operator rather than an 'if' to avoid ambiguous 'else'
+// problems when a log macro is used in an 'if' without braces. Since '&' has
+// a lower precedence than '<<', the complete '<<' chain is on the right side
+// of the '&', and LogVoidify makes both sides of the ?: 'void'.
+
+#define LOG_IF_ENABLED( severity )                                      \
+    ! Logger::isEnabled( severity ) ? (void) 0 :                        \
+        LogVoidify() & Logger::log( 0, LOG_SRC_FILE, __LINE__, __FUNCTION__, severity )
+
+#define logVerbose()    LOG_IF_ENABLED( LogSeverityVerbose )
+#define logDebug()      LOG_IF_ENABLED( LogSeverityDebug   )
+#define logInfo()       LOG_IF_ENABLED( LogSeverityInfo    )
+#define logWarning()    LOG_IF_ENABLED( LogSeverityWarning )
+#define logError()      LOG_IF_ENABLED( LogSeverityError   )
 #define logNewline()    Logger::newline( 0 )
 
 
+/**
+ * Helper for the log macros to discard the result of a '<<' chain.
+ **/
+struct LogVoidify
+{
+    void operator&( std::ostream & ) {}
+};
+
+
 /**
  * Log the signal sender of a QObject.
  *
@@ -107,6 +174,10 @@ enum LogSeverity
  * QByteArray, int).
  *
  * This class also redirects Qt logging (qDebug() etc.) to the same log file.
+ *
+ * In async mode (see setAsync()), each thread formats its log lines in a
+ * buffer of its own, and a background thread writes them to the log file in
+ * batches. This keeps the file I/O out of the threads that do the real work.
  */
 class Logger
 {
@@ -150,6 +221,16 @@ public:
                      const QString & srcFunction,
                      LogSeverity     severity );
 
+    /**
+     * Internal logging function with plain C strings: This avoids converting
+     * the source file name and function name to QString for each log line.
+     * 'srcFile' and 'srcFunction' may be 0.
+     */
+    LogStream & log( const char * srcFile,
+                     int          srcLine,
+                     const char * srcFunction,
+                     LogSeverity  severity );
+
     /**
      * Static version of the internal logging function.
      * Use the logDebug(), logWarning() etc. macros instead.
@@ -162,6 +243,18 @@ public:
                             const QString & srcFunction,
                             LogSeverity     severity );
 
+    /**
+     * Static version of the internal logging function with plain C strings.
+     * This is what the logDebug(), logWarning() etc. macros use.
+     *
+     * If 'logger' is 0, the default logger is used.
+     */
+    static LogStream & log( Logger *     logger,
+                            const char * srcFile,
+                            int          srcLine,
+                            const char * srcFunction,
+                            LogSeverity  severity );
+
     /**
      * Log a plain newline without any prefix (timestamp, source file name,
      * line number).
@@ -169,12 +262,58 @@ public:
     void newline();
     static void newline( Logger * logger );
 
+    /**
+     * Write a complete, already formatted line without any prefix to the log
+     * file. A newline is appended. This is thread-safe.
+     */
+    void writeLine( const std::string & line );
+
+    /**
+     * Switch async mode on or off: In async mode, log lines are passed to a
+     * background thread that writes them to the log file in batches.
+     *
+     * Pending log lines are written when async mode is switched off again,
+     * when this logger is destroyed, when the program exits with exit(), and
+     * (on a best-effort basis) when it crashes with a fatal signal.
+     */
+    void setAsync( bool async );
+
+    /**
+     * Return 'true' if this logger is in async mode.
+     */
+    bool isAsync() const { return _writer.loadAcquire() != 0; }
+
+    /**
+     * Wait until all pending log lines of this logger are written to the
+     * log file, but not longer than 'timeoutMillisec' (-1: no timeout).
+     */
+    void flush( int timeoutMillisec = -1 );
+
+    /**
+     * Flush all loggers that are in async mode.
+     */
+    static void flushAll();
+
     /**
      * Return a timestamp string in the format used in the log file:
      * "yyyy-MM-dd hh:mm:ss.zzz"
      */
     static QString timeStamp();
 
+    /**
+     * Return the timestamp in the same format as a std::string.
+     *
+     * This is cached per thread and only formatted again when the
+     * millisecond changes, which is much cheaper than timeStamp() for a lot
+     * of log lines.
+     */
+    static const std::string & cachedTimeStamp();
+
+    /**
+     * Return the process ID for the log lines. This is cached.
+     */
+    static int pid();
+
     /**
      * Prefix each line of a multi-line text with 'prefix'.
      */
@@ -213,20 +352,30 @@ public:
      * Return the current log level, i.e. the severity that will actually be
      * logged. Any lower severity will be suppressed.
      *
-     * Notice that due to the way C++ evaluates expressions, the runtime cost
-     * will not change significantly, only the log file size:
+     * The log macros check that before evaluating anything else, so in
      *
      *     logDebug() << "Result: " << myObj->result() << endl;
      *
-     * Even if the log level is higher than logDebug(), this will still call
-     * myObj->result() and its operator<<(). If you want to avoid that, use
-     * your own 'if' around the log output:
-     *
-     * if ( logLevel() >= LogSeverityDebug )
-     *     logDebug() ...
+     * myObj->result() and its operator<<() are not called at all if the log
+     * level is higher than logDebug().
      */
     LogSeverity logLevel() const { return _logLevel; }
 
+    /**
+     * Return 'true' if 'severity' is compiled in and not below the log level
+     * of the default logger, i.e. if a log line with that severity would
+     * actually be written.
+     *
+     * This is what the log macros check first. It is inline and cheap.
+     */
+    static bool isEnabled( LogSeverity severity )
+    {
+        if ( severity < LOG_MIN_SEVERITY )  // Constant: Resolved at compile time
+            return false;
+
+        return ! _defaultLogger || severity >= _defaultLogger->_logLevel;
+    }
+
     /**
      * Set the log level.
      */
@@ -312,9 +461,23 @@ protected:
      **/
     static QString oldNamePattern( const QString & filename );
 
+    /**
+     * Return the log stream of the current thread for this logger in async
+     * mode.
+     **/
+    LogStream & threadLogStream();
+
+    /**
+     * Write 'text' (one or more complete lines) to the log file: Via the
+     * writer thread in async mode, directly otherwise.
+     **/
+    void writeText( const std::string & text );
+
 
 private:
 
+    friend class LogLineBuffer;
+
     static Logger * _defaultLogger;
     static QString  _lastLogDir;
 
@@ -322,6 +485,8 @@ private:
     QString         _logFilename;
     LogStream       _nullStream;
     LogSeverity     _logLevel;
+    QAtomicPointer<LogWriter> _writer;
+    QList<LogWriter *>        _retiredWriters;
 };
 
 
@@ -15,6 +15,7 @@
 
 
 #include <unistd.h>     // getuid()
+#include <iostream>     // cout
 
 #include <QApplication>
 #include <QLabel>
@@ -29,11 +30,13 @@
 #include "MyrlynWorkflowSteps.h"
 #include "PkgCommitPage.h"
 #include "PkgTasks.h"
+#include "StartupTimer.h"
 #include "SummaryPage.h"
 #include "Workflow.h"
 #include "YQPkgSelector.h"
 #include "YQi18n.h"
 #include "ZyppLogger.h"
+#include "utf8.h"
 #include "MyrlynApp.h"
 
 
@@ -476,6 +479,24 @@ void MyrlynApp::quit( bool askForConfirmation )
 }
 
 
+void MyrlynApp::startupDone()
+{
+    StartupTimer * startupTimer = StartupTimer::instance();
+
+    if ( startupTimer->isFinished() )
+        return;
+
+    startupTimer->finish();
+    startupTimer->logReport();
+
+    if ( isOptionSet( OptBenchmarkStartup ) )
+    {
+        std::cout << toUTF8( startupTimer->toJson() ) << std::flush;
+        quit();
+    }
+}
+
+
 QFont
 MyrlynApp::headingFont()
 {
@@ -43,6 +43,7 @@ enum MyrlynAppOption
     OptDownloadOnly     = 0x04,
     OptNoRepoRefresh    = 0x08,
     OptForceServiceView = 0x10,
+    OptFastStart        = 0x20,
 
     // For debugging
 
@@ -50,7 +51,8 @@ enum MyrlynAppOption
     OptFakeCommit       = 0x0200,
     OptFakeSummary      = 0x0400,
     OptFakeTranslations = 0x0800,  // "xixoxixoxixo" everywhere
-    OptSlowRepoRefresh  = 0x1000
+    OptSlowRepoRefresh  = 0x1000,
+    OptBenchmarkStartup = 0x2000
 };
 
 // See https://doc.qt.io/qt-5/qflags.html
@@ -238,6 +240,15 @@ public slots:
      **/
     void quit( bool askForConfirmation = false );
 
+    /**
+     * Startup is complete: The package selector is visible.
+     * Log the startup timing report.
+     *
+     * With OptBenchmarkStartup (--benchmark-startup), print the timings
+     * in JSON format to stdout and quit the program.
+     **/
+    void startupDone();
+
 
 protected:
 
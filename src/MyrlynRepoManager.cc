@@ -17,12 +17,14 @@
 #include <unistd.h>             // sleep()
 #include <iostream>             // cerr
 #include <clocale>              // std::setlocale()
-#include <QElapsedTimer>
 #include <QMessageBox>
+#include <QTimer>
 
 #include <zypp/ZYppFactory.h>
 #include <zypp/Locale.h>
 #include <zypp/ZConfig.h>
+#include <zypp/repo/RepoException.h>
+#include <zypp/ui/Selectable.h>
 
 #include "Exception.h"
 #include "KeyRingCallbacks.h"
@@ -30,12 +32,15 @@
 #include "MainWindow.h"
 #include "MyrlynApp.h"
 #include "QY2CursorHelper.h"
+#include "StartupTimer.h"
 #include "YQi18n.h"
 #include "utf8.h"
 #include "MyrlynRepoManager.h"
 
 
 MyrlynRepoManager::MyrlynRepoManager()
+    : _backgroundRefresher( 0 )
+    , _backgroundKeyRingCallbacks( 0 )
 {
     logDebug() << "Creating MyrlynRepoManager" << endl;
 }
@@ -45,6 +50,20 @@ MyrlynRepoManager::~MyrlynRepoManager()
 {
     logDebug() << "Destroying MyrlynRepoManager..." << endl;
 
+    if ( _backgroundRefresher )
+    {
+        // The event loop is no longer running, so a background refresh
+        // worker that needs a GPG key would wait forever for the dialog
+        // while this waits for the worker.
+
+        KeyRingCallbacks::interrupt();
+        _backgroundRefresher->cancel();
+    }
+
+    // This waits for the background refresh worker thread to finish
+    delete _backgroundRefresher;
+    delete _backgroundKeyRingCallbacks;
+
     shutdownZypp();
 
     logDebug() << "Destroying MyrlynRepoManager done" << endl;
@@ -58,8 +77,15 @@ void MyrlynRepoManager::initTarget()
 
     logDebug() << "Initializing zypp..." << endl;
 
-    zyppPtr()->initializeTarget( "/", false );  // don't rebuild rpmdb
-    zyppPtr()->target()->load(); // Load pkgs from the target (rpmdb)
+    {
+        StartupPhase phase( "initializeTarget" );
+        zyppPtr()->initializeTarget( "/", false );  // don't rebuild rpmdb
+    }
+
+    {
+        StartupPhase phase( "loadTarget" );
+        zyppPtr()->target()->load(); // Load pkgs from the target (rpmdb)
+    }
 
     logDebug() << "Initializing zypp done" << endl;
 }
@@ -101,6 +127,7 @@ MyrlynRepoManager::repoManager()
 
 void MyrlynRepoManager::zyppConnect( int attempts, int waitSeconds )
 {
+    StartupPhase phase( "zyppConnect" );
     (void) zyppConnectInternal( attempts, waitSeconds );
     initZyppLocale();
 }
@@ -173,8 +200,22 @@ void MyrlynRepoManager::attachRepos()
     try
     {
         findEnabledRepos();
-        refreshRepos();
-        loadRepos();
+
+        if ( isFastStart() )
+        {
+            logInfo() << "Fast start: Loading the cached repos" << endl;
+            loadRepos( true );  // skipUncached
+
+            // Start the refresh only when the event loop is running,
+            // i.e. when the package selector is already there.
+
+            QTimer::singleShot( 0, this, SLOT( startBackgroundRefresh() ) );
+        }
+        else
+        {
+            refreshRepos();
+            loadRepos();
+        }
     }
     catch ( const zypp::Exception & ex )
     {
@@ -231,61 +272,308 @@ void MyrlynRepoManager::refreshRepos()
     if ( MyrlynApp::isOptionSet( OptNoRepoRefresh ) )
         return;
 
-    KeyRingCallbacks keyRingCallbacks;
-    QElapsedTimer    timer;
-    _failedRepos.clear();
+    StartupPhase             phase( "refreshRepos" );
+    KeyRingCallbacks         keyRingCallbacks;
+    zypp::RepoManagerOptions options;
+    RepoRefresher            refresher( options );
+
+    if ( MyrlynApp::isOptionSet( OptSlowRepoRefresh ) )
+        refresher.setLatencyMillisec( 2000 );
+
+    connect( &refresher, SIGNAL( refreshRepoStart( ZyppRepoInfo ) ),
+             this,       SIGNAL( refreshRepoStart( ZyppRepoInfo ) ) );
+
+    connect( &refresher, SIGNAL( refreshRepoDone ( ZyppRepoInfo ) ),
+             this,       SIGNAL( refreshRepoDone ( ZyppRepoInfo ) ) );
+
+    connect( &refresher, SIGNAL( refreshRepoError( ZyppRepoInfo ) ),
+             this,       SIGNAL( refreshRepoError( ZyppRepoInfo ) ) );
+
+    refresher.refresh( _repos );
+    _failedRepos = refresher.failedRepos();
 
     for ( ZyppRepoInfo & repo: _repos )
     {
-        try
+        for ( const ZyppRepoInfo & failedRepo: _failedRepos )
         {
-            timer.start();
-            logInfo() << "Refreshing repo " << repo.name() << "..." << endl;
-            emit refreshRepoStart( repo );
+            if ( repo.alias() == failedRepo.alias() )
+            {
+                logInfo() << "Disabling repo " << repo.name() << endl;
+                repo.setEnabled( false );
+            }
+        }
+    }
 
-            repoManager()->refreshMetadata( repo, zypp::RepoManager::RefreshIfNeeded );
-            repoManager()->buildCache     ( repo, zypp::RepoManager::BuildIfNeeded   );
+    showFailedRepos();
+}
 
-            if ( MyrlynApp::isOptionSet( OptSlowRepoRefresh ) )
-                sleep( 2 );
 
-            logInfo() << "Refreshing repo " << repo.name()
-                      << " done after " << timer.elapsed() / 1000.0 << " sec"
-                      << endl;
+bool MyrlynRepoManager::isFastStart() const
+{
+    return MyrlynApp::isOptionSet( OptFastStart )       &&
+        ! MyrlynApp::isOptionSet( OptNoRepoRefresh )    &&
+        MyrlynApp::runningAsRealRoot();
+}
 
-            emit refreshRepoDone( repo );
-        }
-        catch ( const zypp::repo::RepoException & exception )
-        {
-            Q_UNUSED( exception );
-            logWarning() << "CAUGHT zypp exception for repo " << repo.name() << endl;
 
-            logInfo() << "Disabling repo " << repo.name() << endl;
-            repo.setEnabled( false );
-            _failedRepos.push_back( repo );
+bool MyrlynRepoManager::isRefreshingInBackground() const
+{
+    return _backgroundRefresher && _backgroundRefresher->isRunning();
+}
+
 
-            emit refreshRepoError( repo );
-        }
-    }
+void MyrlynRepoManager::stopBackgroundRefresh()
+{
+    if ( ! isRefreshingInBackground() )
+        return;
 
-    showFailedRepos();
+    logInfo() << "Stopping the background repo refresh" << endl;
+
+    busyCursor();
+
+    // When the refresher is done, backgroundRefreshDone() resets
+    // _backgroundRefresher and deletes it with deleteLater().
+
+    _backgroundRefresher->cancel();
+    _backgroundRefresher->waitForFinished();
+
+    normalCursor();
 }
 
 
-void MyrlynRepoManager::loadRepos()
+void MyrlynRepoManager::loadRepos( bool skipUncached )
 {
+    StartupPhase loadPhase( "loadRepos" );
+
     for ( const ZyppRepoInfo & repo: _repos )
     {
         if ( repo.enabled() )
         {
             logDebug() << "Loading resolvables from " << repo.name() << endl;
-            repoManager()->loadFromCache( repo );
+
+            try
+            {
+                StartupPhase phase( "loadFromCache " + fromUTF8( repo.alias() ) );
+                repoManager()->loadFromCache( repo );
+            }
+            catch ( const zypp::repo::RepoNotCachedException & exception )
+            {
+                if ( ! skipUncached )
+                    throw;
+
+                logInfo() << "No cache yet for repo " << repo.name()
+                          << "; loading it after the refresh" << endl;
+            }
         }
         else
         {
             logInfo() << "Skipping disabled repo " << repo.name() << endl;
         }
     }
+
+    StartupPhase indexPhase( "buildSearchIndex" );
+    _searchIndex.build();
+}
+
+
+void MyrlynRepoManager::startBackgroundRefresh()
+{
+    if ( _backgroundRefresher )
+        return;
+
+    zypp::RepoManagerOptions options;
+
+    _backgroundKeyRingCallbacks = new KeyRingCallbacks();
+    CHECK_NEW( _backgroundKeyRingCallbacks );
+
+    _backgroundRefresher = new RepoRefresher( options );
+    CHECK_NEW( _backgroundRefresher );
+
+    if ( MyrlynApp::isOptionSet( OptSlowRepoRefresh ) )
+        _backgroundRefresher->setLatencyMillisec( 2000 );
+
+    // Not forwarding refreshRepoStart() etc.: The InitReposPage that shows
+    // them is no longer visible.
+
+    connect( _backgroundRefresher, SIGNAL( repoCacheChanged     ( ZyppRepoInfo ) ),
+             this,                 SLOT  ( backgroundRepoChanged( ZyppRepoInfo ) ) );
+
+    connect( _backgroundRefresher, SIGNAL( allReposDone()          ),
+             this,                 SLOT  ( backgroundRefreshDone() ) );
+
+    logInfo() << "Starting the background repo refresh" << endl;
+    _backgroundRefresher->start( _repos );
+}
+
+
+void MyrlynRepoManager::backgroundRepoChanged( const ZyppRepoInfo & repo )
+{
+    logInfo() << "Cache changed for repo " << repo.name() << endl;
+
+    for ( const ZyppRepoInfo & changedRepo: _changedRepos )
+    {
+        if ( changedRepo.alias() == repo.alias() )
+            return;
+    }
+
+    _changedRepos.push_back( repo );
+
+    emit repoCacheChanged( repo );
+}
+
+
+void MyrlynRepoManager::backgroundRefreshDone()
+{
+    // A repo that failed to refresh keeps its old cache that is already
+    // loaded, so there is no need to disable it like in refreshRepos().
+
+    for ( const ZyppRepoInfo & repo: _backgroundRefresher->failedRepos() )
+    {
+        logWarning() << "Background refresh failed for repo " << repo.name()
+                     << "; using its old cache" << endl;
+    }
+
+    _backgroundRefresher->deleteLater();
+    _backgroundRefresher = 0;
+
+    delete _backgroundKeyRingCallbacks;
+    _backgroundKeyRingCallbacks = 0;
+
+    logInfo() << "Background repo refresh done" << endl;
+}
+
+
+/**
+ * A status that the user set for a selectable. The selectable is identified
+ * by its kind and name: Reloading a repo replaces its selectables.
+ **/
+struct UserStatus
+{
+    zypp::ResKind kind;
+    std::string   name;
+    ZyppStatus    status;
+};
+
+
+/**
+ * Return the status of all selectables that the user changed.
+ * The statuses that the solver set are not needed; it sets them again.
+ **/
+static std::list<UserStatus> saveUserStatus()
+{
+    std::list<UserStatus> savedStatus;
+
+    const zypp::ResKind kinds[] =
+        {
+            zypp::ResKind::package,
+            zypp::ResKind::pattern,
+            zypp::ResKind::patch
+        };
+
+    for ( const zypp::ResKind & kind: kinds )
+    {
+        for ( ZyppPoolIterator it = zyppPool().byKindBegin( kind );
+              it != zyppPool().byKindEnd( kind );
+              ++it )
+        {
+            ZyppStatus status = (*it)->status();
+
+            switch ( status )
+            {
+                case S_Install:
+                case S_Update:
+                case S_Del:
+                case S_Taboo:
+                case S_Protected:
+                    savedStatus.push_back( { kind, (*it)->name(), status } );
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    return savedStatus;
+}
+
+
+/**
+ * Set the saved status again for each selectable. Add the names of the
+ * selectables where that is not possible to 'lostChanges' if it is non-null.
+ **/
+static void restoreUserStatus( const std::list<UserStatus> & savedStatus,
+                               QStringList *                 lostChanges )
+{
+    int lostCount = 0;
+
+    for ( const UserStatus & saved: savedStatus )
+    {
+        ZyppSel selectable = zypp::ui::Selectable::get( saved.kind, saved.name );
+
+        if ( selectable && selectable->status() == saved.status )
+            continue;
+
+        if ( ! selectable || ! selectable->setStatus( saved.status ) )
+        {
+            logWarning() << "Can't restore status " << saved.status
+                         << " of " << saved.name << endl;
+            ++lostCount;
+
+            if ( lostChanges )
+                *lostChanges << fromUTF8( saved.name );
+        }
+    }
+
+    logInfo() << "Restored the status of "
+              << savedStatus.size() - lostCount << " of "
+              << savedStatus.size() << " changed selectables" << endl;
+}
+
+
+int MyrlynRepoManager::reloadChangedRepos( QStringList * lostChanges )
+{
+    std::list<UserStatus> savedStatus = saveUserStatus();
+    int count = 0;
+
+    for ( const ZyppRepoInfo & repo: _changedRepos )
+    {
+        try
+        {
+            logInfo() << "Reloading repo " << repo.name() << endl;
+
+            // This replaces the repo if it is already in the pool
+            repoManager()->loadFromCache( repo );
+            ++count;
+        }
+        catch ( const zypp::Exception & exception )
+        {
+            logError() << "Reloading repo " << repo.name() << " failed: "
+                       << exception.asString() << endl;
+        }
+    }
+
+    _changedRepos.clear();
+
+    if ( count > 0 )
+    {
+        restoreUserStatus( savedStatus, lostChanges );
+        _searchIndex.build();
+    }
+
+    return count;
+}
+
+
+const PkgSearchIndex & MyrlynRepoManager::searchIndex()
+{
+    if ( ! _searchIndex.isUpToDate() )
+    {
+        logInfo() << "The pool changed; rebuilding the search index" << endl;
+        _searchIndex.build();
+    }
+
+    return _searchIndex;
 }
 
 
@@ -24,11 +24,16 @@
 #include <zypp/RepoManager.h>
 #include <zypp/RepoInfo.h>
 
+#include <QStringList>
+
+#include "PkgSearchIndex.h"
+#include "RepoRefresher.h"  // RepoInfoList
 #include "YQZypp.h"
 
 
+class KeyRingCallbacks;
+
 using RepoManager_Ptr = std::shared_ptr<zypp::RepoManager>;
-typedef std::list<ZyppRepoInfo> RepoInfoList;
 
 
 /**
@@ -68,9 +73,67 @@ public:
 
     /**
      * Attach the active repos and load their resolvables.
+     *
+     * In fast start mode (see isFastStart()), this loads the existing solv
+     * caches of the repos right away and starts refreshing them in the
+     * background as soon as the event loop is running. Repos whose cache
+     * changed in that refresh are collected; repoCacheChanged() is emitted
+     * for each of them.
      **/
     void attachRepos();
 
+    /**
+     * Return 'true' if the repos are refreshed in the background after
+     * loading their existing solv caches.
+     *
+     * This is only done for root with the --fast-start command line option
+     * since non-root users can't refresh repos anyway.
+     **/
+    bool isFastStart() const;
+
+    /**
+     * Return 'true' if refreshing repos in the background is still in
+     * progress.
+     **/
+    bool isRefreshingInBackground() const;
+
+    /**
+     * Cancel the background refresh if it is still in progress and wait
+     * until the repo that is refreshed right now is done, so nothing else
+     * uses libzypp's media and key ring handling any more; e.g. before
+     * committing the package transactions. This runs a local event loop in
+     * the meantime, so the GPG key dialog can still be shown.
+     *
+     * Repos that changed until then can still be reloaded with
+     * reloadChangedRepos().
+     **/
+    void stopBackgroundRefresh();
+
+    /**
+     * Return 'true' if there are repos whose cache changed in the
+     * background refresh and that are not yet reloaded into the pool.
+     **/
+    bool haveChangedRepos() const { return ! _changedRepos.empty(); }
+
+    /**
+     * Reload the repos whose cache changed in the background refresh into
+     * the pool and rebuild the search index. Return the number of reloaded
+     * repos.
+     *
+     * Reloading a repo replaces its resolvables, which would lose the
+     * status that the user set for them (install, update, delete, taboo,
+     * protected). So that status is saved for all selectables before and
+     * set again afterwards. If 'lostChanges' is non-null, the names of the
+     * selectables where that was not possible (e.g. because a package is
+     * no longer in the repo) are returned there.
+     *
+     * The caller has to make sure that nothing else accesses the pool
+     * while this is done, in particular no resolver or search worker
+     * thread. All ZyppSel and ZyppObj pointers to resolvables of those
+     * repos are outdated afterwards.
+     **/
+    int reloadChangedRepos( QStringList * lostChanges = 0 );
+
     /**
      * Return the connection to zypp.
      * The first call will establish the connection.
@@ -93,6 +156,15 @@ public:
      **/
     bool haveFailedRepos() const { return ! _failedRepos.empty(); }
 
+    /**
+     * Return the search index over the package names and summaries.
+     *
+     * This is built when the repos are loaded, and it is rebuilt here if
+     * the pool changed since then, e.g. because the target was reloaded
+     * after a commit.
+     **/
+    const PkgSearchIndex & searchIndex();
+
 
 signals:
 
@@ -116,6 +188,32 @@ signals:
      **/
     void refreshRepoError( const ZyppRepoInfo & repo );
 
+    /**
+     * Emitted in fast start mode when the cache of a repo changed in the
+     * background refresh. Use reloadChangedRepos() to load it into the
+     * pool.
+     **/
+    void repoCacheChanged( const ZyppRepoInfo & repo );
+
+
+protected slots:
+
+    /**
+     * Start refreshing the enabled repos in the background.
+     **/
+    void startBackgroundRefresh();
+
+    /**
+     * Notification that the background refresh changed the cache of a
+     * repo.
+     **/
+    void backgroundRepoChanged( const ZyppRepoInfo & repo );
+
+    /**
+     * Notification that the background refresh is done.
+     **/
+    void backgroundRefreshDone();
+
 
 protected:
 
@@ -150,9 +248,13 @@ protected:
     void refreshRepos();
 
     /**
-     * Load the resolvables from the enabled repos.
+     * Load the resolvables from the enabled repos and build the search
+     * index.
+     *
+     * If 'skipUncached' is 'true', repos that don't have a solv cache yet
+     * are skipped; otherwise that throws a zypp exception.
      **/
-    void loadRepos();
+    void loadRepos( bool skipUncached = false );
 
     /**
      * Notify the user to run 'zypper dup' in a warning pop-up and on stderr.
@@ -175,6 +277,11 @@ protected:
     RepoManager_Ptr _repo_manager_ptr;
     RepoInfoList    _repos;
     RepoInfoList    _failedRepos;
+    RepoInfoList    _changedRepos;
+    PkgSearchIndex  _searchIndex;
+
+    RepoRefresher *    _backgroundRefresher;
+    KeyRingCallbacks * _backgroundKeyRingCallbacks;
 };
 
 #endif // MyrlynRepoManager_h
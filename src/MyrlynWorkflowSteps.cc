@@ -15,13 +15,17 @@
 
 
 #include <QMessageBox>
+#include <QTimer>
 
 #include "Exception.h"
 #include "InitReposPage.h"
 #include "Logger.h"
 #include "MainWindow.h"
 #include "PkgCommitPage.h"
+#include "PkgResolverScheduler.h"
+#include "PoolReaderThread.h"
 #include "QY2CursorHelper.h"
+#include "StartupTimer.h"
 #include "SummaryPage.h"
 #include "YQPkgSelector.h"
 #include "YQi18n.h"
@@ -154,6 +158,7 @@ void InitReposStep::initRepos()
 
     logDebug() << "Initializing zypp..." << endl;
 
+    StartupPhase        phase( "initRepos" );
     MyrlynRepoManager * repoMan = _app->repoManager();
     CHECK_PTR( repoMan );
     busyCursor();
@@ -193,7 +198,13 @@ PkgSelStep::page()
     busyCursor();
 
     // This might take a few seconds
-    QWidget * pg = _app->pkgSel();
+    QWidget * pg = 0;
+
+    {
+        StartupPhase phase( "createPkgSelector" );
+        pg = _app->pkgSel();
+    }
+
     normalCursor();
 
     return pg;
@@ -206,6 +217,12 @@ void PkgSelStep::activate( bool goingForward )
 
     if ( ! goingForward )
         _app->pkgSel()->reset(); // includes resetResolver()
+
+    // Startup is complete when the package selector is visible and the
+    // event loop processes the pending events, so report it from there.
+
+    if ( ! StartupTimer::instance()->isFinished() )
+        QTimer::singleShot( 0, _app, SLOT( startupDone() ) );
 }
 
 
@@ -227,6 +244,18 @@ void PkgCommitStep::activate( bool goingForward )
         MyrlynWorkflowStep::activate( goingForward ); // Show the page
         _app->pkgCommitPage()->reset();  // Reset the widgets on the page
 
+        // The commit needs libzypp's media and key ring handling for itself
+        _app->repoManager()->stopBackgroundRefresh();
+
+        // Nothing else may use the pool while the commit worker thread
+        // changes it: No background resolver run and no search or details
+        // view thread, not even an abandoned one.
+
+        if ( YQPkgSelector::instance() )
+            YQPkgSelector::instance()->resolverScheduler()->waitForIdle();
+
+        PoolReaderBlocker readerBlocker; // Until the commit is done
+
         _app->pkgCommitPage()->commit(); // Do the package transactions
     }
 
@@ -14,11 +14,21 @@
  */
 
 
+#include <QThread>
+
 #include "Logger.h"
 #include "Exception.h"
 #include "PkgCommitCallbacks.h"
 
 
+// Maximum number of events that the worker thread can post before the GUI
+// thread fetches them
+#define EVENT_QUEUE_SIZE                4096
+
+// Time to wait for the GUI thread if the event queue is full
+#define FULL_QUEUE_WAIT_MILLISEC        5
+
+
 PkgCommitCallbacks::PkgCommitCallbacks()
 {
     _pkgDownloadCallback.connect();
@@ -38,14 +48,25 @@ PkgCommitCallbacks::~PkgCommitCallbacks()
 //
 
 
-PkgCommitSignalForwarder * PkgCommitSignalForwarder::_instance = 0;
+PkgCommitEventQueue * PkgCommitEventQueue::_instance = 0;
 
 
-PkgCommitSignalForwarder * PkgCommitSignalForwarder::instance()
+PkgCommitEventQueue::PkgCommitEventQueue()
+    : QObject()
+    , _events( EVENT_QUEUE_SIZE )
+    , _doAbort( 0 )
+    , _replyPending( false )
+    , _reply( AbortReply )
+{
+    // NOP
+}
+
+
+PkgCommitEventQueue * PkgCommitEventQueue::instance()
 {
     if ( ! _instance )
     {
-        _instance = new PkgCommitSignalForwarder();
+        _instance = new PkgCommitEventQueue();
         CHECK_NEW( _instance );
     }
 
@@ -53,66 +74,112 @@ PkgCommitSignalForwarder * PkgCommitSignalForwarder::instance()
 }
 
 
-void PkgCommitSignalForwarder::reset()
+void PkgCommitEventQueue::reset()
 {
-    _doAbort = false;
+    QMutexLocker locker( &_mutex );
+
+    _doAbort.storeRelease( 0 );
+    _replyPending = false;
+    _errorPkgName.clear();
+    _errorMessage.clear();
+    _fileConflicts.clear();
 }
 
 
-void PkgCommitSignalForwarder::connectAll( QObject * receiver )
+void PkgCommitEventQueue::abortCommit()
 {
-    connect( instance(), SIGNAL( pkgDownloadStart    ( ZyppRes ) ),
-             receiver,   SLOT  ( pkgDownloadStart    ( ZyppRes ) ) );
+    QMutexLocker locker( &_mutex );
 
-    connect( instance(), SIGNAL( pkgDownloadProgress ( ZyppRes, int ) ),
-             receiver,   SLOT  ( pkgDownloadProgress ( ZyppRes, int ) ) );
+    _doAbort.storeRelease( 1 );
+    _replyCondition.wakeAll();
+}
 
-    connect( instance(), SIGNAL( pkgDownloadEnd      ( ZyppRes ) ),
-             receiver,   SLOT  ( pkgDownloadEnd      ( ZyppRes ) ) );
 
-    connect( instance(), SIGNAL( pkgCachedNotify     ( ZyppRes ) ),
-             receiver,   SLOT  ( pkgCachedNotify     ( ZyppRes ) ) );
+void PkgCommitEventQueue::post( PkgCommitEvent::Type type,
+                                ZyppRes              zyppRes,
+                                int                  value )
+{
+    PkgCommitEvent event;
+    event.type  = type;
+    event.ident = zyppRes ? zyppRes->ident().id() : 0;
+    event.value = value;
 
-    connect( instance(), SIGNAL( pkgDownloadError    ( ZyppRes, const QString & ) ),
-             receiver,   SLOT  ( pkgDownloadError    ( ZyppRes, const QString & ) ) );
+    while ( ! _events.push( event ) )
+    {
+        // The GUI thread will catch up soon, but if the commit is being
+        // aborted, it might not fetch any more events.
 
+        if ( doAbort() )
+            return;
 
-    connect( instance(), SIGNAL( pkgInstallStart     ( ZyppRes ) ),
-             receiver,   SLOT  ( pkgInstallStart     ( ZyppRes ) ) );
+        QThread::msleep( FULL_QUEUE_WAIT_MILLISEC );
+    }
+}
 
-    connect( instance(), SIGNAL( pkgInstallProgress  ( ZyppRes, int ) ),
-             receiver,   SLOT  ( pkgInstallProgress  ( ZyppRes, int ) ) );
 
-    connect( instance(), SIGNAL( pkgInstallEnd       ( ZyppRes ) ),
-             receiver,   SLOT  ( pkgInstallEnd       ( ZyppRes ) ) );
+ErrorReply PkgCommitEventQueue::askErrorReply( PkgCommitEvent::Type type,
+                                               ZyppRes              zyppRes,
+                                               const std::string &  description )
+{
+    {
+        QMutexLocker locker( &_mutex );
 
-    connect( instance(), SIGNAL( pkgInstallError     ( ZyppRes, const QString & ) ),
-             receiver,   SLOT  ( pkgInstallError     ( ZyppRes, const QString & ) ) );
+        _errorPkgName = fromUTF8( zyppRes->name() );
+        _errorMessage = fromUTF8( description );
+        _reply        = AbortReply;
+        _replyPending = true;
+    }
 
+    post( type, zyppRes );
 
-    connect( instance(), SIGNAL( pkgRemoveStart      ( ZyppRes ) ),
-             receiver,   SLOT  ( pkgRemoveStart      ( ZyppRes ) ) );
+    QMutexLocker locker( &_mutex );
 
-    connect( instance(), SIGNAL( pkgRemoveProgress   ( ZyppRes, int ) ),
-             receiver,   SLOT  ( pkgRemoveProgress   ( ZyppRes, int ) ) );
+    while ( _replyPending && ! doAbort() )
+        _replyCondition.wait( &_mutex );
 
-    connect( instance(), SIGNAL( pkgRemoveEnd        ( ZyppRes ) ),
-             receiver,   SLOT  ( pkgRemoveEnd        ( ZyppRes ) ) );
+    _replyPending = false;
 
-    connect( instance(), SIGNAL( pkgRemoveError      ( ZyppRes, const QString & ) ),
-             receiver,   SLOT  ( pkgRemoveError      ( ZyppRes, const QString & ) ) );
+    return doAbort() ? AbortReply : _reply;
+}
 
 
-    connect( instance(), SIGNAL( fileConflictsCheckStart() ),
-             receiver,   SLOT  ( fileConflictsCheckStart() ) );
+void PkgCommitEventQueue::postFileConflicts( const QStringList & conflicts )
+{
+    {
+        QMutexLocker locker( &_mutex );
+        _fileConflicts = conflicts;
+    }
 
-    connect( instance(), SIGNAL( fileConflictsCheckProgress( int ) ),
-             receiver,   SLOT  ( fileConflictsCheckProgress( int ) ) );
+    post( PkgCommitEvent::FileConflictsCheckResult );
+}
 
-    connect( instance(), SIGNAL( fileConflictsCheckResult( QStringList ) ),
-             receiver,   SLOT  ( fileConflictsCheckResult( QStringList ) ) );
+
+QString PkgCommitEventQueue::errorPkgName() const
+{
+    QMutexLocker locker( &_mutex );
+    return _errorPkgName;
+}
 
 
-    connect( receiver,   SIGNAL( abortCommit() ),
-             this,       SLOT  ( abortCommit() ) );
+QString PkgCommitEventQueue::errorMessage() const
+{
+    QMutexLocker locker( &_mutex );
+    return _errorMessage;
+}
+
+
+void PkgCommitEventQueue::setErrorReply( ErrorReply reply )
+{
+    QMutexLocker locker( &_mutex );
+
+    _reply        = reply;
+    _replyPending = false;
+    _replyCondition.wakeAll();
+}
+
+
+QStringList PkgCommitEventQueue::fileConflicts() const
+{
+    QMutexLocker locker( &_mutex );
+    return _fileConflicts;
 }
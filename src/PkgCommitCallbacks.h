@@ -19,14 +19,19 @@
 
 
 #include <iostream>  // cerr
+#include <QAtomicInt>
+#include <QMutex>
 #include <QObject>
 #include <QStringList>
+#include <QWaitCondition>
 
+#include <zypp/IdString.h>
 #include <zypp/Resolvable.h>
 #include <zypp/Url.h>
 #include <zypp/ZYppCallbacks.h>
 #include <zypp/sat/FileConflicts.h>
 
+#include "SpscRingBuffer.h"
 #include "utf8.h"
 #include "YQZypp.h"     // ZyppRes
 
@@ -45,12 +50,62 @@ enum ErrorReply
 
 
 /**
- * Signal forwarder for the callbacks so they can send Qt signals to a receiver
- * QObject without being subclasses of QObject themselves.
+ * One event from the libzypp commit callbacks for the GUI thread.
+ *
+ * This is intentionally small, and it doesn't refer to anything in the zypp
+ * pool: The GUI thread only uses the package ident as a key to find the
+ * package task; it doesn't access the pool while libzypp is committing in
+ * the worker thread. Error messages and the file conflicts are passed
+ * separately; see PkgCommitEventQueue.
+ **/
+struct PkgCommitEvent
+{
+    enum Type
+    {
+        NoEvent = 0,
+
+        DownloadStart,
+        DownloadProgress,
+        DownloadEnd,
+        CachedNotify,
+        DownloadError,
+
+        InstallStart,
+        InstallProgress,
+        InstallEnd,
+        InstallError,
+
+        RemoveStart,
+        RemoveProgress,
+        RemoveEnd,
+        RemoveError,
+
+        FileConflictsCheckStart,
+        FileConflictsCheckProgress,
+        FileConflictsCheckResult
+    };
+
+    Type                   type  = NoEvent;
+    zypp::IdString::IdType ident = 0;   // Package name
+    int                    value = 0;   // Percent for the ..Progress events
+};
+
+
+/**
+ * Channel between the libzypp commit callbacks in the commit worker thread
+ * and the PkgCommitPage in the GUI thread.
+ *
+ * The callbacks post their events to a lock-free ring buffer; the GUI
+ * thread fetches them with takeEvent() on a timer. If the buffer is full,
+ * the worker thread waits until the GUI thread catches up.
+ *
+ * For a package error, the worker thread posts the error event and then
+ * blocks in askErrorReply() until the GUI thread has asked the user and
+ * sends the answer with setErrorReply(), or until the commit is aborted.
  *
  * This is a singleton class.
  **/
-class PkgCommitSignalForwarder: public QObject
+class PkgCommitEventQueue: public QObject
 {
    Q_OBJECT
 
@@ -59,131 +114,121 @@ protected:
     /**
      * Constructor. Use instance() instead.
      **/
-    PkgCommitSignalForwarder()
-        : QObject()
-        , _doAbort( false )
-        {}
+    PkgCommitEventQueue();
 
 public:
 
     /**
      * Destructor.
      **/
-    virtual ~PkgCommitSignalForwarder() { _instance = 0; }
+    virtual ~PkgCommitEventQueue() { _instance = 0; }
 
     /**
      * Return the singleton of this class. Create it if it doesn't exist yet.
      **/
-    static PkgCommitSignalForwarder * instance();
+    static PkgCommitEventQueue * instance();
 
     /**
-     * Connect all signals to slots with the same name in 'receiver'.
+     * Return 'true' if 'abortCommit()' has been received since the last
+     * 'reset()'.
+     *
+     * This can be called from any thread.
      **/
-    void connectAll( QObject * receiver );
+    bool doAbort() const { return _doAbort.loadAcquire(); }
 
     /**
-     * Return 'true' if 'abortCommit()' has been received since the last
-     * 'reset()'
+     * Reset the internal status, including the abort flag.
      **/
-    bool doAbort() const { return _doAbort; }
+    void reset();
+
+
+    //
+    // Worker thread side
+    //
 
     /**
-     * Return the latest reply to an error.
+     * Post an event of type 'type' for the package of 'zyppRes' (if
+     * non-null) with an optional value. This waits if the buffer is full,
+     * unless the commit is being aborted; then the event is dropped.
      **/
-    ErrorReply reply() const { return _reply; }
+    void post( PkgCommitEvent::Type type,
+               ZyppRes              zyppRes = ZyppRes(),
+               int                  value   = 0 );
 
     /**
-     * Reply to an error.
-     *
-     * Since Qt signals cannot return a value, this kludge is used to achieve a
-     * similar effect: Before the connected slot returns, it should call this
-     * to set a reply (in this case one of Abort / Retry / Ignore).
-     *
-     * Of course, this only works with direct signal / slot connections,
-     * i.e. in the same thread. See also QObject::connect() and
-     * Qt::ConnectionType.
+     * Post an error event of type 'type' for the package of 'zyppRes' and
+     * wait until the GUI thread replies. Return the reply, or AbortReply if
+     * the commit is aborted in the meantime.
      **/
-    void setReply( ErrorReply val ) { _reply = val; }
+    ErrorReply askErrorReply( PkgCommitEvent::Type type,
+                              ZyppRes              zyppRes,
+                              const std::string &  description );
 
     /**
-     * Reset the internal status, including the _doAbort flag.
+     * Post the result of the file conflicts check.
      **/
-    void reset();
+    void postFileConflicts( const QStringList & conflicts );
 
 
-signals:
-
     //
-    // The receiver needs to have a slot with the same name for each of these
-    // signals:
+    // GUI thread side
     //
 
-    void pkgDownloadStart    ( ZyppRes zyppRes );
-    void pkgDownloadProgress ( ZyppRes zyppRes, int value );
-    void pkgDownloadEnd      ( ZyppRes zyppRes );
-
-    void pkgCachedNotify     ( ZyppRes zyppRes );
-    void pkgDownloadError    ( ZyppRes zyppRes, const QString & msg );
+    /**
+     * Take the next event from the queue and store it in 'event'.
+     * Return 'false' if there is none.
+     **/
+    bool takeEvent( PkgCommitEvent & event ) { return _events.pop( event ); }
 
+    /**
+     * Return the package name of the pending error event.
+     **/
+    QString errorPkgName() const;
 
-    void pkgInstallStart     ( ZyppRes zyppRes );
-    void pkgInstallProgress  ( ZyppRes zyppRes, int value );
-    void pkgInstallEnd       ( ZyppRes zyppRes );
-    void pkgInstallError     ( ZyppRes zyppRes, const QString & msg );
+    /**
+     * Return the libzypp message of the pending error event.
+     **/
+    QString errorMessage() const;
 
-    void pkgRemoveStart      ( ZyppRes zyppRes );
-    void pkgRemoveProgress   ( ZyppRes zyppRes, int value );
-    void pkgRemoveEnd        ( ZyppRes zyppRes );
-    void pkgRemoveError      ( ZyppRes zyppRes, const QString & msg );
+    /**
+     * Reply to the pending error event. This wakes up the worker thread.
+     **/
+    void setErrorReply( ErrorReply reply );
 
-    void fileConflictsCheckStart();
-    void fileConflictsCheckProgress( int percent );
-    void fileConflictsCheckResult  ( const QStringList & conflictsList );
+    /**
+     * Return the file conflicts from the last FileConflictsCheckResult
+     * event.
+     **/
+    QStringList fileConflicts() const;
 
 
 public slots:
 
-    void abortCommit() { _doAbort = true; }
-
-
-public:
-
-    // Use each one with  PkgCommitSignalForwarder::instance()->sendPkg...()
-
-    void sendPkgDownloadStart    ( ZyppRes zyppRes )             { emit pkgDownloadStart   ( zyppRes);         }
-    void sendPkgDownloadProgress ( ZyppRes zyppRes, int value )  { emit pkgDownloadProgress( zyppRes, value ); }
-    void sendPkgDownloadEnd      ( ZyppRes zyppRes )             { emit pkgDownloadEnd     ( zyppRes );        }
-
-    void sendPkgCachedNotify     ( ZyppRes zyppRes )             { emit pkgCachedNotify    ( zyppRes );        }
-    void sendPkgDownloadError    ( ZyppRes zyppRes,
-                                   const QString & msg )         { emit pkgDownloadError   ( zyppRes, msg );   }
-
-
-    void sendPkgInstallStart     ( ZyppRes zyppRes )             { emit pkgInstallStart    ( zyppRes);         }
-    void sendPkgInstallProgress  ( ZyppRes zyppRes, int value )  { emit pkgInstallProgress ( zyppRes, value ); }
-    void sendPkgInstallEnd       ( ZyppRes zyppRes )             { emit pkgInstallEnd      ( zyppRes );        }
-    void sendPkgInstallError     ( ZyppRes zyppRes,
-                                   const QString & msg )         { emit pkgInstallError    ( zyppRes, msg );   }
-
-    void sendPkgRemoveStart      ( ZyppRes zyppRes )             { emit pkgRemoveStart     ( zyppRes);         }
-    void sendPkgRemoveProgress   ( ZyppRes zyppRes, int value )  { emit pkgRemoveProgress  ( zyppRes, value ); }
-    void sendPkgRemoveEnd        ( ZyppRes zyppRes )             { emit pkgRemoveEnd       ( zyppRes );        }
-    void sendPkgRemoveError      ( ZyppRes zyppRes,
-                                   const QString & msg )         { emit pkgRemoveError     ( zyppRes, msg );   }
+    /**
+     * Abort the commit: Make the callbacks tell libzypp to abort, and stop
+     * waiting for an error reply.
+     **/
+    void abortCommit();
 
-    void sendFileConflictsCheckStart()                           { emit fileConflictsCheckStart();             }
-    void sendFileConflictsCheckProgress( int percent )           { emit fileConflictsCheckProgress( percent ); }
-    void sendFileConflictsCheckResult( const QStringList & conflicts ) { emit fileConflictsCheckResult( conflicts ); }
 
+protected:
 
     //
     // Data members
     //
 
-    bool       _doAbort;
-    ErrorReply _reply;
+    SpscRingBuffer<PkgCommitEvent> _events;
+    QAtomicInt                     _doAbort;
+
+    mutable QMutex                 _mutex;          // for all below
+    QWaitCondition                 _replyCondition;
+    bool                           _replyPending;
+    ErrorReply                     _reply;
+    QString                        _errorPkgName;
+    QString                        _errorMessage;
+    QStringList                    _fileConflicts;
 
-    static PkgCommitSignalForwarder * _instance;
+    static PkgCommitEventQueue *   _instance;
 };
 
 
@@ -203,15 +248,15 @@ struct PkgDownloadCallback:
 
     virtual void start( ZyppRes zyppRes, const Url & /*url*/ ) override
         {
-            PkgCommitSignalForwarder::instance()->sendPkgDownloadStart( zyppRes );
+            PkgCommitEventQueue::instance()->post( PkgCommitEvent::DownloadStart, zyppRes );
         }
 
 
     virtual bool progress( int value, ZyppRes zyppRes) override
         {
-            PkgCommitSignalForwarder::instance()->sendPkgDownloadProgress( zyppRes, value );
+            PkgCommitEventQueue::instance()->post( PkgCommitEvent::DownloadProgress, zyppRes, value );
 
-            return ! PkgCommitSignalForwarder::instance()->doAbort();
+            return ! PkgCommitEventQueue::instance()->doAbort();
         }
 
 
@@ -219,7 +264,7 @@ struct PkgDownloadCallback:
                          PkgDownloadError    error,
                          const std::string & reason )  override
         {
-            PkgCommitSignalForwarder::instance()->sendPkgDownloadEnd( zyppRes );
+            PkgCommitEventQueue::instance()->post( PkgCommitEvent::DownloadEnd, zyppRes );
         }
 
 
@@ -227,10 +272,11 @@ struct PkgDownloadCallback:
                                        PkgDownloadError    error,
                                        const std::string & description ) override
         {
-            PkgCommitSignalForwarder::instance()->setReply( AbortReply );
-            PkgCommitSignalForwarder::instance()->sendPkgDownloadError( zyppRes, fromUTF8( description ) );
+            ErrorReply reply =
+                PkgCommitEventQueue::instance()->askErrorReply( PkgCommitEvent::DownloadError,
+                                                                zyppRes, description );
 
-            switch ( PkgCommitSignalForwarder::instance()->reply() )
+            switch ( reply )
             {
                 case IgnoreReply: return PkgDownloadAction::IGNORE;
                 case RetryReply:  return PkgDownloadAction::RETRY;
@@ -246,7 +292,7 @@ struct PkgDownloadCallback:
     virtual void infoInCache( ZyppRes zyppRes,
                               const Pathname & /*localfile*/ )  override
         {
-            PkgCommitSignalForwarder::instance()->sendPkgCachedNotify( zyppRes );
+            PkgCommitEventQueue::instance()->post( PkgCommitEvent::CachedNotify, zyppRes );
         }
 
 
@@ -262,7 +308,7 @@ struct PkgDownloadCallback:
 
     virtual bool progressDeltaDownload( int /*value*/ )  override
         {
-            return ! PkgCommitSignalForwarder::instance()->doAbort();
+            return ! PkgCommitEventQueue::instance()->doAbort();
         }
 
     virtual void problemDeltaDownload( const std::string & /*description*/ )  override
@@ -297,15 +343,15 @@ struct PkgInstallCallback:
 {
     virtual void start( ZyppRes zyppRes ) override
         {
-            PkgCommitSignalForwarder::instance()->sendPkgInstallStart( zyppRes );
+            PkgCommitEventQueue::instance()->post( PkgCommitEvent::InstallStart, zyppRes );
         }
 
 
     virtual bool progress( int value, ZyppRes zyppRes ) override
         {
-            PkgCommitSignalForwarder::instance()->sendPkgInstallProgress( zyppRes, value );
+            PkgCommitEventQueue::instance()->post( PkgCommitEvent::InstallProgress, zyppRes, value );
 
-            return ! PkgCommitSignalForwarder::instance()->doAbort();
+            return ! PkgCommitEventQueue::instance()->doAbort();
         }
 
 
@@ -314,7 +360,7 @@ struct PkgInstallCallback:
                          const std::string & /*reason*/,
                          RpmLevel /*level*/ ) override
         {
-            PkgCommitSignalForwarder::instance()->sendPkgInstallEnd( zyppRes );
+            PkgCommitEventQueue::instance()->post( PkgCommitEvent::InstallEnd, zyppRes );
         }
 
 
@@ -323,10 +369,11 @@ struct PkgInstallCallback:
                                       const std::string & description,
                                       RpmLevel /*level*/ )  override
         {
-            PkgCommitSignalForwarder::instance()->setReply( AbortReply );
-            PkgCommitSignalForwarder::instance()->sendPkgInstallError( zyppRes, fromUTF8( description ) );
+            ErrorReply reply =
+                PkgCommitEventQueue::instance()->askErrorReply( PkgCommitEvent::InstallError,
+                                                                zyppRes, description );
 
-            switch ( PkgCommitSignalForwarder::instance()->reply() )
+            switch ( reply )
             {
                 case IgnoreReply: return PkgInstallAction::IGNORE;
                 case RetryReply:  return PkgInstallAction::RETRY;
@@ -347,15 +394,15 @@ struct PkgRemoveCallback:
 {
     virtual void start( ZyppRes zyppRes ) override
         {
-            PkgCommitSignalForwarder::instance()->sendPkgRemoveStart( zyppRes );
+            PkgCommitEventQueue::instance()->post( PkgCommitEvent::RemoveStart, zyppRes );
         }
 
 
     virtual bool progress( int value, ZyppRes zyppRes ) override
         {
-            PkgCommitSignalForwarder::instance()->sendPkgRemoveProgress( zyppRes, value );
+            PkgCommitEventQueue::instance()->post( PkgCommitEvent::RemoveProgress, zyppRes, value );
 
-            return ! PkgCommitSignalForwarder::instance()->doAbort();
+            return ! PkgCommitEventQueue::instance()->doAbort();
         }
 
 
@@ -363,7 +410,7 @@ struct PkgRemoveCallback:
                          PkgRemoveError error,
                          const std::string & /*reason*/ ) override
         {
-            PkgCommitSignalForwarder::instance()->sendPkgRemoveEnd( zyppRes );
+            PkgCommitEventQueue::instance()->post( PkgCommitEvent::RemoveEnd, zyppRes );
         }
 
 
@@ -371,10 +418,11 @@ struct PkgRemoveCallback:
                                      PkgRemoveError error,
                                      const std::string & description ) override
         {
-            PkgCommitSignalForwarder::instance()->setReply( AbortReply );
-            PkgCommitSignalForwarder::instance()->sendPkgRemoveError( zyppRes, fromUTF8( description ) );
+            ErrorReply reply =
+                PkgCommitEventQueue::instance()->askErrorReply( PkgCommitEvent::RemoveError,
+                                                                zyppRes, description );
 
-            switch ( PkgCommitSignalForwarder::instance()->reply() )
+            switch ( reply )
             {
                 case IgnoreReply: return PkgRemoveAction::IGNORE;
                 case RetryReply:  return PkgRemoveAction::RETRY;
@@ -399,9 +447,9 @@ struct FileConflictsCheckCallback:
      **/
     virtual bool start( const zypp::ProgressData & progress ) override
         {
-            PkgCommitSignalForwarder::instance()->sendFileConflictsCheckStart();
+            PkgCommitEventQueue::instance()->post( PkgCommitEvent::FileConflictsCheckStart );
 
-            return ! PkgCommitSignalForwarder::instance()->doAbort();
+            return ! PkgCommitEventQueue::instance()->doAbort();
         }
 
     /**
@@ -423,9 +471,10 @@ struct FileConflictsCheckCallback:
             //   /usr/include/zypp-core/ui/progressdata.h
 
             int percent = progress.reportValue();
-            PkgCommitSignalForwarder::instance()->sendFileConflictsCheckProgress( percent );
+            PkgCommitEventQueue::instance()->post( PkgCommitEvent::FileConflictsCheckProgress,
+                                                  ZyppRes(), percent );
 
-            return ! PkgCommitSignalForwarder::instance()->doAbort();
+            return ! PkgCommitEventQueue::instance()->doAbort();
         }
 
     /**
@@ -462,12 +511,12 @@ struct FileConflictsCheckCallback:
             conflictsList << QString( "File /usr/bin/baz\n   from package\n      baz\n   conflicts with file from package \n      foobar" );
 #endif
 
-            PkgCommitSignalForwarder::instance()->sendFileConflictsCheckResult( conflictsList );
+            PkgCommitEventQueue::instance()->postFileConflicts( conflictsList );
 
             if ( ! conflicts.empty() )
                 return false; // abort
 
-            return ! PkgCommitSignalForwarder::instance()->doAbort();
+            return ! PkgCommitEventQueue::instance()->doAbort();
         }
 
 }; // FileConflictsCheckCallback
@@ -480,7 +529,8 @@ struct FileConflictsCheckCallback:
 
 /**
  * Class to bundle the zypp callbacks needed during a zypp package commit and
- * to translate each libzypp event ("report" in libzypp lingo) into a Qt signal.
+ * to translate each libzypp event ("report" in libzypp lingo) into an event
+ * in the PkgCommitEventQueue.
  *
  * The constructor instantiates and connects the callbacks, the destructor
  * disconnects and deletes them; so the instance of this object needs to live
@@ -494,8 +544,7 @@ public:
      * Constructor: Create the needed callbacks and connect them (register them
      * with libzypp).
      *
-     * Remember to call PkgCommitSignalForwarder::connectAll( receiver )
-     * once to get the signals that the callbacks send via the signal forwarder.
+     * libzypp calls the callbacks in the thread that does the commit.
      **/
     PkgCommitCallbacks();
 
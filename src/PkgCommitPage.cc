@@ -16,8 +16,7 @@
 
 #include <unistd.h>             // usleep()
 
-#include <zypp/target/TargetException.h>
-
+#include <QEventLoop>
 #include <QSettings>
 #include <QTimer>
 #include <QMessageBox>
@@ -33,12 +32,19 @@
 #include "YQi18n.h"
 #include "utf8.h"
 #include "PkgCommitCallbacks.h"
+#include "PkgCommitWorker.h"
 #include "PkgCommitPage.h"
 
 #define VERBOSE_PROGRESS        0
 #define VERBOSE_TRANSACT        1
 #define SORT_TO_DO_LIST         1
 
+// Default for how often per second the events from the commit worker thread
+// are processed, i.e. how often the lists and the progress bar are updated:
+// 30 frames per second are plenty for progress bars and lists.
+#define DEFAULT_MAX_UPDATES_PER_SEC     30
+#define MAX_UPDATES_PER_SEC_LIMIT       100
+
 
 PkgCommitPage * PkgCommitPage::_instance = 0;
 
@@ -50,6 +56,9 @@ PkgCommitPage::PkgCommitPage( QWidget * parent )
     , _showDetails( false )
     , _startedInstallingPkg( false )
     , _fileConflictsProgressDialog( 0 )
+    , _commitEventsTimer( 0 )
+    , _processingCommitEvents( false )
+    , _maxUpdatesPerSec( DEFAULT_MAX_UPDATES_PER_SEC )
 {
     CHECK_PTR( _ui );
     _ui->setupUi( this ); // Actually create the widgets from the .ui form
@@ -69,7 +78,16 @@ PkgCommitPage::PkgCommitPage( QWidget * parent )
     loadIcons();
     reset();
     connectWidgets();
-    PkgCommitSignalForwarder::instance()->connectAll( this );
+
+    _commitEventsTimer = new QTimer( this );
+    CHECK_NEW( _commitEventsTimer );
+    _commitEventsTimer->setInterval( 1000 / _maxUpdatesPerSec );
+
+    connect( _commitEventsTimer, SIGNAL( timeout()             ),
+             this,               SLOT  ( processCommitEvents() ) );
+
+    connect( this,                           SIGNAL( abortCommit() ),
+             PkgCommitEventQueue::instance(), SLOT  ( abortCommit() ) );
 
     _instance = this;
 }
@@ -79,7 +97,6 @@ PkgCommitPage::~PkgCommitPage()
 {
     writeSettings();
     delete _ui;
-    // PkgCommitSignalForwarder::instance()->deleteLater();
 
     // No need to delete _fileConflictsProgressDialog:
     // It has the main window as its parent.
@@ -101,10 +118,10 @@ void PkgCommitPage::connectWidgets()
 void PkgCommitPage::commit()
 {
     populateLists();
-    initProgressData();
+    _progress.init( pkgTasks()->todo() );
     _startedInstallingPkg = false;
     _ui->totalProgressBar->setValue( 0 );
-    PkgCommitSignalForwarder::instance()->reset();
+    PkgCommitEventQueue::instance()->reset();
 
     if ( MyrlynApp::isOptionSet( OptFakeCommit ) )
         fakeCommit();
@@ -177,7 +194,7 @@ void PkgCommitPage::fakeCommit()
 
     for ( int i=1; i <= 100; ++i )
     {
-        if ( PkgCommitSignalForwarder::instance()->doAbort() )
+        if ( PkgCommitEventQueue::instance()->doAbort() )
             return;
 
         if ( i == 20 && item )
@@ -200,24 +217,40 @@ void PkgCommitPage::realCommit()
 {
     processEvents();
 
-    // Create and install the callbacks.
-    // They are uninstalled when the 'callbacks' variable goes out of scope.
-    PkgCommitCallbacks callbacks;
-    PkgCommitSignalForwarder::instance()->reset();
+    PkgCommitEventQueue::instance()->reset();
+    PkgCommitWorker worker( commitPolicy() );
 
-    try
-    {
-        logInfo() << "Starting package transactions" << endl;
+    // Keep the event loop running until the worker thread is finished.
+    // It may also be left earlier if the application is quitting.
 
-        zypp::getZYpp()->commit( commitPolicy() );
+    QEventLoop eventLoop;
 
-        logInfo() << "Package transactions done" << endl;
-    }
-    catch ( const zypp::target::TargetAbortedException & ex )
+    connect( &worker,    SIGNAL( finished() ),
+             &eventLoop, SLOT  ( quit()     ) );
+
+    worker.start();
+    _commitEventsTimer->start();
+    eventLoop.exec();
+
+    if ( ! worker.isFinished() )
     {
-        logInfo() << "libzypp aborted as requested" << endl;
+        logInfo() << "Waiting for libzypp to finish" << endl;
+
+        PkgCommitEventQueue::instance()->abortCommit();
+        worker.wait();
     }
 
+    _commitEventsTimer->stop();
+    processCommitEvents(); // Process the last events
+
+    if ( ! worker.errorMessage().isEmpty() )
+    {
+        QString msg = _( "Error during the package transactions:\n\n%1" );
+
+        QMessageBox::warning( MainWindow::instance(), // parent
+                              _( "Error" ),           // window title
+                              msg.arg( worker.errorMessage() ) );
+    }
 }
 
 
@@ -355,6 +388,10 @@ void PkgCommitPage::readSettings()
 
     _showDetails         = settings.value( "showDetails",  true ).toBool();
     bool showSummaryPage = settings.value( "showSummaryPage", true ).toBool();
+    _maxUpdatesPerSec    = settings.value( "maxUpdatesPerSecond",
+                                           DEFAULT_MAX_UPDATES_PER_SEC ).toInt();
+
+    _maxUpdatesPerSec = qBound( 1, _maxUpdatesPerSec, MAX_UPDATES_PER_SEC_LIMIT );
 
     settings.endGroup();
 
@@ -369,6 +406,7 @@ void PkgCommitPage::writeSettings()
 
     settings.setValue( "showDetails",    _showDetails );
     settings.setValue( "showSummaryPage", showSummaryPage() );
+    settings.setValue( "maxUpdatesPerSecond", _maxUpdatesPerSec );
 
     settings.endGroup();
 }
@@ -381,143 +419,11 @@ void PkgCommitPage::processEvents()
 }
 
 
-void PkgCommitPage::initProgressData()
-{
-    _totalDownloadSize      = 0;
-    _totalInstalledSize     = 0;
-    _totalTasksCount        = pkgTasks()->todo().size();
-
-    _completedDownloadSize  = 0;
-    _completedInstalledSize = 0;
-    _completedTasksCount    = 0;
-
-    const PkgTaskList & tasks = pkgTasks()->todo();
-
-    for ( const PkgTask * task: tasks )
-    {
-        if ( ( task->action() & PkgAdd ) && task->downloadSize() > 0 )
-            _totalDownloadSize += task->downloadSize();
-
-        if ( task->installedSize() > 0 )
-            _totalInstalledSize += task->installedSize();
-    }
-
-    logDebug() << "total download size:  " << _totalDownloadSize.asString()  << endl;
-    logDebug() << "total installed size: " << _totalInstalledSize.asString() << endl;
-    logDebug() << "total tasks: "          << _totalTasksCount << endl;
-
-    // Weights for different sub-tasks of downloading and installing packages:
-    // There is a constant cost for doing anything with a package, no matter if
-    // it's installing or removing it: The 'handling' of the package.
-    //
-    // Of course a large part of the cost is the download, and another is the
-    // cost of actually installing or removing it, be it unpacking an RPM (for
-    // installing a package) or removing it (removing every item of its file
-    // list).
-
-    _pkgDownloadWeight  = 0.60;
-    _pkgActionWeight    = 0.30;
-    _pkgFixedCostWeight = 0.10;
-
-    logDebug() << "pkgDownloadWeight:  " << _pkgDownloadWeight  << endl;
-    logDebug() << "pkgActionWeight:    " << _pkgActionWeight    << endl;
-    logDebug() << "pkgFixedCostWeight: " << _pkgFixedCostWeight << endl;
-}
-
-
-int PkgCommitPage::currentProgressPercent()
-{
-    float downloadPercent  = 0.0;
-    float installedPercent = 0.0;
-    float tasksPercent     = 0.0;
-    float percent          = 0.0;
-
-    //
-    // Download %
-    //
-
-    if ( _totalDownloadSize > 0 )
-    {
-        ByteCount downloadSize = _completedDownloadSize
-            + pkgTasks()->downloads().downloadSizeSum();
-
-        percent = ( 100.0 * downloadSize ) / _totalDownloadSize;
-    }
-    else // no download needed?
-    {
-        percent = 100.0; // download is 100% completed
-    }
-
-    downloadPercent = percent * _pkgDownloadWeight;
-
-#if VERBOSE_PROGRESS
-
-    logVerbose() << "Download  %: "  << downloadPercent
-                 << "  weight: "     << _pkgDownloadWeight
-                 << "  raw %: "      << percent
-                 << endl;
-#endif
-
-    //
-    // Installed / removed size %
-    //
-
-    if ( _totalInstalledSize > 0 )  // Prevent division by zero
-    {
-        ByteCount installedSize = _completedInstalledSize
-            + pkgTasks()->doing().installedSizeSum();
-
-        percent          = ( 100.0 * installedSize ) / _totalInstalledSize;
-        installedPercent = percent * _pkgActionWeight;
-
-#if VERBOSE_PROGRESS
-
-        logVerbose() << "Installed %: " << installedPercent
-                     << "  weight: "    << _pkgActionWeight
-                     << "  raw %: "     << percent
-                     << endl;
-#endif
-    }
-
-
-    //
-    // Number of tasks %
-    //
-
-    if ( _totalTasksCount > 0 )  // Prevent division by zero
-    {
-        percent      = ( 100.0 * _completedTasksCount ) / _totalTasksCount;
-        tasksPercent = percent * _pkgFixedCostWeight;
-
-#if VERBOSE_PROGRESS
-
-        logVerbose() << "Tasks     %: " << tasksPercent
-                     << "  weight: "    << _pkgFixedCostWeight
-                     << "  raw %: "     << percent
-                     << endl;
-#endif
-    }
-
-
-    //
-    // Total progress
-    //
-
-    float progress   = tasksPercent + downloadPercent + installedPercent;
-
-#if VERBOSE_PROGRESS
-    logVerbose() << "Progress: " << progress << "%" << endl;
-#endif
-
-    return qBound( 0, (int) ( progress + 0.5 ), 100 );
-}
-
-
 bool PkgCommitPage::updateTotalProgressBar()
 {
     bool didUpdate   = false;
     int  oldProgress = _ui->totalProgressBar->value();
-    int  progress    = currentProgressPercent();
+    int  progress    = _progress.percent();
 
     if ( progress >= 0 && progress > oldProgress )
     {
@@ -566,20 +472,151 @@ void PkgCommitPage::closeFileConflictsProgressDialog()
 }
 
 
+void PkgCommitPage::beginListsBatch()
+{
+    _ui->todoList->beginBatch();
+    _ui->downloadsList->beginBatch();
+    _ui->doingList->beginBatch();
+    _ui->doneList->beginBatch();
+}
+
+
+void PkgCommitPage::endListsBatch()
+{
+    _ui->todoList->endBatch();
+    _ui->downloadsList->endBatch();
+    _ui->doingList->endBatch();
+    _ui->doneList->endBatch();
+}
+
+
+//----------------------------------------------------------------------
+
+
+void PkgCommitPage::processCommitEvents()
+{
+    // Showing an error pop-up or the file conflicts starts a nested event
+    // loop where this timer slot might be called again.
+
+    if ( _processingCommitEvents )
+        return;
+
+    _processingCommitEvents = true;
+
+    PkgCommitEventQueue * queue = PkgCommitEventQueue::instance();
+    PkgCommitEvent        event;
+    int                   count = 0;
+
+    beginListsBatch();
+
+    while ( queue->takeEvent( event ) )
+    {
+        // Error pop-ups and the file conflicts result are shown on top of
+        // the lists, so they should be up to date and not frozen there.
+
+        bool showsPopup = event.type == PkgCommitEvent::DownloadError ||
+                          event.type == PkgCommitEvent::InstallError  ||
+                          event.type == PkgCommitEvent::RemoveError   ||
+                          event.type == PkgCommitEvent::FileConflictsCheckResult;
+
+        if ( showsPopup )
+            endListsBatch();
+
+        processCommitEvent( event );
+        ++count;
+
+        if ( showsPopup )
+            beginListsBatch();
+    }
+
+    endListsBatch();
+
+    if ( count > 0 )
+    {
+        updateListHeaders();
+        updateTotalProgressBar();
+    }
+
+    _processingCommitEvents = false;
+}
+
+
+void PkgCommitPage::processCommitEvent( const PkgCommitEvent & event )
+{
+    PkgCommitEventQueue * queue = PkgCommitEventQueue::instance();
+    zypp::IdString        ident( event.ident );
+    ErrorReply            reply = AbortReply;
+
+    switch ( event.type )
+    {
+        case PkgCommitEvent::DownloadStart:     pkgDownloadStart   ( ident );              break;
+        case PkgCommitEvent::DownloadProgress:  pkgDownloadProgress( ident, event.value ); break;
+        case PkgCommitEvent::DownloadEnd:       pkgDownloadEnd     ( ident );              break;
+        case PkgCommitEvent::CachedNotify:      pkgCachedNotify    ( ident );              break;
+
+        case PkgCommitEvent::InstallStart:      pkgInstallStart    ( ident );              break;
+        case PkgCommitEvent::InstallProgress:   pkgInstallProgress ( ident, event.value ); break;
+        case PkgCommitEvent::InstallEnd:        pkgInstallEnd      ( ident );              break;
+
+        case PkgCommitEvent::RemoveStart:       pkgRemoveStart     ( ident );              break;
+        case PkgCommitEvent::RemoveProgress:    pkgRemoveProgress  ( ident, event.value ); break;
+        case PkgCommitEvent::RemoveEnd:         pkgRemoveEnd       ( ident );              break;
+
+        case PkgCommitEvent::DownloadError:
+            reply = pkgActionError( ident, queue->errorPkgName(), queue->errorMessage(),
+                                    _( "Error downloading package %1" ),
+                                    "pkgDownloadError" );
+            queue->setErrorReply( reply );
+            break;
+
+        case PkgCommitEvent::InstallError:
+            reply = pkgActionError( ident, queue->errorPkgName(), queue->errorMessage(),
+                                    _( "Error installing package %1" ),
+                                    "pkgInstallError" );
+            queue->setErrorReply( reply );
+            break;
+
+        case PkgCommitEvent::RemoveError:
+            reply = pkgActionError( ident, queue->errorPkgName(), queue->errorMessage(),
+                                    _( "Error installing package %1" ),
+                                    "pkgRemoveError" );
+            queue->setErrorReply( reply );
+            break;
+
+        case PkgCommitEvent::FileConflictsCheckStart:
+            fileConflictsCheckStart();
+            break;
+
+        case PkgCommitEvent::FileConflictsCheckProgress:
+            fileConflictsCheckProgress( event.value );
+            break;
+
+        case PkgCommitEvent::FileConflictsCheckResult:
+            fileConflictsCheckResult( queue->fileConflicts() );
+            break;
+
+        case PkgCommitEvent::NoEvent:
+            break;
+
+        // Intentionally omitting 'default' branch so the compiler can
+        // catch unhandled enum states
+    }
+}
+
+
 //----------------------------------------------------------------------
 
 //
-// PkgCommitCallback slots
+// Handlers for the events from the libzypp callbacks
 //
 
-void PkgCommitPage::pkgDownloadStart( ZyppRes zyppRes )
+void PkgCommitPage::pkgDownloadStart( zypp::IdString ident )
 {
-    CHECK_PTR( zyppRes );
-    PkgTask * task = pkgTasks()->todo().find( zyppRes );
+    PkgTask * task = pkgTasks()->todo().find( ident );
 
     if ( ! task )
     {
-        logError() << "Can't find task for " << zyppRes << " in todo" << endl;
+        logError() << "Can't find task for package #" << ident.id() << " in todo" << endl;
         return;
     }
 
@@ -590,20 +627,17 @@ void PkgCommitPage::pkgDownloadStart( ZyppRes zyppRes )
     // Move the task from the todo list to the downloads list
 
     PkgTasks::moveTask( task, pkgTasks()->todo(), pkgTasks()->downloads() );
-    task->setDownloadedPercent( 0 ); // Just to make sure
+    _progress.setDownloadedPercent( task, 0 ); // Just to make sure
 
     // Move the task from the todo list widget to the downloads list widget
 
     _ui->todoList->removeTaskItem( task );
     PkgTaskListWidgetItem * item = _ui->downloadsList->addTaskItem( task );
     item->setIcon( _downloadOngoingIcon );
-    updateListHeaders();
-
-    processEvents(); // Update the UI
 }
 
 
-void PkgCommitPage::pkgDownloadProgress( ZyppRes zyppRes, int percent )
+void PkgCommitPage::pkgDownloadProgress( zypp::IdString ident, int percent )
 {
     // Avoid unnecessary expensive progress updates:
     //
@@ -613,12 +647,11 @@ void PkgCommitPage::pkgDownloadProgress( ZyppRes zyppRes, int percent )
     if ( percent < 1 || percent > 99 )
         return;
 
-    CHECK_PTR( zyppRes );
-    PkgTask * task = pkgTasks()->downloads().find( zyppRes );
+    PkgTask * task = pkgTasks()->downloads().find( ident );
 
     if ( ! task )
     {
-        logError() << "Can't find task for " << zyppRes << " in downloads" << endl;
+        logError() << "Can't find task for package #" << ident.id() << " in downloads" << endl;
         return;
     }
 
@@ -626,26 +659,19 @@ void PkgCommitPage::pkgDownloadProgress( ZyppRes zyppRes, int percent )
     logVerbose() << task << ": downloaded " << percent << "%" << endl;
 #endif
 
-    if ( percent != task->downloadedPercent() ) // only if there really was a change
-    {
-        task->setDownloadedPercent( percent );
-
-        // Update the UI
+    // The total progress bar is updated after processing all pending events
 
-        if ( updateTotalProgressBar() ) // This is somewhat expensive
-            processEvents();
-    }
+    _progress.setDownloadedPercent( task, percent );
 }
 
 
-void PkgCommitPage::pkgDownloadEnd( ZyppRes zyppRes )
+void PkgCommitPage::pkgDownloadEnd( zypp::IdString ident )
 {
-    CHECK_PTR( zyppRes );
-    PkgTask * task = pkgTasks()->downloads().find( zyppRes );
+    PkgTask * task = pkgTasks()->downloads().find( ident );
 
     if ( ! task )
     {
-        logError() << "Can't find task for " << zyppRes << " in downloads" << endl;
+        logError() << "Can't find task for package #" << ident.id() << " in downloads" << endl;
         return;
     }
 
@@ -653,29 +679,24 @@ void PkgCommitPage::pkgDownloadEnd( ZyppRes zyppRes )
     logVerbose() << task << endl;
 #endif
 
-    task->setDownloadedPercent( 100 );
+    _progress.setDownloadedPercent( task, 100 );
     PkgTaskListWidgetItem * item = _ui->downloadsList->findTaskItem( task );
 
     if ( item )
-    {
         item->setIcon( _downloadDoneIcon );
-        processEvents();
-    }
 
-    // Important: Not adding the download size to _completedDownloadSize just
-    // yet, or it would be counted twice while the task is still in the doing
-    // list. That has to wait until it is moved to the doing list.
+    // The download only counts as completed when the task is moved to the
+    // doing list; until then, its downloaded percent is counted.
 }
 
 
-void PkgCommitPage::pkgCachedNotify( ZyppRes zyppRes )
+void PkgCommitPage::pkgCachedNotify( zypp::IdString ident )
 {
-    CHECK_PTR( zyppRes );
-    PkgTask * task = pkgTasks()->todo().find( zyppRes );
+    PkgTask * task = pkgTasks()->todo().find( ident );
 
     if ( ! task )
     {
-        logError() << "Can't find task for " << zyppRes << " in todo" << endl;
+        logError() << "Can't find task for package #" << ident.id() << " in todo" << endl;
         return;
     }
 
@@ -686,36 +707,23 @@ void PkgCommitPage::pkgCachedNotify( ZyppRes zyppRes )
     // Move the task from the todo list to the downloads list
 
     PkgTasks::moveTask( task, pkgTasks()->todo(), pkgTasks()->downloads() );
-    task->setDownloadedPercent( 100 );
+    _progress.setDownloadedPercent( task, 100 );
 
     // Move the task from the todo list widget to the downloads list widget
 
     _ui->todoList->removeTaskItem( task );
     PkgTaskListWidgetItem * item = _ui->downloadsList->addTaskItem( task );
     item->setIcon( _downloadDoneIcon );
-    updateListHeaders();
-
-    processEvents(); // Update the UI
 
-
-    // Important: Not adding the download size to _completedDownloadSize just
-    // yet, or it would be counted twice while the task is still in the doing
-    // list. That has to wait until it is moved to the doing list.
-}
-
-
-void PkgCommitPage::pkgDownloadError( ZyppRes zyppRes, const QString & errorMsg )
-{
-    pkgActionError( zyppRes, errorMsg,
-                    _( "Error downloading package %1" ),
-                    __FUNCTION__ );
+    // The download only counts as completed when the task is moved to the
+    // doing list; until then, its downloaded percent is counted.
 }
 
 
 //----------------------------------------------------------------------
 
 
-void PkgCommitPage::pkgInstallStart( ZyppRes zyppRes )
+void PkgCommitPage::pkgInstallStart( zypp::IdString ident )
 {
     // While packages are being downloaded, the list always scrolls to the
     // bottom, so the list appears to scroll like a text terminal as new output
@@ -736,67 +744,50 @@ void PkgCommitPage::pkgInstallStart( ZyppRes zyppRes )
         _ui->downloadsList->scrollToTop();
     }
 
-    pkgActionStart( zyppRes, PkgInstall, __FUNCTION__ );
+    pkgActionStart( ident, PkgInstall, __FUNCTION__ );
 }
 
 
-void PkgCommitPage::pkgInstallProgress( ZyppRes zyppRes, int percent )
+void PkgCommitPage::pkgInstallProgress( zypp::IdString ident, int percent )
 {
-    pkgActionProgress( zyppRes, percent, PkgInstall, __FUNCTION__ );
+    pkgActionProgress( ident, percent, PkgInstall, __FUNCTION__ );
 }
 
 
-void PkgCommitPage::pkgInstallEnd( ZyppRes zyppRes )
+void PkgCommitPage::pkgInstallEnd( zypp::IdString ident )
 {
-    pkgActionEnd( zyppRes, PkgInstall, __FUNCTION__ );
-}
-
-
-void PkgCommitPage::pkgInstallError( ZyppRes zyppRes, const QString & errorMsg )
-{
-    pkgActionError( zyppRes, errorMsg,
-                    _( "Error installing package %1" ),
-                    __FUNCTION__ );
+    pkgActionEnd( ident, PkgInstall, __FUNCTION__ );
 }
 
 
 //----------------------------------------------------------------------
 
 
-void PkgCommitPage::pkgRemoveStart( ZyppRes zyppRes )
-{
-    pkgActionStart( zyppRes, PkgRemove, __FUNCTION__ );
-}
-
-
-void PkgCommitPage::pkgRemoveProgress( ZyppRes zyppRes, int percent )
+void PkgCommitPage::pkgRemoveStart( zypp::IdString ident )
 {
-    pkgActionProgress( zyppRes, percent, PkgRemove, __FUNCTION__ );
+    pkgActionStart( ident, PkgRemove, __FUNCTION__ );
 }
 
 
-void PkgCommitPage::pkgRemoveEnd( ZyppRes zyppRes )
+void PkgCommitPage::pkgRemoveProgress( zypp::IdString ident, int percent )
 {
-    pkgActionEnd( zyppRes, PkgRemove, __FUNCTION__ );
+    pkgActionProgress( ident, percent, PkgRemove, __FUNCTION__ );
 }
 
 
-void PkgCommitPage::pkgRemoveError( ZyppRes zyppRes, const QString & errorMsg )
+void PkgCommitPage::pkgRemoveEnd( zypp::IdString ident )
 {
-    pkgActionError( zyppRes, errorMsg,
-                    _( "Error installing package %1" ),
-                    __FUNCTION__ );
+    pkgActionEnd( ident, PkgRemove, __FUNCTION__ );
 }
 
 
 //----------------------------------------------------------------------
 
 
-void PkgCommitPage::pkgActionStart( ZyppRes       zyppRes,
-                                    PkgTaskAction action,
-                                    const char *  caller )
+void PkgCommitPage::pkgActionStart( zypp::IdString ident,
+                                    PkgTaskAction  action,
+                                    const char *   caller )
 {
-    CHECK_PTR( zyppRes );
     PkgTask * task = 0;
 
     // If we are already starting installing or removing packages,
@@ -807,7 +798,7 @@ void PkgCommitPage::pkgActionStart( ZyppRes       zyppRes,
 
     if ( action & PkgAdd ) // PkgInstall | PkgUpdate
     {
-        task = pkgTasks()->downloads().find( zyppRes );
+        task = pkgTasks()->downloads().find( ident );
 
         if ( task )
         {
@@ -818,24 +809,22 @@ void PkgCommitPage::pkgActionStart( ZyppRes       zyppRes,
 
             _ui->downloadsList->removeTaskItem( task );
             _ui->doingList->addTaskItem( task );
-            updateListHeaders();
 
             // Update the bookkeeping sums.
             // We already know that the task was in the downloads list.
 
-            if ( task->downloadSize() > 0 )
-                _completedDownloadSize += task->downloadSize();
+            _progress.leaveDownloads( task, true );
         }
     }
 
     if ( ! task ) // PkgRemove or no download needed
     {
-        task = pkgTasks()->todo().find( zyppRes );
+        task = pkgTasks()->todo().find( ident );
 
         if ( ! task )
         {
             logError() << caller << "(): "
-                       << "Can't find task for " << zyppRes
+                       << "Can't find task for package #" << ident.id()
                        << " in either downloads or todo" << endl;
             return;
         }
@@ -847,30 +836,21 @@ void PkgCommitPage::pkgActionStart( ZyppRes       zyppRes,
 
         _ui->todoList->removeTaskItem( task );
         _ui->doingList->addTaskItem( task );
-        updateListHeaders();
     }
 
 #if VERBOSE_TRANSACT
     logVerbose() << task << endl;
 #endif
 
-    task->setDownloadedPercent( 100 ); // The download is complete for sure
-    task->setCompletedPercent( 0 );    // But the task itself isn't completed
-    processEvents(); // Update the UI
-
-    // No
-    //
-    //  _completedDownloadSize += task->downloadSize()
-    //
-    // here while the task is in the doing list, otherwise it would be
-    // summed up twice!
+    task->setDownloadedPercent( 100 );        // The download is complete for sure
+    _progress.setCompletedPercent( task, 0 ); // But the task itself isn't completed
 }
 
 
-void PkgCommitPage::pkgActionProgress( ZyppRes       zyppRes,
-                                       int           percent,
-                                       PkgTaskAction action,
-                                       const char *  caller )
+void PkgCommitPage::pkgActionProgress( zypp::IdString ident,
+                                       int            percent,
+                                       PkgTaskAction  action,
+                                       const char *   caller )
 {
     Q_UNUSED( action );
 
@@ -890,14 +870,13 @@ void PkgCommitPage::pkgActionProgress( ZyppRes       zyppRes,
     if ( percent % 5 != 0 || percent <= 0 || percent >= 100 )
         return;
 
-    CHECK_PTR( zyppRes );
-    PkgTask * task = pkgTasks()->doing().find( zyppRes );
+    PkgTask * task = pkgTasks()->doing().find( ident );
 
     if ( ! task )
     {
         logError() << caller << "(): "
-                   << "Can't find task for "
-                   << zyppRes << " in doing" << endl;
+                   << "Can't find task for package #" << ident.id()
+                   << " in doing" << endl;
         return;
     }
 
@@ -905,33 +884,25 @@ void PkgCommitPage::pkgActionProgress( ZyppRes       zyppRes,
     logVerbose() << task << ": " << percent << "%" << endl;
 #endif
 
-    if ( percent != task->completedPercent() )
-    {
-        task->setCompletedPercent( percent );
-
-        // Update the UI
+    // The total progress bar is updated after processing all pending events
 
-        if ( updateTotalProgressBar() ) // This is somewhat expensive
-            processEvents();
-    }
+    _progress.setCompletedPercent( task, percent );
 }
 
 
-void PkgCommitPage::pkgActionEnd( ZyppRes       zyppRes,
-                                  PkgTaskAction action,
-                                  const char *  caller )
+void PkgCommitPage::pkgActionEnd( zypp::IdString ident,
+                                  PkgTaskAction  action,
+                                  const char *   caller )
 {
-    CHECK_PTR( zyppRes );
-
     // Make sure the file conflicts dialog is closed now
     closeFileConflictsProgressDialog();
 
-    PkgTask * task = pkgTasks()->doing().find( zyppRes );
+    PkgTask * task = pkgTasks()->doing().find( ident );
 
     if ( ! task )
     {
         logError() << caller << "(): "
-                   << "Can't find task for " << zyppRes
+                   << "Can't find task for package #" << ident.id()
                    << " in doing" << endl;
         return;
     }
@@ -944,6 +915,7 @@ void PkgCommitPage::pkgActionEnd( ZyppRes       zyppRes,
     // Move the task from the doing list to the done list
 
     PkgTasks::moveTask( task, pkgTasks()->doing(), pkgTasks()->done() );
+    _progress.leaveDoing( task, true );
     task->setDownloadedPercent( 100 );
     task->setCompletedPercent( 100 ); // Just to make sure
 
@@ -952,18 +924,6 @@ void PkgCommitPage::pkgActionEnd( ZyppRes       zyppRes,
 
     _ui->doingList->removeTaskItem( task );
     _ui->doneList->addTaskItem( task );
-    updateListHeaders();
-
-
-    // Update the internal bookkeeping sums
-
-    ++_completedTasksCount;
-
-    if ( task->installedSize() > 0 )
-        _completedInstalledSize += task->installedSize();
-
-    // The task's download size has already be added to _completeDownloadSize
-    // when the task was moved from the downloads list to the doing list.
 
 
     // Was this the last task?
@@ -975,28 +935,21 @@ void PkgCommitPage::pkgActionEnd( ZyppRes       zyppRes,
         QString msg = _( "[Post-transaction scripts]" );
         _ui->doingList->addItem( new QListWidgetItem( msg ) );
     }
-
-
-    // Update the UI
-
-    updateTotalProgressBar(); // This may or may not be needed
-    processEvents();          // But this is needed for sure
 }
 
 
-void PkgCommitPage::pkgActionError( ZyppRes         zyppRes,
-                                    const QString & zyppErrorMsg,
-                                    const QString & msgHeader,
-                                    const char *    caller     )
+ErrorReply PkgCommitPage::pkgActionError( zypp::IdString  ident,
+                                          const QString & pkgName,
+                                          const QString & zyppErrorMsg,
+                                          const QString & msgHeader,
+                                          const char *    caller     )
 {
-    CHECK_PTR( zyppRes );
-
-    logError() << caller << "(): " << zyppRes << ": " << zyppErrorMsg << endl;
+    logError() << caller << "(): " << pkgName << ": " << zyppErrorMsg << endl;
 
     QString msg;
 
     if ( msgHeader.contains( "%1" ) )
-        msg = msgHeader.arg( fromUTF8( zyppRes->name() ) );
+        msg = msgHeader.arg( pkgName );
 
     msg = QString( "<b>%1</b>\n\n" ).arg( msg );
 
@@ -1018,31 +971,24 @@ void PkgCommitPage::pkgActionError( ZyppRes         zyppRes,
         case QMessageBox::Ignore: reply = IgnoreReply; break;
     }
 
-    // Using the PkgCommitSignalForwarder::setReply() kludge since we can't
-    // simply return a value from a Qt slot. But this only works with direct Qt
-    // signal / slot connections: When the signal is emitted, the connected
-    // slots are called immediately one after the other, and control flow only
-    // returns to the emitter when the last one returns.
-    //
-    // That makes it safe to open the pop-up warning dialog and wait until the
-    // user clicks on an answer button, and to set the reply before we return
-    // here. None of this would work with multiple Qt threads.
-
-    PkgCommitSignalForwarder::instance()->setReply( reply );
-
-
     if ( reply != RetryReply )
     {
-        PkgTask * task = pkgTasks()->downloads().find( zyppRes );
+        PkgTask * task = pkgTasks()->downloads().find( ident );
 
         if ( task )
+        {
             PkgTasks::moveTask( task, pkgTasks()->downloads(), pkgTasks()->failed() );
+            _progress.leaveDownloads( task, false );
+        }
         else
         {
-            task = pkgTasks()->doing().find( zyppRes );
+            task = pkgTasks()->doing().find( ident );
 
             if ( task )
+            {
                 PkgTasks::moveTask( task, pkgTasks()->doing(), pkgTasks()->failed() );
+                _progress.leaveDoing( task, false );
+            }
         }
 
         updateListHeaders();
@@ -1050,9 +996,11 @@ void PkgCommitPage::pkgActionError( ZyppRes         zyppRes,
         if ( ! task )
         {
             logError() << caller << "(): "
-                       << "Can't find task for " << zyppRes << endl;
+                       << "Can't find task for " << pkgName << endl;
         }
     }
+
+    return reply;
 }
 
 
@@ -1082,20 +1030,14 @@ void PkgCommitPage::fileConflictsCheckProgress( int percent )
 
     // Show the progress dialog if it's not shown yet
 
-    const int millisec   = 1500;
-    bool doProcessEvents = fileConflictsProgressDialog()->showDelayed( millisec );
+    const int millisec = 1500;
+    fileConflictsProgressDialog()->showDelayed( millisec );
 
 
     // Update the progress bar
 
     if ( percent > fileConflictsProgressDialog()->value() )
-    {
         fileConflictsProgressDialog()->setValue( percent );
-        doProcessEvents = true;
-    }
-
-    if ( doProcessEvents )
-        processEvents();
 }
 
 
@@ -21,9 +21,13 @@
 #include <QStringList>
 #include <QWidget>
 
+#include <zypp/IdString.h>
 #include <zypp/ZYppCommitPolicy.h>
 
-#include "YQZypp.h"     // ZyppRes
+#include "PkgCommitCallbacks.h" // ErrorReply, PkgCommitEvent
+#include "PkgCommitProgress.h"
+#include "PkgTasks.h"           // PkgTaskAction
+#include "YQZypp.h"             // ZyppRes
 
 
 // Generated with 'uic' from a Qt designer .ui form: pkg-commit.ui
@@ -35,7 +39,7 @@
 
 
 class ProgressDialog;
-using zypp::ByteCount;
+class QTimer;
 
 
 /**
@@ -63,7 +67,9 @@ using zypp::ByteCount;
  * package might be in "doing".
  *
  * This whole class relies heavily on libzypp callbacks reporting progress and
- * possible problems.
+ * possible problems. The commit runs in a PkgCommitWorker thread; the
+ * callbacks post their events to the PkgCommitEventQueue, and this page
+ * fetches and processes them on a timer in the GUI thread.
  **/
 class PkgCommitPage: public QWidget
 {
@@ -93,10 +99,10 @@ public:
     /**
      * Start the package transactions.
      *
-     * The passes control mostly to libzypp which has to call callbacks to
-     * update the widgets reporting the progress. The callbacks will also do a
-     * little Qt event processing (some milliseconds) to give the user a chance
-     * to use the "Cancel" button or other interactive widgets.
+     * This starts the libzypp commit in a worker thread and processes the
+     * events from its callbacks until it is finished; the Qt event loop
+     * keeps running in the meantime, so the user can use the "Cancel"
+     * button or other interactive widgets.
      *
      * When this function returns (which will take a while), all the package
      * transactions should be done, or there was an unrecoverable error.
@@ -167,35 +173,6 @@ signals:
     void abortCommit();
 
 
-public slots:
-
-    //
-    // PkgCommitCallback slots
-    //
-
-    void pkgDownloadStart    ( ZyppRes zyppRes );
-    void pkgDownloadProgress ( ZyppRes zyppRes, int value );
-    void pkgDownloadEnd      ( ZyppRes zyppRes );
-
-    void pkgCachedNotify     ( ZyppRes zyppRes );
-    void pkgDownloadError    ( ZyppRes zyppRes, const QString & msg );
-
-
-    void pkgInstallStart     ( ZyppRes zyppRes );
-    void pkgInstallProgress  ( ZyppRes zyppRes, int value );
-    void pkgInstallEnd       ( ZyppRes zyppRes );
-    void pkgInstallError     ( ZyppRes zyppRes, const QString & msg );
-
-    void pkgRemoveStart      ( ZyppRes zyppRes );
-    void pkgRemoveProgress   ( ZyppRes zyppRes, int value );
-    void pkgRemoveEnd        ( ZyppRes zyppRes );
-    void pkgRemoveError      ( ZyppRes zyppRes, const QString & msg );
-
-    void fileConflictsCheckStart();
-    void fileConflictsCheckProgress( int percent );
-    void fileConflictsCheckResult  ( const QStringList & conflicts );
-
-
 protected slots:
 
     /**
@@ -203,6 +180,12 @@ protected slots:
      **/
     void toggleDetails();
 
+    /**
+     * Process all pending events from the PkgCommitEventQueue and update
+     * the widgets.
+     **/
+    void processCommitEvents();
+
 
 protected:
 
@@ -289,18 +272,6 @@ protected:
      **/
     PkgTasks * pkgTasks();
 
-    /**
-     * Initialize and calculate the values for the overall progress.
-     **/
-    void initProgressData();
-
-    /**
-     * Calculate the current progress percent based on the weighted progress
-     * percent of number of completed tasks, completed download size, completed
-     * install size.
-     **/
-    int currentProgressPercent();
-
     /**
      * Calculate the total progress and update the total progress bar if the
      * (integer) percent value is different from the old one.
@@ -325,6 +296,40 @@ protected:
      **/
     void closeFileConflictsProgressDialog();
 
+    /**
+     * Start or end a batch of changes in all task list widgets: While in
+     * batch mode, they don't repaint or scroll for each added item.
+     **/
+    void beginListsBatch();
+    void endListsBatch();
+
+    /**
+     * Process one event from the PkgCommitEventQueue.
+     **/
+    void processCommitEvent( const PkgCommitEvent & event );
+
+    //
+    // Handlers for the events from the libzypp callbacks
+    //
+
+    void pkgDownloadStart    ( zypp::IdString ident );
+    void pkgDownloadProgress ( zypp::IdString ident, int value );
+    void pkgDownloadEnd      ( zypp::IdString ident );
+
+    void pkgCachedNotify     ( zypp::IdString ident );
+
+    void pkgInstallStart     ( zypp::IdString ident );
+    void pkgInstallProgress  ( zypp::IdString ident, int value );
+    void pkgInstallEnd       ( zypp::IdString ident );
+
+    void pkgRemoveStart      ( zypp::IdString ident );
+    void pkgRemoveProgress   ( zypp::IdString ident, int value );
+    void pkgRemoveEnd        ( zypp::IdString ident );
+
+    void fileConflictsCheckStart();
+    void fileConflictsCheckProgress( int percent );
+    void fileConflictsCheckResult  ( const QStringList & conflicts );
+
     /**
      * The common part of pkgInstallStart() and pkgRemoveStart() /
      * ...progress(), ...End(), ...Error().
@@ -332,23 +337,31 @@ protected:
      * 'action' is one of PkgInstall or PkgRemove,
      * 'caller' is the calling function (__FUNCTION__) for logging.
      **/
-    void pkgActionStart   ( ZyppRes         zyppRes,
+    void pkgActionStart   ( zypp::IdString  ident,
                             PkgTaskAction   action,
                             const char *    caller );
 
-    void pkgActionProgress( ZyppRes         zyppRes,
+    void pkgActionProgress( zypp::IdString  ident,
                             int             percent,
                             PkgTaskAction   action,
                             const char *    caller );
 
-    void pkgActionEnd     ( ZyppRes         zyppRes,
+    void pkgActionEnd     ( zypp::IdString  ident,
                             PkgTaskAction   action,
                             const char *    caller );
 
-    void pkgActionError   ( ZyppRes         zyppRes,
-                            const QString & errorMsg,
-                            const QString & msgHeader,
-                            const char *    caller );
+    /**
+     * Handle a download, install or remove error: Ask the user what to do
+     * and return the answer.
+     *
+     * 'msgHeader' is the header of the error pop-up with a "%1" placeholder
+     * for 'pkgName'.
+     **/
+    ErrorReply pkgActionError( zypp::IdString  ident,
+                               const QString & pkgName,
+                               const QString & errorMsg,
+                               const QString & msgHeader,
+                               const char *    caller );
 
     //
     // Data members
@@ -359,18 +372,10 @@ protected:
     bool                _showDetails;
     bool                _startedInstallingPkg;
     ProgressDialog *    _fileConflictsProgressDialog;
-
-    ByteCount           _totalDownloadSize;
-    ByteCount           _totalInstalledSize;
-    int                 _totalTasksCount;
-
-    ByteCount           _completedDownloadSize;
-    ByteCount           _completedInstalledSize;
-    int                 _completedTasksCount;
-
-    float               _pkgFixedCostWeight; // 0.0 .. 1.0
-    float               _pkgDownloadWeight;  // 0.0 .. 1.0
-    float               _pkgActionWeight;    // 0.0 .. 1.0
+    QTimer *            _commitEventsTimer;
+    bool                _processingCommitEvents;
+    int                 _maxUpdatesPerSec;
+    PkgCommitProgress   _progress;
 
     QPixmap             _downloadOngoingIcon;
     QPixmap             _downloadDoneIcon;
@@ -0,0 +1,233 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#include <QtGlobal>     // qBound()
+
+#include "Logger.h"
+#include "PkgTasks.h"
+#include "PkgCommitProgress.h"
+
+#define VERBOSE_PROGRESS        0
+
+
+PkgCommitProgress::PkgCommitProgress()
+    : _totalTasksCount( 0 )
+    , _completedTasksCount( 0 )
+    , _downloadingSize( 0.0 )
+    , _installingSize( 0.0 )
+    , _pkgFixedCostWeight( 0.10 )
+    , _pkgDownloadWeight( 0.60 )
+    , _pkgActionWeight( 0.30 )
+{
+    // NOP
+}
+
+
+void PkgCommitProgress::init( const PkgTaskList & todo )
+{
+    _totalDownloadSize      = 0;
+    _totalInstalledSize     = 0;
+    _totalTasksCount        = todo.size();
+
+    _completedDownloadSize  = 0;
+    _completedInstalledSize = 0;
+    _completedTasksCount    = 0;
+
+    _downloadingSize        = 0.0;
+    _installingSize         = 0.0;
+
+    for ( const PkgTask * task: todo )
+    {
+        if ( ( task->action() & PkgAdd ) && task->downloadSize() > 0 )
+            _totalDownloadSize += task->downloadSize();
+
+        if ( task->installedSize() > 0 )
+            _totalInstalledSize += task->installedSize();
+    }
+
+    logDebug() << "total download size:  " << _totalDownloadSize.asString()  << endl;
+    logDebug() << "total installed size: " << _totalInstalledSize.asString() << endl;
+    logDebug() << "total tasks: "          << _totalTasksCount << endl;
+
+    // Weights for different sub-tasks of downloading and installing packages:
+    // There is a constant cost for doing anything with a package, no matter if
+    // it's installing or removing it: The 'handling' of the package.
+    //
+    // Of course a large part of the cost is the download, and another is the
+    // cost of actually installing or removing it, be it unpacking an RPM (for
+    // installing a package) or removing it (removing every item of its file
+    // list).
+
+    _pkgDownloadWeight  = 0.60;
+    _pkgActionWeight    = 0.30;
+    _pkgFixedCostWeight = 0.10;
+
+    logDebug() << "pkgDownloadWeight:  " << _pkgDownloadWeight  << endl;
+    logDebug() << "pkgActionWeight:    " << _pkgActionWeight    << endl;
+    logDebug() << "pkgFixedCostWeight: " << _pkgFixedCostWeight << endl;
+}
+
+
+double PkgCommitProgress::downloadedSize( const PkgTask * task )
+{
+    if ( ( task->action() & PkgAdd )    &&
+         task->downloadSize()      > 0  &&
+         task->downloadedPercent() > 0 )
+    {
+        return task->downloadSize() * ( task->downloadedPercent() / 100.0 );
+    }
+
+    return 0.0;
+}
+
+
+double PkgCommitProgress::completedSize( const PkgTask * task )
+{
+    if ( task->installedSize() > 0 && task->completedPercent() > 0 )
+        return task->installedSize() * ( task->completedPercent() / 100.0 );
+
+    return 0.0;
+}
+
+
+void PkgCommitProgress::setDownloadedPercent( PkgTask * task, int percent )
+{
+    _downloadingSize -= downloadedSize( task );
+    task->setDownloadedPercent( percent );
+    _downloadingSize += downloadedSize( task );
+}
+
+
+void PkgCommitProgress::leaveDownloads( PkgTask * task, bool completed )
+{
+    _downloadingSize -= downloadedSize( task );
+
+    if ( _downloadingSize < 0.0 ) // Rounding errors
+        _downloadingSize = 0.0;
+
+    if ( completed && task->downloadSize() > 0 )
+        _completedDownloadSize += task->downloadSize();
+}
+
+
+void PkgCommitProgress::setCompletedPercent( PkgTask * task, int percent )
+{
+    _installingSize -= completedSize( task );
+    task->setCompletedPercent( percent );
+    _installingSize += completedSize( task );
+}
+
+
+void PkgCommitProgress::leaveDoing( PkgTask * task, bool completed )
+{
+    _installingSize -= completedSize( task );
+
+    if ( _installingSize < 0.0 ) // Rounding errors
+        _installingSize = 0.0;
+
+    if ( completed )
+    {
+        ++_completedTasksCount;
+
+        if ( task->installedSize() > 0 )
+            _completedInstalledSize += task->installedSize();
+    }
+}
+
+
+int PkgCommitProgress::percent() const
+{
+    float downloadPercent  = 0.0;
+    float installedPercent = 0.0;
+    float tasksPercent     = 0.0;
+    float percent          = 0.0;
+
+    //
+    // Download %
+    //
+
+    if ( _totalDownloadSize > 0 )
+    {
+        double downloadSize = _completedDownloadSize + _downloadingSize;
+        percent = ( 100.0 * downloadSize ) / _totalDownloadSize;
+    }
+    else // no download needed?
+    {
+        percent = 100.0; // download is 100% completed
+    }
+
+    downloadPercent = percent * _pkgDownloadWeight;
+
+#if VERBOSE_PROGRESS
+
+    logVerbose() << "Download  %: "  << downloadPercent
+                 << "  weight: "     << _pkgDownloadWeight
+                 << "  raw %: "      << percent
+                 << endl;
+#endif
+
+    //
+    // Installed / removed size %
+    //
+
+    if ( _totalInstalledSize > 0 )  // Prevent division by zero
+    {
+        double installedSize = _completedInstalledSize + _installingSize;
+
+        percent          = ( 100.0 * installedSize ) / _totalInstalledSize;
+        installedPercent = percent * _pkgActionWeight;
+
+#if VERBOSE_PROGRESS
+
+        logVerbose() << "Installed %: " << installedPercent
+                     << "  weight: "    << _pkgActionWeight
+                     << "  raw %: "     << percent
+                     << endl;
+#endif
+    }
+
+
+    //
+    // Number of tasks %
+    //
+
+    if ( _totalTasksCount > 0 )  // Prevent division by zero
+    {
+        percent      = ( 100.0 * _completedTasksCount ) / _totalTasksCount;
+        tasksPercent = percent * _pkgFixedCostWeight;
+
+#if VERBOSE_PROGRESS
+
+        logVerbose() << "Tasks     %: " << tasksPercent
+                     << "  weight: "    << _pkgFixedCostWeight
+                     << "  raw %: "     << percent
+                     << endl;
+#endif
+    }
+
+
+    //
+    // Total progress
+    //
+
+    float progress = tasksPercent + downloadPercent + installedPercent;
+
+#if VERBOSE_PROGRESS
+    logVerbose() << "Progress: " << progress << "%" << endl;
+#endif
+
+    return qBound( 0, (int) ( progress + 0.5 ), 100 );
+}
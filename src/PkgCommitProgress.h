@@ -0,0 +1,123 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef PkgCommitProgress_h
+#define PkgCommitProgress_h
+
+
+#include <zypp-core/ByteCount.h>
+
+class PkgTask;
+class PkgTaskList;
+
+using zypp::ByteCount;
+
+
+/**
+ * Aggregator for the total progress of a package commit.
+ *
+ * The total progress is a weighted sum of the completed download size, the
+ * completed installed size and the number of completed tasks. This keeps
+ * running sums of all of them, including the partial progress of the tasks
+ * that are currently being downloaded or installed / removed, so
+ * percent() doesn't need to go through any task lists.
+ *
+ * For that, the partial progress of a task needs to be set with the
+ * functions of this class as long as the task is in the "downloads" or in
+ * the "doing" list, and the class needs to be notified when a task leaves
+ * one of those lists.
+ **/
+class PkgCommitProgress
+{
+public:
+
+    /**
+     * Constructor.
+     **/
+    PkgCommitProgress();
+
+    /**
+     * Initialize the totals from the tasks in 'todo' and reset all other
+     * values.
+     **/
+    void init( const PkgTaskList & todo );
+
+    /**
+     * Set the downloaded percent of 'task' which is in the "downloads"
+     * list. Use this also when the task is moved to that list.
+     **/
+    void setDownloadedPercent( PkgTask * task, int percent );
+
+    /**
+     * Notification that 'task' is moved out of the "downloads" list.
+     * If 'completed' is 'true', the download is complete, otherwise it
+     * failed.
+     **/
+    void leaveDownloads( PkgTask * task, bool completed );
+
+    /**
+     * Set the completed percent of 'task' which is in the "doing" list.
+     * Use this also when the task is moved to that list.
+     **/
+    void setCompletedPercent( PkgTask * task, int percent );
+
+    /**
+     * Notification that 'task' is moved out of the "doing" list.
+     * If 'completed' is 'true', the task is done, otherwise it failed.
+     **/
+    void leaveDoing( PkgTask * task, bool completed );
+
+    /**
+     * Return the current total progress in percent (0..100).
+     **/
+    int percent() const;
+
+
+protected:
+
+    /**
+     * Return the part of the download size of 'task' that is downloaded.
+     **/
+    static double downloadedSize( const PkgTask * task );
+
+    /**
+     * Return the part of the installed size of 'task' that is completed.
+     **/
+    static double completedSize( const PkgTask * task );
+
+
+    //
+    // Data members
+    //
+
+    ByteCount _totalDownloadSize;
+    ByteCount _totalInstalledSize;
+    int       _totalTasksCount;
+
+    ByteCount _completedDownloadSize;
+    ByteCount _completedInstalledSize;
+    int       _completedTasksCount;
+
+    double    _downloadingSize;         // Partial sizes in "downloads"
+    double    _installingSize;          // Partial sizes in "doing"
+
+    float     _pkgFixedCostWeight;      // 0.0 .. 1.0
+    float     _pkgDownloadWeight;       // 0.0 .. 1.0
+    float     _pkgActionWeight;         // 0.0 .. 1.0
+};
+
+
+#endif // PkgCommitProgress_h
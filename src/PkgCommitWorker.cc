@@ -0,0 +1,67 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#include <zypp/ZYppFactory.h>
+#include <zypp/target/TargetException.h>
+
+#include "Logger.h"
+#include "PkgCommitCallbacks.h"
+#include "utf8.h"
+#include "PkgCommitWorker.h"
+
+
+PkgCommitWorker::PkgCommitWorker( const zypp::ZYppCommitPolicy & policy,
+                                  QObject *                      parent )
+    : QThread( parent )
+    , _policy( policy )
+    , _aborted( false )
+{
+    // NOP
+}
+
+
+PkgCommitWorker::~PkgCommitWorker()
+{
+    wait();
+}
+
+
+void
+PkgCommitWorker::run()
+{
+    // Create and install the callbacks.
+    // They are uninstalled when the 'callbacks' variable goes out of scope.
+    PkgCommitCallbacks callbacks;
+
+    try
+    {
+        logInfo() << "Starting package transactions" << endl;
+
+        zypp::getZYpp()->commit( _policy );
+
+        logInfo() << "Package transactions done" << endl;
+    }
+    catch ( const zypp::target::TargetAbortedException & ex )
+    {
+        logInfo() << "libzypp aborted as requested" << endl;
+        _aborted = true;
+    }
+    catch ( const std::exception & exception )
+    {
+        logError() << "CAUGHT zypp exception: " << exception.what() << endl;
+        _errorMessage = fromUTF8( exception.what() );
+    }
+}
@@ -0,0 +1,90 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef PkgCommitWorker_h
+#define PkgCommitWorker_h
+
+
+#include <QString>
+#include <QThread>
+
+#include <zypp/ZYppCommitPolicy.h>
+
+
+/**
+ * Worker thread for the libzypp package commit, i.e. downloading and
+ * installing / updating / removing packages.
+ *
+ * The libzypp commit callbacks (see PkgCommitCallbacks) are called in this
+ * thread; they post their progress events to the PkgCommitEventQueue where
+ * the GUI thread picks them up. The inherited QThread::finished() signal is
+ * emitted when the commit is done.
+ *
+ * To abort the commit, use PkgCommitEventQueue::abortCommit(). libzypp
+ * only checks that in its progress callbacks, so it may take a moment until
+ * it actually stops.
+ **/
+class PkgCommitWorker: public QThread
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor. Call start() to start the commit with 'policy'.
+     **/
+    PkgCommitWorker( const zypp::ZYppCommitPolicy & policy,
+                     QObject *                      parent = 0 );
+
+    /**
+     * Destructor. This waits for the thread to finish if it is still
+     * running.
+     **/
+    virtual ~PkgCommitWorker();
+
+    /**
+     * Return 'true' if libzypp aborted the commit as requested.
+     **/
+    bool aborted() const { return _aborted; }
+
+    /**
+     * Return the error message if the commit failed with an exception, or
+     * an empty string if not.
+     **/
+    const QString & errorMessage() const { return _errorMessage; }
+
+
+protected:
+
+    /**
+     * Do the commit. This is executed in the worker thread.
+     *
+     * Reimplemented from QThread.
+     **/
+    virtual void run() override;
+
+
+    //
+    // Data members
+    //
+
+    zypp::ZYppCommitPolicy _policy;
+    bool                   _aborted;
+    QString                _errorMessage;
+};
+
+
+#endif // PkgCommitWorker_h
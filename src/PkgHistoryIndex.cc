@@ -0,0 +1,531 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#include <algorithm>    // std::sort()
+#include <fstream>
+#include <iterator>     // std::back_inserter()
+
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <sys/stat.h>   // stat()
+
+#include <zypp/base/String.h>
+#include <zypp-core/base/Exception.h>
+
+#include "Logger.h"
+#include "utf8.h"
+#include "PkgHistoryIndex.h"
+
+
+// Check for an interruption request every this many lines
+#define INTERRUPT_CHECK_LINES   1000
+
+// Number of bytes at the end of the indexed part of the history file that
+// are compared to check if that part is unchanged
+#define TAIL_SIZE               128
+
+// Cache file format
+#define CACHE_MAGIC             0x4d484958      // "MHIX"
+#define CACHE_VERSION           1
+
+
+PkgHistoryIndex::PkgHistoryIndex( const QString & filename )
+    : _filename( filename )
+    , _scannedSize( 0 )
+    , _fileInode( 0 )
+    , _fileSize( 0 )
+    , _fileMtime( 0 )
+{
+    // NOP
+}
+
+
+PkgHistoryIndex::~PkgHistoryIndex()
+{
+    // NOP
+}
+
+
+void
+PkgHistoryIndex::clear()
+{
+    _scannedSize = 0;
+    _fileInode   = 0;
+    _fileSize    = 0;
+    _fileMtime   = 0;
+    _days.clear();
+    _records.clear();
+    _pkgRecords.clear();
+    _errorMessage.clear();
+}
+
+
+bool
+PkgHistoryIndex::scan()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    _errorMessage.clear();
+
+    quint64 inode;
+    qint64  size;
+    qint64  mtime;
+
+    if ( fileStat( inode, size, mtime ) )
+    {
+        if ( inode != _fileInode || size < _scannedSize ) // Rotated or truncated?
+        {
+            if ( _scannedSize > 0 )
+                logInfo() << _filename << " was replaced: Scanning from scratch" << endl;
+
+            clear();
+        }
+
+        _fileInode = inode;
+        _fileSize  = size;
+        _fileMtime = mtime;
+    }
+
+    std::ifstream file( toUTF8( _filename ) );
+
+    if ( ! file.is_open() )
+    {
+        _errorMessage = QString( "Can't open %1" ).arg( _filename );
+        logWarning() << _errorMessage << endl;
+
+        return false;
+    }
+
+    file.seekg( _scannedSize );
+
+    std::string line;
+    qint64      offset    = _scannedSize;
+    int         lineCount = 0;
+
+    while ( std::getline( file, line ) )
+    {
+        // A line without a newline at the end of the file might still be
+        // in the process of being written: Leave it for the next scan.
+
+        if ( file.eof() )
+            break;
+
+        addLine( line, offset );
+
+        offset      += line.size() + 1;
+        _scannedSize = offset;
+
+        if ( ++lineCount % INTERRUPT_CHECK_LINES == 0 &&
+             QThread::currentThread()->isInterruptionRequested() )
+        {
+            logDebug() << "Scanning " << _filename << " canceled" << endl;
+            return false;
+        }
+    }
+
+    logInfo() << "Scanned " << lineCount << " lines of " << _filename
+              << " in " << timer.elapsed() << " millisec: "
+              << _days.size() << " days, "
+              << _records.size() << " actions, "
+              << _pkgRecords.size() << " packages"
+              << endl;
+
+    return true;
+}
+
+
+bool
+PkgHistoryIndex::update()
+{
+    if ( _scannedSize == 0 && ! _cacheFile.isEmpty() )
+        loadCache();
+
+    qint64 oldScannedSize = _scannedSize;
+    qint64 oldFileMtime   = _fileMtime;
+
+    if ( ! scan() )
+        return false;
+
+    if ( ! _cacheFile.isEmpty() &&
+         ( _scannedSize != oldScannedSize || _fileMtime != oldFileMtime ) )
+    {
+        saveCache();
+    }
+
+    return true;
+}
+
+
+bool
+PkgHistoryIndex::fileStat( quint64 & inode, qint64 & size, qint64 & mtime ) const
+{
+    struct stat statInfo;
+
+    if ( stat( toUTF8( _filename ).c_str(), &statInfo ) != 0 )
+        return false;
+
+    inode = (quint64) statInfo.st_ino;
+    size  = (qint64)  statInfo.st_size;
+    mtime = (qint64)  statInfo.st_mtime;
+
+    return true;
+}
+
+
+QByteArray
+PkgHistoryIndex::readTail( qint64 endOffset ) const
+{
+    QFile file( _filename );
+
+    if ( endOffset <= 0 || ! file.open( QIODevice::ReadOnly ) )
+        return QByteArray();
+
+    qint64 start = qMax( (qint64) 0, endOffset - TAIL_SIZE );
+
+    if ( ! file.seek( start ) )
+        return QByteArray();
+
+    return file.read( endOffset - start );
+}
+
+
+bool
+PkgHistoryIndex::loadCache()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    clear();
+
+    QFile file( _cacheFile );
+
+    if ( ! file.open( QIODevice::ReadOnly ) )
+        return false;
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_6_0 );
+
+    quint32    magic   = 0;
+    quint32    version = 0;
+    QByteArray tail;
+
+    stream >> magic >> version;
+
+    if ( magic != CACHE_MAGIC || version != CACHE_VERSION )
+    {
+        logInfo() << "Ignoring incompatible cache file " << _cacheFile << endl;
+        return false;
+    }
+
+    stream >> _fileInode >> _fileSize >> _fileMtime >> _scannedSize >> tail
+           >> _days >> _records >> _pkgRecords;
+
+    if ( stream.status() != QDataStream::Ok )
+    {
+        logWarning() << "Error reading cache file " << _cacheFile << endl;
+        clear();
+
+        return false;
+    }
+
+
+    // Check if the cache is still valid for the history file
+
+    quint64 inode;
+    qint64  size;
+    qint64  mtime;
+    QString reason;
+
+    if ( ! fileStat( inode, size, mtime ) )
+        reason = "Can't access the history file";
+    else if ( inode != _fileInode )
+        reason = "History file was rotated";
+    else if ( size < _scannedSize )
+        reason = "History file was truncated";
+    else if ( ( size != _fileSize || mtime != _fileMtime ) && readTail( _scannedSize ) != tail )
+        reason = "History file was rewritten";
+
+    if ( ! reason.isEmpty() )
+    {
+        logInfo() << "Not using cache file " << _cacheFile << ": " << reason << endl;
+        clear();
+
+        return false;
+    }
+
+    logInfo() << "Loaded " << _records.size() << " history actions from "
+              << _cacheFile << " in " << timer.elapsed() << " millisec" << endl;
+
+    return true;
+}
+
+
+bool
+PkgHistoryIndex::saveCache() const
+{
+    QDir().mkpath( QFileInfo( _cacheFile ).absolutePath() );
+
+    // Write to a temporary file and only replace the old cache file when
+    // everything is written, so a crash can't leave a broken cache file.
+
+    QSaveFile file( _cacheFile );
+
+    if ( ! file.open( QIODevice::WriteOnly ) )
+    {
+        logWarning() << "Can't write cache file " << _cacheFile << endl;
+        return false;
+    }
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_6_0 );
+
+    stream << (quint32) CACHE_MAGIC << (quint32) CACHE_VERSION
+           << _fileInode << _fileSize << _fileMtime << _scannedSize
+           << readTail( _scannedSize )
+           << _days << _records << _pkgRecords;
+
+    if ( stream.status() != QDataStream::Ok || ! file.commit() )
+    {
+        logWarning() << "Error writing cache file " << _cacheFile << endl;
+        return false;
+    }
+
+    logDebug() << "Saved " << _records.size() << " history actions to " << _cacheFile << endl;
+
+    return true;
+}
+
+
+QDataStream & operator<<( QDataStream & stream, const PkgHistoryIndex::Day & day )
+{
+    return stream << day.date << (qint32) day.firstRecord << (qint32) day.recordCount;
+}
+
+
+QDataStream & operator>>( QDataStream & stream, PkgHistoryIndex::Day & day )
+{
+    qint32 firstRecord = 0;
+    qint32 recordCount = 0;
+
+    stream >> day.date >> firstRecord >> recordCount;
+
+    day.firstRecord = firstRecord;
+    day.recordCount = recordCount;
+
+    return stream;
+}
+
+
+QDataStream & operator<<( QDataStream & stream, const PkgHistoryIndex::Record & record )
+{
+    return stream << record.offset << record.length << record.day;
+}
+
+
+QDataStream & operator>>( QDataStream & stream, PkgHistoryIndex::Record & record )
+{
+    return stream >> record.offset >> record.length >> record.day;
+}
+
+
+void
+PkgHistoryIndex::addLine( const std::string & line, qint64 offset )
+{
+    // Sample lines (the fields are separated by '|'):
+    //
+    //   2024-12-06 18:24:59|install|libfoo1|1.2-3.1|x86_64||repo-oss|0123abcd|
+    //   2024-12-06 18:25:01|remove |libfoo0|1.1-2.1|x86_64|root@localhost|
+    //   2024-12-07 10:12:33|radd  |repo-foo|https://download.example.com/foo|
+
+    if ( line.empty() || line[0] == '#' )
+        return;
+
+    size_t dateEnd = line.find( '|' );
+
+    if ( dateEnd == std::string::npos )
+        return;
+
+    // Only the date part of the timestamp "yyyy-MM-dd hh:mm:ss"
+
+    QByteArray date( line.data(), (int) std::min( dateEnd, (size_t) 10 ) );
+
+    if ( _days.isEmpty() || _days.last().date != date ) // First line of a new day?
+        _days.append( Day { date, (int) _records.size(), 0 } );
+
+    size_t actionEnd = line.find( '|', dateEnd + 1 );
+
+    if ( actionEnd == std::string::npos )
+        return;
+
+    std::string action = zypp::str::trim( line.substr( dateEnd + 1, actionEnd - dateEnd - 1 ) );
+    zypp::HistoryActionID actionId( action );
+
+    switch ( actionId.toEnum() )
+    {
+        case zypp::HistoryActionID::INSTALL_e:
+        case zypp::HistoryActionID::REMOVE_e:
+        case zypp::HistoryActionID::REPO_ADD_e:
+        case zypp::HistoryActionID::REPO_REMOVE_e:
+        case zypp::HistoryActionID::REPO_CHANGE_ALIAS_e:
+        case zypp::HistoryActionID::REPO_CHANGE_URL_e:
+            break;
+
+        default: // Not shown to the user, so no need to index it
+            return;
+    }
+
+    int recordNo = (int) _records.size();
+    _records.append( Record { offset, (quint32) line.size(), (quint32) _days.size() - 1 } );
+    ++_days.last().recordCount;
+
+    if ( actionId.toEnum() == zypp::HistoryActionID::INSTALL_e ||
+         actionId.toEnum() == zypp::HistoryActionID::REMOVE_e     )
+    {
+        size_t nameEnd = line.find( '|', actionEnd + 1 );
+
+        if ( nameEnd != std::string::npos )
+        {
+            QByteArray name( line.data() + actionEnd + 1, (int) ( nameEnd - actionEnd - 1 ) );
+            _pkgRecords[ name ].append( recordNo );
+        }
+    }
+}
+
+
+QVector<int>
+PkgHistoryIndex::pkgRecords( const QString & pattern ) const
+{
+    QVector<int> result;
+
+    for ( auto it = _pkgRecords.constBegin(); it != _pkgRecords.constEnd(); ++it )
+    {
+        if ( QString::fromUtf8( it.key() ).contains( pattern, Qt::CaseInsensitive ) )
+            result += it.value();
+    }
+
+    std::sort( result.begin(), result.end() );
+
+    return result;
+}
+
+
+QVector<int>
+PkgHistoryIndex::dayRecords( int dayNo ) const
+{
+    QVector<int> result;
+
+    if ( dayNo >= 0 && dayNo < _days.size() )
+    {
+        const Day & day = _days.at( dayNo );
+        result.reserve( day.recordCount );
+
+        for ( int i = 0; i < day.recordCount; ++i )
+            result.append( day.firstRecord + i );
+    }
+
+    return result;
+}
+
+
+QVector<zypp::HistoryLogData::Ptr>
+PkgHistoryIndex::readRecords( const QVector<int> & recordNos ) const
+{
+    QVector<zypp::HistoryLogData::Ptr> result;
+
+    std::ifstream file( toUTF8( _filename ) );
+
+    if ( ! file.is_open() )
+    {
+        logWarning() << "Can't open " << _filename << endl;
+        return result;
+    }
+
+    result.reserve( recordNos.size() );
+    std::string line;
+
+    for ( int recordNo: recordNos )
+    {
+        if ( recordNo < 0 || recordNo >= _records.size() )
+            continue;
+
+        const Record & record = _records.at( recordNo );
+
+        line.resize( record.length );
+        file.seekg( record.offset );
+
+        if ( ! file.read( &line[0], record.length ) )
+        {
+            logWarning() << "Can't read " << _filename
+                         << " at offset " << record.offset << endl;
+            file.clear();
+            continue;
+        }
+
+        // Split the line into fields just like zypp::parser::HistoryLogReader
+
+        zypp::HistoryLogData::FieldVector fields;
+        zypp::str::splitEscaped( line, std::back_inserter( fields ), "|", true );
+
+        if ( fields.size() >= 2 )
+            fields[1] = zypp::str::trim( fields[1] ); // The action is padded with blanks
+
+        try
+        {
+            result.append( zypp::HistoryLogData::create( fields ) );
+        }
+        catch ( const zypp::Exception & exception )
+        {
+            logWarning() << "Can't parse history line \"" << line << "\": "
+                         << exception.asUserHistory() << endl;
+        }
+    }
+
+    return result;
+}
+
+
+//
+//----------------------------------------------------------------------
+//
+
+
+PkgHistoryWorker::PkgHistoryWorker( PkgHistoryIndex * index,
+                                    QObject *         parent )
+    : QThread( parent )
+    , _index( index )
+    , _success( false )
+{
+    // NOP
+}
+
+
+PkgHistoryWorker::~PkgHistoryWorker()
+{
+    wait();
+}
+
+
+void
+PkgHistoryWorker::run()
+{
+    _success = _index->update();
+}
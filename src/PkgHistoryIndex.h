@@ -0,0 +1,285 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef PkgHistoryIndex_h
+#define PkgHistoryIndex_h
+
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QHash>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+#include <zypp/HistoryLogData.h>
+
+
+/**
+ * Compact index of the zypp history file (/var/log/zypp/history):
+ *
+ * It only stores where in the file each action that is shown to the user
+ * is, the days on which they happened and which actions belong to which
+ * package. The actions themselves are parsed from the file only on demand
+ * with readRecords(), typically only the ones for one day.
+ *
+ * This is much faster and uses much less memory than parsing the complete
+ * file with a zypp::parser::HistoryLogReader which can take a long time on
+ * a system with a long history.
+ *
+ * Since the history file only grows (until it is rotated), the index can be
+ * saved to a cache file; the next update() then only needs to scan what
+ * was appended to the history file since then.
+ **/
+class PkgHistoryIndex
+{
+public:
+
+    /**
+     * One action line in the history file.
+     **/
+    struct Record
+    {
+        qint64  offset;     // of the line in the history file
+        quint32 length;     // of the line without the newline
+        quint32 day;        // index in days()
+    };
+
+    /**
+     * A sequence of lines in the history file with the same date.
+     **/
+    struct Day
+    {
+        QByteArray date;        // "yyyy-MM-dd" as in the history file
+        int        firstRecord; // index in records()
+        int        recordCount;
+    };
+
+    /**
+     * Constructor for an index of history file 'filename'.
+     * Call scan() to actually read it.
+     **/
+    PkgHistoryIndex( const QString & filename );
+
+    /**
+     * Destructor.
+     **/
+    virtual ~PkgHistoryIndex();
+
+    /**
+     * Return the filename of the history file.
+     **/
+    const QString & filename() const { return _filename; }
+
+    /**
+     * Clear the index.
+     **/
+    void clear();
+
+    /**
+     * Set the cache file for update(). If this is empty, no cache is used.
+     **/
+    void setCacheFile( const QString & cacheFile ) { _cacheFile = cacheFile; }
+
+    /**
+     * Return the cache file.
+     **/
+    const QString & cacheFile() const { return _cacheFile; }
+
+    /**
+     * Bring the index up to date: If it is empty, load the cache file (if
+     * there is one and it is still valid for the history file), then
+     * scan() the rest of the history file and save the cache file again if
+     * anything changed.
+     *
+     * This can be called in a worker thread.
+     *
+     * Return 'true' on success, 'false' on error or when canceled.
+     **/
+    bool update();
+
+    /**
+     * Load the index from the cache file.
+     *
+     * The cache is only used if the history file is still the same file
+     * (same inode) and it was not truncated (not smaller than what is in
+     * the index), and if it changed (different size or modification time),
+     * only if the last indexed bytes are still the same.
+     *
+     * Return 'true' on success, 'false' if there is no usable cache. The
+     * index is empty in that case.
+     **/
+    bool loadCache();
+
+    /**
+     * Save the index to the cache file.
+     * Return 'true' on success, 'false' on error.
+     **/
+    bool saveCache() const;
+
+    /**
+     * Read the history file and add everything after the part that is
+     * already in the index. Incomplete lines at the end of the file are
+     * ignored; they will be picked up in the next scan().
+     *
+     * This can be called in a worker thread; it stops early when that
+     * thread is requested to stop with QThread::requestInterruption().
+     *
+     * Return 'true' on success, 'false' on error or when canceled.
+     **/
+    bool scan();
+
+    /**
+     * Return the number of bytes of the history file that are in the
+     * index, i.e. the start of the next line that still needs to be read.
+     **/
+    qint64 scannedSize() const { return _scannedSize; }
+
+    /**
+     * Return the days, in the order of the history file.
+     **/
+    const QVector<Day> & days() const { return _days; }
+
+    /**
+     * Return all the action records, in the order of the history file.
+     **/
+    const QVector<Record> & records() const { return _records; }
+
+    /**
+     * Return the indexes (in records()) of the install and remove actions
+     * for all packages with 'pattern' in their name (case-insensitive), in
+     * ascending order.
+     **/
+    QVector<int> pkgRecords( const QString & pattern ) const;
+
+    /**
+     * Read the action records with indexes 'recordNos' from the history
+     * file and parse them. Records that can't be parsed are skipped.
+     **/
+    QVector<zypp::HistoryLogData::Ptr> readRecords( const QVector<int> & recordNos ) const;
+
+    /**
+     * Return the indexes of all the records of day 'dayNo'.
+     **/
+    QVector<int> dayRecords( int dayNo ) const;
+
+    /**
+     * Return the error message of the last failed scan() or an empty
+     * string if there was no error.
+     **/
+    const QString & errorMessage() const { return _errorMessage; }
+
+
+protected:
+
+    /**
+     * Add one line of the history file that starts at 'offset' to the
+     * index.
+     **/
+    void addLine( const std::string & line, qint64 offset );
+
+    /**
+     * Return the last few bytes of the history file before 'endOffset'.
+     * This is used to check if the indexed part of the file is unchanged.
+     **/
+    QByteArray readTail( qint64 endOffset ) const;
+
+    /**
+     * Get the inode, size and modification time of the history file.
+     * Return 'false' if the file can't be accessed.
+     **/
+    bool fileStat( quint64 & inode, qint64 & size, qint64 & mtime ) const;
+
+
+    //
+    // Data members
+    //
+
+    QString         _filename;
+    QString         _cacheFile;
+    qint64          _scannedSize;
+    quint64         _fileInode;     // of the history file at the last scan()
+    qint64          _fileSize;      // of the history file at the last scan()
+    qint64          _fileMtime;     // of the history file at the last scan()
+    QVector<Day>    _days;
+    QVector<Record> _records;
+    QString         _errorMessage;
+
+    // Package name -> indexes in _records of its install and remove actions
+    QHash<QByteArray, QVector<int> > _pkgRecords;
+};
+
+
+QDataStream & operator<<( QDataStream & stream, const PkgHistoryIndex::Day    & day    );
+QDataStream & operator>>( QDataStream & stream, PkgHistoryIndex::Day          & day    );
+QDataStream & operator<<( QDataStream & stream, const PkgHistoryIndex::Record & record );
+QDataStream & operator>>( QDataStream & stream, PkgHistoryIndex::Record       & record );
+
+
+/**
+ * Worker thread to update a PkgHistoryIndex (load its cache file, scan the
+ * new part of the history file) without blocking the GUI thread.
+ *
+ * The GUI thread must not access the index until the inherited
+ * QThread::finished() signal arrives. Use QThread::requestInterruption() to
+ * stop early; the destructor waits for the thread to finish.
+ **/
+class PkgHistoryWorker: public QThread
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor. Call start() to bring 'index' up to date with
+     * PkgHistoryIndex::update().
+     **/
+    PkgHistoryWorker( PkgHistoryIndex * index,
+                      QObject *         parent = 0 );
+
+    /**
+     * Destructor. This waits for the thread to finish if it is still
+     * running.
+     **/
+    virtual ~PkgHistoryWorker();
+
+    /**
+     * Return 'true' if the scan was successful.
+     * Only call this after the thread is finished.
+     **/
+    bool success() const { return _success; }
+
+
+protected:
+
+    /**
+     * The thread's main function.
+     *
+     * Reimplemented from QThread.
+     **/
+    virtual void run() override;
+
+
+    //
+    // Data members
+    //
+
+    PkgHistoryIndex * _index;
+    bool              _success;
+};
+
+
+#endif // PkgHistoryIndex_h
@@ -0,0 +1,325 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+
+#include <zypp/Resolver.h>
+#include <zypp/ZYppFactory.h>
+#include <zypp/sat/Pool.h>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "PoolReaderThread.h"
+#include "PoolStats.h"
+#include "YQPkgConflictDialog.h"
+#include "PkgResolverScheduler.h"
+
+
+// Delay after the last request before the resolver starts
+#define SOLVE_DELAY_MILLISEC    250
+
+// Interval to check if the pool reader threads are finished
+#define READER_WAIT_MILLISEC    20
+
+
+PkgResolverWorker::PkgResolverWorker( QObject * parent )
+    : QThread( parent )
+    , _success( false )
+    , _elapsedMillisec( 0 )
+{
+    // NOP
+}
+
+
+PkgResolverWorker::~PkgResolverWorker()
+{
+    wait();
+}
+
+
+void
+PkgResolverWorker::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    try
+    {
+        _success = zypp::getZYpp()->resolver()->resolvePool();
+    }
+    catch ( const std::exception & exception )
+    {
+        logError() << "CAUGHT zypp exception: " << exception.what() << endl;
+        _success = false;
+    }
+
+    _elapsedMillisec = timer.elapsed();
+}
+
+
+
+
+PkgResolverScheduler::PkgResolverScheduler( YQPkgConflictDialog * conflictDialog,
+                                            QObject *             parent )
+    : QObject( parent )
+    , _conflictDialog( conflictDialog )
+    , _worker( 0 )
+    , _readersBlocked( false )
+    , _pendingRequest( false )
+    , _requestCount( 0 )
+{
+    CHECK_PTR( _conflictDialog );
+
+    _delayTimer.setSingleShot( true );
+    _delayTimer.setInterval( SOLVE_DELAY_MILLISEC );
+
+    connect( &_delayTimer, SIGNAL( timeout()      ),
+             this,         SLOT  ( startSolving() ) );
+
+    _readerWaitTimer.setSingleShot( true );
+    _readerWaitTimer.setInterval( READER_WAIT_MILLISEC );
+
+    connect( &_readerWaitTimer, SIGNAL( timeout()      ),
+             this,              SLOT  ( startSolving() ) );
+}
+
+
+PkgResolverScheduler::~PkgResolverScheduler()
+{
+    // Don't use waitForIdle() here: It sends signals to the package
+    // selector which is already partially destroyed.
+
+    _delayTimer.stop();
+    _readerWaitTimer.stop();
+
+    if ( _worker )
+    {
+        _worker->disconnect( this );
+        delete _worker; // This waits for the thread to finish
+        _worker = 0;
+        blockInput( false );
+        PoolStats::instance()->thaw();
+    }
+
+    blockReaders( false );
+}
+
+
+void
+PkgResolverScheduler::requestSolve()
+{
+    ++_requestCount;
+
+    if ( _worker )
+    {
+        // The result of the current run will be outdated;
+        // solve again as soon as it is finished.
+
+        _pendingRequest = true;
+        return;
+    }
+
+    // Still waiting for the pool readers? The resolver didn't start yet,
+    // so it will use the current state anyway.
+
+    if ( _readerWaitTimer.isActive() )
+        return;
+
+    _delayTimer.start(); // This restarts the timer if it is already active
+}
+
+
+void
+PkgResolverScheduler::startSolving()
+{
+    if ( _worker )
+    {
+        _pendingRequest = true;
+        return;
+    }
+
+    _pendingRequest = false;
+
+    if ( _conflictDialog->isVisible() )
+    {
+        // The user is resolving conflicts in that dialog,
+        // and it runs the resolver itself when that is done.
+
+        logDebug() << "Conflict dialog is open; dropping resolver request" << endl;
+        _requestCount = 0;
+        blockReaders( false );
+        return;
+    }
+
+    // Search and details view threads read the pool, and some even load
+    // repodata into it: Stop them before the resolver changes the pool,
+    // and don't start any new ones.
+
+    blockReaders( true );
+
+    if ( PoolReaderThread::activeCount() > 0 )
+    {
+        PoolReaderThread::interruptAll();
+        _readerWaitTimer.start();
+        return;
+    }
+
+    _delayTimer.stop();
+    _readerWaitTimer.stop();
+
+    logDebug() << "Starting resolver run for " << _requestCount << " requests" << endl;
+    _requestCount = 0;
+
+    _conflictDialog->prepareSolving();
+
+    // Let the pool create its internal lookup tables in this thread so the
+    // resolver only needs to read them.
+    zypp::sat::Pool::instance().prepare();
+
+    _worker = new PkgResolverWorker( this );
+    CHECK_NEW( _worker );
+
+    connect( _worker, SIGNAL( finished()       ),
+             this,    SLOT  ( workerFinished() ) );
+
+    blockInput( true );
+
+    // Make sure the cached values are up to date
+    // before they are used during the resolver run
+    PoolStats::instance()->freeze();
+    emit solvingStarted();
+
+    _worker->start();
+}
+
+
+void
+PkgResolverScheduler::workerFinished()
+{
+    if ( ! _worker || sender() != _worker )
+        return;
+
+    bool   success         = _worker->success();
+    qint64 elapsedMillisec = _worker->elapsedMillisec();
+
+    _worker->deleteLater();
+    _worker = 0;
+
+    solvingDone();
+
+    if ( _pendingRequest )
+    {
+        logDebug() << "Discarding outdated resolver result" << endl;
+        startSolving();
+    }
+    else
+    {
+        _conflictDialog->processAsyncSolverResult( success, elapsedMillisec );
+    }
+}
+
+
+void
+PkgResolverScheduler::waitForIdle()
+{
+    _delayTimer.stop();
+    _readerWaitTimer.stop();
+    _pendingRequest = false;
+    _requestCount   = 0;
+
+    if ( _worker )
+    {
+        logDebug() << "Waiting for the resolver; discarding its result" << endl;
+
+        _worker->disconnect( this );
+        _worker->wait();
+        _worker->deleteLater();
+        _worker = 0;
+
+        solvingDone();
+    }
+
+    blockReaders( false );
+}
+
+
+void
+PkgResolverScheduler::solvingDone()
+{
+    blockInput( false );
+    blockReaders( false );
+    PoolStats::instance()->thaw();
+
+    emit solvingFinished();
+}
+
+
+void
+PkgResolverScheduler::blockReaders( bool block )
+{
+    if ( block != _readersBlocked )
+    {
+        PoolReaderThread::block( block );
+        _readersBlocked = block;
+    }
+}
+
+
+void
+PkgResolverScheduler::blockInput( bool block )
+{
+    if ( block )
+        QCoreApplication::instance()->installEventFilter( this );
+    else
+        QCoreApplication::instance()->removeEventFilter( this );
+}
+
+
+bool
+PkgResolverScheduler::eventFilter( QObject * watchedObj, QEvent * event )
+{
+    if ( event )
+    {
+        switch ( event->type() )
+        {
+            // Only the events that start an action: If the matching
+            // release events of a press before the resolver run were
+            // dropped, buttons would remain pressed and drags would never
+            // end.
+
+            case QEvent::MouseButtonPress:
+            case QEvent::MouseButtonDblClick:
+            case QEvent::KeyPress:
+            case QEvent::Shortcut:
+            case QEvent::ShortcutOverride:
+                return true; // Might change the pool: Ignore
+
+            // Tooltips of pool items read the pool right away
+
+            case QEvent::ToolTip:
+            case QEvent::WhatsThis:
+            case QEvent::QueryWhatsThis:
+                return true;
+
+            default:
+                break;
+        }
+    }
+
+    return QObject::eventFilter( watchedObj, event );
+}
@@ -0,0 +1,238 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef PkgResolverScheduler_h
+#define PkgResolverScheduler_h
+
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+
+
+class QEvent;
+class YQPkgConflictDialog;
+
+
+/**
+ * Worker thread for one dependency resolver run: This only calls
+ * resolver()->resolvePool(). Everything that needs the GUI (showing the
+ * conflicts, updating the package lists) is done in the GUI thread when
+ * the inherited QThread::finished() signal arrives.
+ **/
+class PkgResolverWorker: public QThread
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor. Call start() to start the resolver run.
+     **/
+    PkgResolverWorker( QObject * parent = 0 );
+
+    /**
+     * Destructor. This waits for the thread to finish if it is still
+     * running; a resolver run cannot be interrupted.
+     **/
+    virtual ~PkgResolverWorker();
+
+    /**
+     * Return 'true' if the resolver run was successful, i.e. if there were
+     * no dependency problems.
+     *
+     * Only call this after the thread is finished.
+     **/
+    bool success() const { return _success; }
+
+    /**
+     * Return the duration of the resolver run.
+     *
+     * Only call this after the thread is finished.
+     **/
+    qint64 elapsedMillisec() const { return _elapsedMillisec; }
+
+
+protected:
+
+    /**
+     * The thread's main function.
+     *
+     * Reimplemented from QThread.
+     **/
+    virtual void run() override;
+
+
+    //
+    // Data members
+    //
+
+    bool   _success;
+    qint64 _elapsedMillisec;
+};
+
+
+/**
+ * Scheduler for automatic dependency resolver runs, i.e. for the runs after
+ * each status change in "Autocheck" mode.
+ *
+ * Requests are not handled immediately, but only after a short delay; if
+ * there is another request during that time, the delay starts again. So
+ * quickly changing the status of several packages results in only one
+ * resolver run.
+ *
+ * The resolver runs in a PkgResolverWorker thread, so the GUI still
+ * repaints (and shows a "resolving" message) during that time. Since
+ * libzypp is not thread-safe, nothing else may use the pool during that
+ * time:
+ *
+ * - Other worker threads that read the pool (see PoolReaderThread) are
+ *   interrupted, and the resolver only starts when they are finished; no
+ *   new ones are started until it is done.
+ *
+ * - User input (mouse clicks, keys, shortcuts) is blocked until the
+ *   resolver run is finished.
+ *
+ * - PoolStats and the package list (with the solvingStarted() and
+ *   solvingFinished() signals) use the values they cached before the
+ *   resolver run rather than reading the pool.
+ *
+ * If there is another request while the resolver is running, the result of
+ * that run is outdated: It is discarded, and the resolver runs again right
+ * away. Only the result of the latest run is passed to the conflict
+ * dialog which then shows any conflicts and notifies the package lists.
+ **/
+class PkgResolverScheduler: public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor. 'conflictDialog' receives the results of the resolver
+     * runs.
+     **/
+    PkgResolverScheduler( YQPkgConflictDialog * conflictDialog,
+                          QObject *             parent = 0 );
+
+    /**
+     * Destructor. This waits for a resolver run that is still in progress.
+     **/
+    virtual ~PkgResolverScheduler();
+
+    /**
+     * Return 'true' if the resolver is running in the worker thread.
+     **/
+    bool isSolving() const { return _worker != 0; }
+
+    /**
+     * Return 'true' if the resolver is running or if there is a pending
+     * request.
+     **/
+    bool isBusy() const
+        { return isSolving() || _delayTimer.isActive() || _readerWaitTimer.isActive(); }
+
+
+public slots:
+
+    /**
+     * Request a resolver run. This starts it after a short delay.
+     **/
+    void requestSolve();
+
+    /**
+     * Drop any pending request and wait for a resolver run in progress to
+     * finish; its result is discarded.
+     *
+     * Use this before running the resolver synchronously.
+     **/
+    void waitForIdle();
+
+
+signals:
+
+    /**
+     * Emitted right before a resolver run starts in the worker thread.
+     * Receivers must not read the pool from now on until solvingFinished()
+     * is emitted.
+     **/
+    void solvingStarted();
+
+    /**
+     * Emitted when a resolver run is finished, no matter if its result is
+     * used or discarded.
+     **/
+    void solvingFinished();
+
+
+protected slots:
+
+    /**
+     * Start a resolver run in the worker thread. If any pool reader threads
+     * are still active, this interrupts them and tries again a little
+     * later.
+     **/
+    void startSolving();
+
+    /**
+     * Handle the end of a resolver run.
+     **/
+    void workerFinished();
+
+
+protected:
+
+    /**
+     * Event filter for the application while the resolver is running:
+     * Block user input.
+     *
+     * Reimplemented from QObject.
+     **/
+    virtual bool eventFilter( QObject * watchedObj, QEvent * event ) override;
+
+    /**
+     * Block or unblock user input for the whole application.
+     **/
+    void blockInput( bool block );
+
+    /**
+     * Block or unblock starting new pool reader threads.
+     **/
+    void blockReaders( bool block );
+
+    /**
+     * Clean up after a resolver run: Allow input and pool readers again
+     * and tell the receivers of solvingStarted() that they may read the
+     * pool again.
+     **/
+    void solvingDone();
+
+
+    //
+    // Data members
+    //
+
+    YQPkgConflictDialog * _conflictDialog;
+    QTimer                _delayTimer;
+    QTimer                _readerWaitTimer;
+    PkgResolverWorker *   _worker;
+    bool                  _readersBlocked;
+    bool                  _pendingRequest;
+    int                   _requestCount;
+};
+
+
+#endif // PkgResolverScheduler_h
@@ -0,0 +1,308 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#include <algorithm>
+#include <iterator>     // std::back_inserter()
+#include <set>
+
+#include <QElapsedTimer>
+
+#include <zypp/Package.h>
+#include <zypp/sat/Pool.h>
+
+#include "Logger.h"
+#include "SearchFilter.h"
+#include "utf8.h"
+#include "PkgSearchIndex.h"
+
+
+PkgSearchIndex::PkgSearchIndex()
+{
+    // NOP
+}
+
+
+PkgSearchIndex::~PkgSearchIndex()
+{
+    // NOP
+}
+
+
+void
+PkgSearchIndex::clear()
+{
+    _solvables.clear();
+    _postings.clear();
+}
+
+
+bool
+PkgSearchIndex::isUpToDate() const
+{
+    return ! isEmpty() && _poolSerial.isClean( zypp::sat::Pool::instance().serial() );
+}
+
+
+void
+PkgSearchIndex::build()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    clear();
+
+    zypp::sat::Pool pool = zypp::sat::Pool::instance();
+    _poolSerial.remember( pool.serial() );
+
+    for ( zypp::sat::Pool::SolvableIterator it = pool.solvablesBegin();
+          it != pool.solvablesEnd();
+          ++it )
+    {
+        zypp::sat::Solvable solvable = *it;
+
+        if ( ! solvable.isKind<zypp::Package>() )
+            continue;
+
+        Entry entry = (Entry) _solvables.size();
+        _solvables.push_back( solvable );
+
+        addText( entry, solvable.name()    );
+        addText( entry, solvable.summary() );
+    }
+
+    logInfo() << "Search index for " << _solvables.size() << " packages with "
+              << _postings.size() << " trigrams built in "
+              << timer.elapsed() << " millisec" << endl;
+}
+
+
+void
+PkgSearchIndex::addText( Entry entry, const std::string & text )
+{
+    if ( text.size() < 3 )
+        return;
+
+    std::string folded = fold( text );
+
+    for ( size_t i = 0; i + 3 <= folded.size(); ++i )
+    {
+        QVector<Entry> & entries = _postings[ trigram( folded.data() + i ) ];
+
+        // Entries are added in ascending order, so a duplicate from the same
+        // text or from name and summary can only be the last one.
+
+        if ( entries.isEmpty() || entries.last() != entry )
+            entries.append( entry );
+    }
+}
+
+
+std::string
+PkgSearchIndex::fold( const std::string & text )
+{
+    std::string folded( text );
+
+    for ( char & c: folded )
+    {
+        if ( c >= 'A' && c <= 'Z' )
+            c += 'a' - 'A';
+    }
+
+    return folded;
+}
+
+
+std::vector<std::string>
+PkgSearchIndex::literals( const SearchFilter & searchFilter )
+{
+    std::vector<std::string> result;
+    std::string pattern = toUTF8( searchFilter.pattern() );
+
+    switch ( searchFilter.filterMode() )
+    {
+        case SearchFilter::Contains:
+        case SearchFilter::StartsWith:
+            if ( pattern.size() >= 3 )
+                result.push_back( pattern );
+            break;
+
+        case SearchFilter::Wildcard:
+            {
+                // Split the pattern at the wildcard characters and skip
+                // character classes like [abc]: What remains are the fixed
+                // strings that every match must contain.
+
+                std::string literal;
+                bool inCharClass = false;
+
+                for ( char c: pattern )
+                {
+                    bool special = inCharClass || c == '*' || c == '?' || c == '[' || c == '\\';
+
+                    if ( c == '[' )
+                        inCharClass = true;
+                    else if ( c == ']' && inCharClass )
+                        inCharClass = false;
+
+                    if ( special )
+                    {
+                        if ( literal.size() >= 3 )
+                            result.push_back( literal );
+
+                        literal.clear();
+                    }
+                    else
+                    {
+                        literal += c;
+                    }
+                }
+
+                if ( literal.size() >= 3 )
+                    result.push_back( literal );
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return result;
+}
+
+
+bool
+PkgSearchIndex::canSearch( const SearchFilter & searchFilter ) const
+{
+    if ( isEmpty() )
+        return false;
+
+    std::vector<std::string> fixedStrings = literals( searchFilter );
+
+    if ( fixedStrings.empty() )
+        return false;
+
+    // Only ASCII letters are folded to lowercase in the index, so any other
+    // uppercase letters might not be found in case-insensitive mode.
+
+    for ( const std::string & str: fixedStrings )
+    {
+        for ( char c: str )
+        {
+            if ( (unsigned char) c >= 0x80 )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+QVector<PkgSearchIndex::Entry>
+PkgSearchIndex::candidates( const std::vector<std::string> & fixedStrings ) const
+{
+    QVector<const QVector<Entry> *> lists;
+
+    for ( const std::string & str: fixedStrings )
+    {
+        std::string folded = fold( str );
+
+        for ( size_t i = 0; i + 3 <= folded.size(); ++i )
+        {
+            QHash<Trigram, QVector<Entry> >::const_iterator it =
+                _postings.constFind( trigram( folded.data() + i ) );
+
+            if ( it == _postings.constEnd() )   // Trigram not in any package
+                return QVector<Entry>();
+
+            lists.append( &it.value() );
+        }
+    }
+
+    if ( lists.isEmpty() )
+        return QVector<Entry>();
+
+    // Start with the shortest list: The intersection can only get shorter.
+
+    std::sort( lists.begin(), lists.end(),
+               []( const QVector<Entry> * a, const QVector<Entry> * b )
+               {
+                   return a->size() < b->size();
+               } );
+
+    QVector<Entry> result = *lists.first();
+
+    for ( int i = 1; i < lists.size() && ! result.isEmpty(); ++i )
+    {
+        QVector<Entry> intersection;
+
+        std::set_intersection( result.constBegin(),      result.constEnd(),
+                               lists[i]->constBegin(),   lists[i]->constEnd(),
+                               std::back_inserter( intersection ) );
+        result.swap( intersection );
+    }
+
+    return result;
+}
+
+
+std::vector<zypp::sat::Solvable>
+PkgSearchIndex::findSolvables( const SearchFilter & searchFilter,
+                               bool                 inName,
+                               bool                 inSummary ) const
+{
+    std::vector<zypp::sat::Solvable> result;
+
+    if ( ! inName && ! inSummary )
+        return result;
+
+    const QVector<Entry> entries = candidates( literals( searchFilter ) );
+
+    for ( Entry entry: entries )
+    {
+        const zypp::sat::Solvable & solvable = _solvables[ entry ];
+
+        if ( ( inName    && searchFilter.matches( solvable.name()    ) ) ||
+             ( inSummary && searchFilter.matches( solvable.summary() ) )   )
+        {
+            result.push_back( solvable );
+        }
+    }
+
+    return result;
+}
+
+
+QVector<ZyppSel>
+PkgSearchIndex::find( const SearchFilter & searchFilter,
+                      bool                 inName,
+                      bool                 inSummary ) const
+{
+    QVector<ZyppSel>  result;
+    std::set<ZyppSel> found;
+
+    for ( const zypp::sat::Solvable & solvable: findSolvables( searchFilter, inName, inSummary ) )
+    {
+        ZyppSel selectable = zypp::ui::Selectable::get( solvable );
+
+        if ( selectable && ! contains( found, selectable ) )
+        {
+            found.insert( selectable );
+            result.append( selectable );
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,177 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef PkgSearchIndex_h
+#define PkgSearchIndex_h
+
+
+#include <string>
+#include <vector>
+
+#include <QHash>
+#include <QVector>
+
+#include <zypp/base/SerialNumber.h>
+#include <zypp/sat/Solvable.h>
+
+#include "YQZypp.h"
+
+
+class SearchFilter;
+
+
+/**
+ * In-memory trigram index over the names and summaries of all package
+ * solvables in the pool.
+ *
+ * For each sequence of 3 consecutive characters (a trigram) that occurs in
+ * any name or summary, this keeps a sorted list of the solvables that
+ * contain it. A search for a fixed string then only needs to intersect the
+ * lists for the trigrams of that string and check the few remaining
+ * candidates with SearchFilter::matches(), rather than scanning every
+ * string of every solvable like a zypp::PoolQuery does.
+ *
+ * This works for the "Contains" and "StartsWith" filter modes and for
+ * "Wildcard" if the pattern has a fixed part of at least 3 characters.
+ * Everything else (short patterns, regular expressions, non-ASCII
+ * patterns, other attributes like description or file list) still needs a
+ * PoolQuery; use canSearch() to check.
+ *
+ * Case-insensitive matching is done by folding ASCII letters to lowercase
+ * in the index; the final check with the SearchFilter takes care of case
+ * sensitive searches.
+ *
+ * The index refers to the solvables by their IDs, so it becomes invalid
+ * when the content of the pool changes, e.g. when repos are reloaded or
+ * when the target is reloaded after a commit. Check with isUpToDate()
+ * before using it.
+ **/
+class PkgSearchIndex
+{
+public:
+
+    /**
+     * Constructor. This creates an empty index; call build() to fill it.
+     **/
+    PkgSearchIndex();
+
+    /**
+     * Destructor.
+     **/
+    virtual ~PkgSearchIndex();
+
+    /**
+     * Build the index from all package solvables in the zypp pool.
+     * This clears any previous content.
+     **/
+    void build();
+
+    /**
+     * Clear the index.
+     **/
+    void clear();
+
+    /**
+     * Return 'true' if the index is empty.
+     **/
+    bool isEmpty() const { return _solvables.empty(); }
+
+    /**
+     * Return the number of solvables in the index.
+     **/
+    int size() const { return (int) _solvables.size(); }
+
+    /**
+     * Return 'true' if the index was built and the pool did not change
+     * since then.
+     **/
+    bool isUpToDate() const;
+
+    /**
+     * Return 'true' if this index can be used to search for
+     * 'searchFilter', 'false' if a PoolQuery is needed.
+     **/
+    bool canSearch( const SearchFilter & searchFilter ) const;
+
+    /**
+     * Return the package solvables whose name (if 'inName' is 'true') or
+     * summary (if 'inSummary' is 'true') matches 'searchFilter'.
+     *
+     * Check with canSearch() first if the index can be used at all.
+     **/
+    std::vector<zypp::sat::Solvable> findSolvables( const SearchFilter & searchFilter,
+                                                    bool                 inName,
+                                                    bool                 inSummary ) const;
+
+    /**
+     * Return the selectables for the solvables that findSolvables() would
+     * return, without duplicates.
+     **/
+    QVector<ZyppSel> find( const SearchFilter & searchFilter,
+                           bool                 inName,
+                           bool                 inSummary ) const;
+
+
+protected:
+
+    typedef quint32 Trigram;
+    typedef quint32 Entry;      // Index in _solvables
+
+    /**
+     * Add the trigrams of 'text' for 'entry'.
+     **/
+    void addText( Entry entry, const std::string & text );
+
+    /**
+     * Return the candidate entries that contain all trigrams of all of
+     * 'literals'. Those still need to be checked with the SearchFilter.
+     **/
+    QVector<Entry> candidates( const std::vector<std::string> & literals ) const;
+
+    /**
+     * Return the fixed strings that any match of 'searchFilter' must
+     * contain. Only those with at least 3 characters are returned since
+     * they are the only ones that are useful for the index.
+     **/
+    static std::vector<std::string> literals( const SearchFilter & searchFilter );
+
+    /**
+     * Return 'text' with all ASCII letters converted to lowercase.
+     **/
+    static std::string fold( const std::string & text );
+
+    /**
+     * Return the trigram of the 3 characters starting at 'chars'.
+     **/
+    static Trigram trigram( const char * chars )
+    {
+        return ( ( (Trigram) (unsigned char) chars[0] ) << 16 ) |
+               ( ( (Trigram) (unsigned char) chars[1] ) <<  8 ) |
+                   (Trigram) (unsigned char) chars[2];
+    }
+
+
+    //
+    // Data members
+    //
+
+    std::vector<zypp::sat::Solvable> _solvables;
+    QHash<Trigram, QVector<Entry> >  _postings;
+    zypp::SerialNumberWatcher        _poolSerial;
+};
+
+
+#endif // PkgSearchIndex_h
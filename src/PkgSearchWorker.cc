@@ -0,0 +1,170 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+#include <zypp/sat/Pool.h>
+
+#include "Logger.h"
+#include "utf8.h"
+#include "PkgSearchWorker.h"
+
+
+// Minimum time between two resultsReady() signals
+#define NOTIFY_INTERVAL_MILLISEC        100
+
+
+PkgSearchWorker::PkgSearchWorker( const zypp::PoolQuery & query,
+                                  QObject *               parent )
+    : PoolReaderThread( parent )
+    , _query( query )
+    , _matchCount( 0 )
+{
+    // NOP
+}
+
+
+PkgSearchWorker::~PkgSearchWorker()
+{
+    wait();
+}
+
+
+QVector<ZyppSel>
+PkgSearchWorker::takeResults()
+{
+    QMutexLocker locker( &_mutex );
+
+    QVector<ZyppSel> results;
+    results.swap( _results );
+
+    return results;
+}
+
+
+void
+PkgSearchWorker::readPool()
+{
+    QElapsedTimer notifyTimer;
+    notifyTimer.start();
+
+    QSet<const zypp::ui::Selectable *> found;
+
+    try
+    {
+        if ( ! _query.repos().empty() )
+        {
+            // Already restricted to some repos by the caller
+            searchQuery( _query, found, notifyTimer );
+        }
+        else
+        {
+            // The query only returns at the next match, and one with very
+            // few matches might scan the whole pool until then, e.g. in all
+            // file lists. Query each repo separately so the search can
+            // stop at least between them when it is interrupted.
+
+            const zypp::sat::Pool & pool = zypp::sat::Pool::instance();
+
+            for ( zypp::sat::Pool::RepositoryIterator it = pool.reposBegin();
+                  it != pool.reposEnd();
+                  ++it )
+            {
+                zypp::PoolQuery repoQuery( _query );
+                repoQuery.addRepo( it->alias() );
+
+                if ( ! searchQuery( repoQuery, found, notifyTimer ) )
+                    break;
+            }
+        }
+    }
+    catch ( const std::exception & exception )
+    {
+        logWarning() << "CAUGHT zypp exception: " << exception.what() << endl;
+        _errorMessage = fromUTF8( exception.what() );
+    }
+
+    // The rest of the results is picked up when the finished() signal
+    // arrives in the GUI thread.
+}
+
+
+bool
+PkgSearchWorker::searchQuery( const zypp::PoolQuery &              query,
+                              QSet<const zypp::ui::Selectable *> & found,
+                              QElapsedTimer &                      notifyTimer )
+{
+    if ( isInterruptionRequested() )
+    {
+        logDebug() << "Search canceled after "
+                   << _matchCount.loadRelaxed() << " matches" << endl;
+        return false;
+    }
+
+    for ( zypp::PoolQuery::Selectable_iterator it = query.selectableBegin();
+          it != query.selectableEnd();
+          ++it )
+    {
+        if ( isInterruptionRequested() )
+        {
+            logDebug() << "Search canceled after "
+                       << _matchCount.loadRelaxed() << " matches" << endl;
+            return false;
+        }
+
+        ZyppSel selectable = *it;
+
+        // A selectable may have packages in several repos
+        if ( found.contains( selectable.get() ) )
+            continue;
+
+        found.insert( selectable.get() );
+
+        if ( ! tryCastToZyppPkg( selectable->theObj() ) )
+            continue;
+
+        {
+            QMutexLocker locker( &_mutex );
+            _results.append( selectable );
+        }
+
+        _matchCount.fetchAndAddRelaxed( 1 );
+
+        if ( notifyTimer.elapsed() > NOTIFY_INTERVAL_MILLISEC )
+        {
+            notifyResults();
+            notifyTimer.restart();
+        }
+    }
+
+    return true;
+}
+
+
+void
+PkgSearchWorker::notifyResults()
+{
+    bool haveResults;
+
+    {
+        QMutexLocker locker( &_mutex );
+        haveResults = ! _results.isEmpty();
+    }
+
+    if ( haveResults )
+        emit resultsReady();
+}
@@ -0,0 +1,151 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef PkgSearchWorker_h
+#define PkgSearchWorker_h
+
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include <zypp/PoolQuery.h>
+
+#include "PoolReaderThread.h"
+#include "YQZypp.h"
+
+
+/**
+ * Worker thread to iterate over the results of a zypp::PoolQuery without
+ * blocking the GUI thread.
+ *
+ * The matching packages are collected in batches; the resultsReady()
+ * signal tells the GUI thread to fetch the current batch with
+ * takeResults(). When the query is done, the inherited QThread::finished()
+ * signal is emitted; there may still be some results to fetch then.
+ *
+ * Use QThread::requestInterruption() to cancel the query. The thread then
+ * stops at the next search result. Since it might still take a moment
+ * until that happens, don't wait for it in the GUI thread; just disconnect
+ * all signals and let the thread delete itself:
+ *
+ *     worker->disconnect( this );
+ *     worker->requestInterruption();
+ *     connect( worker, SIGNAL( finished() ), worker, SLOT( deleteLater() ) );
+ *
+ * The query doesn't change the package status, but it is not a pure
+ * read-only access to the pool either: Searching descriptions or file lists
+ * makes libzypp load that repodata into the pool on demand. So it must not
+ * run at the same time as the dependency resolver or a repo reload; see
+ * PoolReaderThread for how that is prevented. Owners must check
+ * PoolReaderThread::canStart() before creating a worker, and a worker that
+ * was interrupted without the owner requesting it should be restarted
+ * later: Its results are incomplete.
+ **/
+class PkgSearchWorker: public PoolReaderThread
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor. 'query' should be completely set up.
+     * Call start() to start the query.
+     **/
+    PkgSearchWorker( const zypp::PoolQuery & query,
+                     QObject *               parent = 0 );
+
+    /**
+     * Destructor. This waits for the thread to finish if it is still
+     * running, so call requestInterruption() first.
+     **/
+    virtual ~PkgSearchWorker();
+
+    /**
+     * Return the results that were found since the last call and remove
+     * them from the worker.
+     *
+     * This is thread-safe; it is intended to be called from the GUI thread
+     * while the worker thread is still searching.
+     **/
+    QVector<ZyppSel> takeResults();
+
+    /**
+     * Return the total number of matches so far.
+     **/
+    int matchCount() const { return _matchCount.loadRelaxed(); }
+
+    /**
+     * Return the error message if the query failed (e.g. because of a
+     * syntax error in a regular expression) or an empty string if there
+     * was no error.
+     *
+     * Only call this after the thread is finished.
+     **/
+    const QString & errorMessage() const { return _errorMessage; }
+
+
+signals:
+
+    /**
+     * Emitted when there are new results to fetch with takeResults().
+     * To avoid flooding the GUI thread with events, this is not sent for
+     * every single result, but at most every few milliseconds.
+     **/
+    void resultsReady();
+
+
+protected:
+
+    /**
+     * Iterate over the query results. This is executed in the worker
+     * thread.
+     *
+     * Implemented from PoolReaderThread.
+     **/
+    virtual void readPool() override;
+
+    /**
+     * Iterate over the results of 'query' and add the selectables that
+     * are not yet in 'found' to the results. Return 'false' if the search
+     * was interrupted.
+     **/
+    bool searchQuery( const zypp::PoolQuery &              query,
+                      QSet<const zypp::ui::Selectable *> & found,
+                      QElapsedTimer &                      notifyTimer );
+
+    /**
+     * Emit resultsReady() if there are any results.
+     **/
+    void notifyResults();
+
+
+    //
+    // Data members
+    //
+
+    zypp::PoolQuery  _query;
+    QMutex           _mutex;    // protects _results
+    QVector<ZyppSel> _results;
+    QAtomicInt       _matchCount;
+    QString          _errorMessage;
+};
+
+
+#endif // PkgSearchWorker_h
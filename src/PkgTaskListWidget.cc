@@ -21,8 +21,18 @@
 
 void PkgTaskListWidget::addTaskItems( const PkgTaskList & taskList )
 {
+    if ( taskList.isEmpty() )
+        return;
+
+    // Don't scroll and repaint for each item; this might be many thousands.
+
+    beginBatch();
+    _taskItems.reserve( _taskItems.size() + taskList.size() );
+
     for ( PkgTask * task: taskList )
         addTaskItem( task );
+
+    endBatch();
 }
 
 
@@ -32,7 +42,11 @@ PkgTaskListWidget::addTaskItem( PkgTask * task )
     PkgTaskListWidgetItem * item = new PkgTaskListWidgetItem( task, this );
     CHECK_NEW( item );
 
-    if ( _autoScrollToLast )
+    _taskItems.insert( task, item );
+
+    if ( inBatch() )
+        _batchAddedItems = true;
+    else if ( _autoScrollToLast )
         scrollToItem( item, QAbstractItemView::PositionAtBottom );
 
     return item;
@@ -42,22 +56,13 @@ PkgTaskListWidget::addTaskItem( PkgTask * task )
 PkgTaskListWidgetItem *
 PkgTaskListWidget::findTaskItem( PkgTask * task ) const
 {
-    for ( int row=0; row < count(); ++row )
-    {
-        PkgTaskListWidgetItem * it =
-            dynamic_cast<PkgTaskListWidgetItem *>( item( row ) );
-
-        if ( it && it->task() == task )
-            return it;
-    }
-
-    return 0;
+    return _taskItems.value( task, 0 );
 }
 
 
 void PkgTaskListWidget::removeTaskItem( PkgTask * task )
 {
-    PkgTaskListWidgetItem * item = findTaskItem( task );
+    PkgTaskListWidgetItem * item = _taskItems.take( task );
 
     if ( item )
     {
@@ -71,6 +76,47 @@ void PkgTaskListWidget::removeTaskItem( PkgTask * task )
 }
 
 
+void PkgTaskListWidget::clear()
+{
+    _taskItems.clear();
+    QListWidget::clear();
+}
+
+
+void PkgTaskListWidget::beginBatch()
+{
+    if ( _batchLevel++ == 0 )
+    {
+        _batchAddedItems = false;
+        setUpdatesEnabled( false );
+    }
+}
+
+
+void PkgTaskListWidget::endBatch()
+{
+    if ( _batchLevel <= 0 )
+    {
+        logError() << "endBatch() without beginBatch()" << endl;
+        return;
+    }
+
+    if ( --_batchLevel > 0 )
+        return;
+
+    setUpdatesEnabled( true );
+
+    // The last added item is the last one in the list if the list is sorted
+    // by insertion sequence; otherwise autoscrolling doesn't make much sense
+    // anyway.
+
+    if ( _batchAddedItems && _autoScrollToLast )
+        scrollToBottom();
+
+    _batchAddedItems = false;
+}
+
+
 
 
 PkgTaskListWidgetItem::PkgTaskListWidgetItem( PkgTask *           task,
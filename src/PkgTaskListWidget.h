@@ -18,6 +18,7 @@
 #define PkgTaskListWidget_h
 
 
+#include <QHash>
 #include <QListWidget>
 #include "PkgTasks.h"
 
@@ -26,6 +27,14 @@ class PkgTaskListWidgetItem;
 
 /**
  * A QListWidget specialized for PkgTasks.
+ *
+ * This keeps a hash of the items by task, so finding or removing the item
+ * for a task doesn't need to go through all the items. That happens for
+ * each package during a package commit, and the lists may have many
+ * thousands of items.
+ *
+ * Use only addTaskItem(), removeTaskItem() and clear() to add and remove
+ * task items so that hash stays consistent.
  **/
 class PkgTaskListWidget: public QListWidget
 {
@@ -38,12 +47,14 @@ public:
         , _nextSerial( 0 )
         , _sortByInsertionSequence( true )
         , _autoScrollToLast( true )
+        , _batchLevel( 0 )
+        , _batchAddedItems( false )
         {}
 
     virtual ~PkgTaskListWidget() {}
 
     /**
-     * Clear all existing items and Add all tasks from 'taskList'.
+     * Add items for all tasks from 'taskList'.
      **/
     void addTaskItems( const PkgTaskList & taskList );
 
@@ -65,6 +76,13 @@ public:
      **/
     PkgTaskListWidgetItem * findTaskItem( PkgTask * task ) const;
 
+    /**
+     * Remove and delete all items.
+     *
+     * This hides QListWidget::clear() which is not virtual.
+     **/
+    void clear();
+
     /**
      * Return 'true' if the sort order should always be the item insertion
      * order, 'false' if default sort order.
@@ -94,12 +112,35 @@ public:
      **/
     void setAutoScrollToLast( bool val ) { _autoScrollToLast = val; }
 
+    /**
+     * Start a batch of changes: Until the matching endBatch(), the widget
+     * is not repainted, and it is not scrolled for each added item.
+     *
+     * Batches can be nested; only the outermost endBatch() has an effect.
+     **/
+    void beginBatch();
+
+    /**
+     * End a batch of changes: Repaint the widget and scroll to the last
+     * item once if any items were added and autoScrollToLast() is set.
+     **/
+    void endBatch();
+
+    /**
+     * Return 'true' if a batch of changes is in progress.
+     **/
+    bool inBatch() const { return _batchLevel > 0; }
+
 
 protected:
 
     int  _nextSerial;
     bool _sortByInsertionSequence;
     bool _autoScrollToLast;
+    int  _batchLevel;
+    bool _batchAddedItems;
+
+    QHash<PkgTask *, PkgTaskListWidgetItem *> _taskItems;
 };
 
 
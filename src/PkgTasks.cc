@@ -109,8 +109,8 @@ LogStream & operator<<( LogStream & str, PkgTask * task )
 
 
 PkgTaskList::PkgTaskList( const QString & listName )
-        : QList<PkgTask *>()
-        , _name( listName )
+        : _name( listName )
+        , _holes( 0 )
 {
 }
 
@@ -125,6 +125,19 @@ PkgTaskList::find( const QString &  name,
                    PkgTaskAction    action,
                    PkgTaskRequester requester ) const
 {
+    if ( ! name.isEmpty() )
+    {
+        zypp::IdString::IdType key = zypp::IdString( name.toUtf8().constData() ).id();
+
+        for ( auto it = _index.constFind( key ); it != _index.constEnd() && it.key() == key; ++it )
+        {
+            if ( it.value()->matches( name, action, requester ) )
+                return it.value();
+        }
+
+        return 0;
+    }
+
     for ( PkgTask * task: *this )
     {
         if ( task && task->matches( name, action, requester ) )
@@ -138,28 +151,163 @@ PkgTaskList::find( const QString &  name,
 PkgTask *
 PkgTaskList::find( const PkgTask & filter ) const
 {
-    for ( PkgTask * task: *this )
-    {
-        if ( task && task->matches( filter ) )
-            return task;
-    }
-
-    return 0;
+    return find( filter.name(), filter.action(), filter.requester() );
 }
 
 
 PkgTask *
 PkgTaskList::find( ZyppRes zyppRes ) const
 {
-    QString resName = fromUTF8( zyppRes->name() );
+    return find( zyppRes->ident() );
+}
 
-    for ( PkgTask * task: *this )
+
+PkgTask *
+PkgTaskList::find( zypp::IdString ident ) const
+{
+    return _index.value( ident.id(), 0 );
+}
+
+
+bool
+PkgTaskList::contains( PkgTask * task ) const
+{
+    return task && _positions.contains( task );
+}
+
+
+PkgTask *
+PkgTaskList::at( int index ) const
+{
+    compact();
+
+    return _tasks.at( index );
+}
+
+
+PkgTaskList::const_iterator
+PkgTaskList::begin() const
+{
+    compact();
+
+    return _tasks.cbegin();
+}
+
+
+PkgTaskList::const_iterator
+PkgTaskList::end() const
+{
+    compact();
+
+    return _tasks.cend();
+}
+
+
+void
+PkgTaskList::append( PkgTask * task )
+{
+    CHECK_PTR( task );
+
+    // A list that gets tasks appended and taken all the time (like the
+    // downloads list) might never be iterated over: Don't let the holes
+    // pile up.
+
+    if ( _holes > _tasks.size() / 2 )
+        compact();
+
+    _positions.insert( task, _tasks.size() );
+    _tasks.append( task );
+    _index.insert( task->ident().id(), task );
+}
+
+
+void
+PkgTaskList::append( const PkgTaskList & other )
+{
+    reserve( size() + other.size() );
+
+    for ( PkgTask * task: other )
+        append( task );
+}
+
+
+PkgTask *
+PkgTaskList::takeAt( int index )
+{
+    PkgTask * task = at( index );
+    take( task );
+
+    return task;
+}
+
+
+bool
+PkgTaskList::take( PkgTask * task )
+{
+    if ( ! task )
+        return false;
+
+    auto it = _positions.find( task );
+
+    if ( it == _positions.end() )
+        return false;
+
+    // Don't move all the tasks behind this one now; just leave a hole.
+
+    _tasks[ it.value() ] = 0;
+    _positions.erase( it );
+    _index.remove( task->ident().id(), task );
+    ++_holes;
+
+    return true;
+}
+
+
+void
+PkgTaskList::compact() const
+{
+    if ( _holes == 0 )
+        return;
+
+    int newPos = 0;
+
+    for ( int pos = 0; pos < _tasks.size(); ++pos )
     {
-        if ( task && task->name() == resName )
-            return task;
+        PkgTask * task = _tasks.at( pos );
+
+        if ( task )
+        {
+            if ( pos != newPos )
+            {
+                _tasks[ newPos ] = task;
+                _positions[ task ] = newPos;
+            }
+
+            ++newPos;
+        }
     }
 
-    return 0;
+    _tasks.resize( newPos );
+    _holes = 0;
+}
+
+
+void
+PkgTaskList::clear()
+{
+    _tasks.clear();
+    _positions.clear();
+    _index.clear();
+    _holes = 0;
+}
+
+
+void
+PkgTaskList::reserve( int size )
+{
+    _tasks.reserve( size );
+    _positions.reserve( size );
+    _index.reserve( size );
 }
 
 
@@ -230,7 +378,11 @@ void PkgTaskList::sort()
     // We need a functor here; an PkgTask::operator<( PkgTask * other ) is
     // ignored, std::sort() just compares the pointer values (!) in that case.
 
-    std::sort( begin(), end(), compareFunctor );
+    compact();
+    std::sort( _tasks.begin(), _tasks.end(), compareFunctor );
+
+    for ( int pos = 0; pos < _tasks.size(); ++pos )
+        _positions[ _tasks.at( pos ) ] = pos;
 }
 
 
@@ -284,15 +436,13 @@ void PkgTasks::moveTask( PkgTask *      task,
                          PkgTaskList &  fromList,
                          PkgTaskList &  toList )
 {
-    int index = fromList.indexOf( task );
-
-    if ( index < 0 )
+    if ( ! fromList.take( task ) )
     {
         logError() << "Task " << task->name() << " not found in this list" << endl;
         return;
     }
 
-    toList.append( fromList.takeAt( index ) );
+    toList.append( task );
 }
 
 
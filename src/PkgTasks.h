@@ -20,9 +20,12 @@
 
 #include <QString>
 #include <QList>
+#include <QHash>
+#include <QMultiHash>
 #include <QMutex>
 
 #include <zypp-core/ByteCount.h>
+#include <zypp/IdString.h>
 #include "Logger.h"     // LogStream
 #include "YQZypp.h"     // ZyppRes
 
@@ -92,6 +95,7 @@ public:
              PkgTaskAction    pkgAction,
              PkgTaskRequester requester ) // PkgReqUser or PkgReqDep
         : _name( pkgName )
+        , _ident( pkgName.toUtf8().constData() )
         , _action( pkgAction )
         , _requester( requester )
         , _downloadSize ( -1.0 )
@@ -105,6 +109,13 @@ public:
      **/
     const QString & name() const { return _name; }
 
+    /**
+     * Return the package name as a zypp IdString. This is the same as the
+     * ident() of the zypp resolvables of that package, so it can be used to
+     * find the task for a resolvable without any string conversion.
+     **/
+    zypp::IdString ident() const { return _ident; }
+
     /**
      * Return the action that is to do or done: Install, update, remove.
      **/
@@ -205,6 +216,7 @@ public:
 protected:
 
     QString          _name;
+    zypp::IdString   _ident;
     PkgTaskAction    _action;
     PkgTaskRequester _requester;
 
@@ -217,11 +229,24 @@ protected:
 
 /**
  * A list of package tasks.
+ *
+ * In addition to the list itself, this keeps a hash index of the tasks by
+ * package name so the tasks for the resolvables in the libzypp commit
+ * callbacks can be found without scanning the whole list: During a large
+ * transaction, each package gets a number of those callbacks.
+ *
+ * It also keeps the position of each task in the list, so removing a task
+ * (which happens for every task in every stage of the transaction, in the
+ * order that libzypp chooses) is cheap: That only leaves a hole in the
+ * list. The holes are removed all at once the next time the list is
+ * accessed by position or iterated over.
  **/
-class PkgTaskList: public QList<PkgTask *>
+class PkgTaskList
 {
 public:
 
+    typedef QList<PkgTask *>::const_iterator const_iterator;
+
     /**
      * Constructor.
      **/
@@ -252,13 +277,91 @@ public:
     PkgTask * find( const PkgTask & filter ) const;
 
     /**
-     * Find the first task where the name matches the name of the 'zyppRes'
-     * Zypp resolvable.
+     * Find the task where the name matches the name of the 'zyppRes'
+     * Zypp resolvable. This uses the hash index, so it is cheap even for
+     * very long lists.
      *
      * Return the task if found, 0 if not found.
      **/
     PkgTask * find( ZyppRes zyppRes ) const;
 
+    /**
+     * Find a task for the package with the name 'ident'. If there is more
+     * than one (which normally doesn't happen), this returns any of them.
+     *
+     * Return the task if found, 0 if not found.
+     **/
+    PkgTask * find( zypp::IdString ident ) const;
+
+    /**
+     * Return 'true' if 'task' is in this list.
+     **/
+    bool contains( PkgTask * task ) const;
+
+    /**
+     * Return the number of tasks in this list.
+     **/
+    int size() const { return _tasks.size() - _holes; }
+
+    /**
+     * Return 'true' if this list is empty.
+     **/
+    bool isEmpty() const { return size() == 0; }
+
+    /**
+     * Return the task at position 'index'.
+     **/
+    PkgTask * at( int index ) const;
+
+    /**
+     * Iterators over the tasks.
+     **/
+    const_iterator begin() const;
+    const_iterator end()   const;
+
+    /**
+     * Append 'task' to the list.
+     **/
+    void append( PkgTask * task );
+
+    /**
+     * Append all tasks of 'other' to the list.
+     **/
+    void append( const PkgTaskList & other );
+
+    /**
+     * Append 'task' to the list.
+     **/
+    PkgTaskList & operator<<( PkgTask * task )
+        { append( task ); return *this; }
+
+    /**
+     * Append all tasks of 'other' to the list.
+     **/
+    PkgTaskList & operator<<( const PkgTaskList & other )
+        { append( other ); return *this; }
+
+    /**
+     * Remove the task at 'index' from the list and return it.
+     **/
+    PkgTask * takeAt( int index );
+
+    /**
+     * Remove 'task' from the list. Return 'true' if it was found,
+     * 'false' if not.
+     **/
+    bool take( PkgTask * task );
+
+    /**
+     * Remove all tasks from the list. This does not delete them.
+     **/
+    void clear();
+
+    /**
+     * Reserve space for 'size' tasks.
+     **/
+    void reserve( int size );
+
     /**
      * Return a new list from origList filtered by action and requester.
      *
@@ -294,7 +397,22 @@ public:
 
 protected:
 
-    QString _name;
+    /**
+     * Remove the holes that take() left in the list and update the
+     * positions of the tasks behind them.
+     **/
+    void compact() const;
+
+
+    QString                                       _name;
+    QMultiHash<zypp::IdString::IdType, PkgTask *> _index;
+
+    // Compacting doesn't change the content of the list,
+    // so it can be done in const functions.
+
+    mutable QList<PkgTask *>                      _tasks;
+    mutable QHash<PkgTask *, int>                 _positions;
+    mutable int                                   _holes;
 };
 
 
@@ -0,0 +1,143 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+#include "Logger.h"
+#include "PoolReaderThread.h"
+
+
+QMutex                     PoolReaderThread::_mutex;
+QList<PoolReaderThread *>  PoolReaderThread::_activeReaders;
+int                        PoolReaderThread::_blockCount = 0;
+
+
+PoolReaderThread::PoolReaderThread( QObject * parent )
+    : QThread( parent )
+{
+    QMutexLocker locker( &_mutex );
+    _activeReaders << this;
+}
+
+
+PoolReaderThread::~PoolReaderThread()
+{
+    wait();
+    unregister(); // In case it was never started
+}
+
+
+void
+PoolReaderThread::run()
+{
+    readPool();
+    unregister();
+}
+
+
+void
+PoolReaderThread::unregister()
+{
+    QMutexLocker locker( &_mutex );
+    _activeReaders.removeOne( this );
+}
+
+
+int
+PoolReaderThread::activeCount()
+{
+    QMutexLocker locker( &_mutex );
+
+    return _activeReaders.size();
+}
+
+
+bool
+PoolReaderThread::canStart()
+{
+    return _blockCount == 0 && activeCount() == 0;
+}
+
+
+void
+PoolReaderThread::interruptAll()
+{
+    QMutexLocker locker( &_mutex );
+
+    if ( ! _activeReaders.isEmpty() )
+        logDebug() << "Interrupting " << _activeReaders.size() << " pool readers" << endl;
+
+    for ( PoolReaderThread * reader: _activeReaders )
+        reader->requestInterruption();
+}
+
+
+void
+PoolReaderThread::waitForAll()
+{
+    interruptAll();
+
+    QList<PoolReaderThread *> readers;
+
+    {
+        QMutexLocker locker( &_mutex );
+        readers = _activeReaders;
+    }
+
+    if ( readers.isEmpty() )
+        return;
+
+    // The readers are only deleted in the GUI thread, i.e. not while this
+    // waits for them. wait() returns right away for one that was never
+    // started.
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for ( PoolReaderThread * reader: readers )
+        reader->wait();
+
+    logDebug() << "Waited " << timer.elapsed() << " millisec for "
+               << readers.size() << " pool readers" << endl;
+}
+
+
+void
+PoolReaderThread::block( bool blocked )
+{
+    if ( blocked )
+        ++_blockCount;
+    else if ( _blockCount > 0 )
+        --_blockCount;
+    else
+        logError() << "Unbalanced unblock" << endl;
+}
+
+
+
+
+PoolReaderBlocker::PoolReaderBlocker()
+{
+    PoolReaderThread::block( true );
+    PoolReaderThread::waitForAll();
+}
+
+
+PoolReaderBlocker::~PoolReaderBlocker()
+{
+    PoolReaderThread::block( false );
+}
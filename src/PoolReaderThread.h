@@ -0,0 +1,168 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef PoolReaderThread_h
+#define PoolReaderThread_h
+
+
+#include <QList>
+#include <QMutex>
+#include <QThread>
+
+
+/**
+ * Base class for worker threads that read the zypp pool in the background:
+ * Package searches (PkgSearchWorker) and rendering the details views
+ * (PkgDetailsRenderWorker).
+ *
+ * libzypp is not thread-safe, and those threads don't only read: Getting
+ * descriptions, file lists or change logs loads repodata into the pool. So
+ * they must not run while anything else changes the pool, i.e. while the
+ * dependency resolver runs in its own thread (see PkgResolverScheduler) or
+ * while repos are reloaded in the GUI thread.
+ *
+ * This class keeps track of all such threads from their construction until
+ * their readPool() function returns, no matter if they were abandoned by
+ * their owner in the meantime, so anything that wants to change the pool
+ * can interrupt them all and wait until activeCount() is 0. While it does
+ * that and while it is busy with the pool, it uses block() so that no new
+ * ones are started; the owners of the threads check canStart() before
+ * creating one, and they try again later if they can't. That also makes
+ * sure that only one reader thread is active at any time.
+ *
+ * All static functions except activeCount() may only be called from the
+ * GUI thread.
+ **/
+class PoolReaderThread: public QThread
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor. This already counts as an active reader, even before
+     * start() is called.
+     **/
+    PoolReaderThread( QObject * parent = 0 );
+
+    /**
+     * Destructor. This waits for the thread to finish if it is still
+     * running, so call requestInterruption() first.
+     **/
+    virtual ~PoolReaderThread();
+
+    /**
+     * Return the number of reader threads that might still access the
+     * pool.
+     **/
+    static int activeCount();
+
+    /**
+     * Request interruption of all active reader threads. They don't stop
+     * right away, only at the next point where they check for that.
+     **/
+    static void interruptAll();
+
+    /**
+     * Request interruption of all active reader threads and wait until
+     * they are finished. This blocks the calling thread; use it only for
+     * things that block the GUI anyway, like synchronous resolver runs.
+     * Use block() first so no new ones are started in the meantime.
+     **/
+    static void waitForAll();
+
+    /**
+     * Block (or unblock) starting new reader threads. Calls can be nested;
+     * each block( true ) needs a block( false ).
+     **/
+    static void block( bool blocked );
+
+    /**
+     * Return 'true' if a new reader thread may be started, 'false' if that
+     * is blocked or if another one is still active: libzypp is not
+     * thread-safe, so reader threads that load repodata must not run at
+     * the same time either.
+     **/
+    static bool canStart();
+
+    /**
+     * Return 'true' if starting reader threads is blocked, i.e. if
+     * something is about to change the pool or is busy changing it. Code
+     * in the GUI thread that reads the pool can check this, too.
+     **/
+    static bool isBlocked() { return _blockCount > 0; }
+
+
+protected:
+
+    /**
+     * Read the pool. This is executed in the worker thread.
+     * Derived classes are required to implement this.
+     **/
+    virtual void readPool() = 0;
+
+    /**
+     * The thread's main function: Call readPool(), then stop counting this
+     * thread as an active reader.
+     *
+     * Reimplemented from QThread.
+     **/
+    virtual void run() override;
+
+    /**
+     * Stop counting this thread as an active reader.
+     **/
+    void unregister();
+
+
+private:
+
+    static QMutex                     _mutex;   // protects _activeReaders
+    static QList<PoolReaderThread *>  _activeReaders;
+    static int                        _blockCount;
+};
+
+
+/**
+ * Helper class to keep all pool reader threads away from the pool while
+ * the GUI thread changes it synchronously (e.g. a synchronous resolver run
+ * or the package commit): The constructor blocks starting new reader
+ * threads and waits until the active ones are finished; the destructor
+ * unblocks them again.
+ *
+ *     {
+ *         PoolReaderBlocker readerBlocker;
+ *         ...  // Change the pool
+ *     }
+ **/
+class PoolReaderBlocker
+{
+public:
+
+    /**
+     * Constructor: Block new pool reader threads and wait for the active
+     * ones.
+     **/
+    PoolReaderBlocker();
+
+    /**
+     * Destructor: Unblock pool reader threads.
+     **/
+    ~PoolReaderBlocker();
+};
+
+
+#endif // PoolReaderThread_h
@@ -0,0 +1,168 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#include <QElapsedTimer>
+
+#include <zypp/sat/Pool.h>
+
+#include "Logger.h"
+#include "YQPkgPatchList.h"
+#include "YQPkgUpdatesFilterView.h"
+#include "YQZypp.h"
+#include "PoolStats.h"
+
+
+PoolStats::PoolStats()
+    : _valid( false )
+    , _frozen( false )
+    , _updatesCount( 0 )
+    , _updateCandidatesCount( 0 )
+    , _forceUpdateCandidatesCount( 0 )
+    , _neededPatchesCount( 0 )
+    , _haveInstalledPkgs( false )
+    , _anyRetractedPkgInstalled( false )
+{
+    // NOP
+}
+
+
+PoolStats * PoolStats::instance()
+{
+    static PoolStats instance;
+
+    return &instance;
+}
+
+
+void PoolStats::freeze()
+{
+    ensureValid();
+    _frozen = true;
+}
+
+
+void PoolStats::ensureValid()
+{
+    if ( _frozen )
+        return;
+
+    // Check the pool serial number in any case to remember the current one
+
+    bool poolChanged = _poolSerial.remember( zypp::sat::Pool::instance().serial() );
+
+    if ( ! _valid || poolChanged )
+        calc();
+}
+
+
+void PoolStats::calc()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    _updatesCount               = 0;
+    _updateCandidatesCount      = 0;
+    _forceUpdateCandidatesCount = 0;
+    _neededPatchesCount         = 0;
+    _haveInstalledPkgs          = false;
+    _anyRetractedPkgInstalled   = false;
+
+    for ( ZyppPoolIterator it = zyppPkgBegin();
+          it != zyppPkgEnd();
+          ++it )
+    {
+        ZyppSel selectable = *it;
+
+        if ( selectable->installedEmpty() )
+            continue;
+
+        ZyppStatus status = selectable->status();
+        bool haveUpdate   = YQPkgUpdatesFilterView::isUpdateAvailableFor( selectable );
+
+        _haveInstalledPkgs = true;
+
+        if ( selectable->hasRetractedInstalled() )
+            _anyRetractedPkgInstalled = true;
+
+        if ( haveUpdate && status != S_Protected )
+            ++_updatesCount;
+
+        if ( status != S_Update )
+        {
+            ++_forceUpdateCandidatesCount;
+
+            if ( haveUpdate )
+                ++_updateCandidatesCount;
+        }
+    }
+
+    for ( ZyppPoolIterator it = zyppPatchesBegin();
+          it != zyppPatchesEnd();
+          ++it )
+    {
+        ZyppSel selectable = *it;
+
+        if ( YQPkgPatchList::isNeeded( selectable, tryCastToZyppPatch( selectable->theObj() ) ) )
+            ++_neededPatchesCount;
+    }
+
+    _valid = true;
+
+    logDebug() << "Pool stats: "
+               << _updatesCount       << " updates, "
+               << _neededPatchesCount << " needed patches; calculated in "
+               << timer.elapsed()     << " millisec" << endl;
+}
+
+
+int PoolStats::updatesCount()
+{
+    ensureValid();
+
+    return _updatesCount;
+}
+
+
+int PoolStats::updateCandidatesCount( bool force )
+{
+    ensureValid();
+
+    return force ? _forceUpdateCandidatesCount : _updateCandidatesCount;
+}
+
+
+int PoolStats::neededPatchesCount()
+{
+    ensureValid();
+
+    return _neededPatchesCount;
+}
+
+
+bool PoolStats::haveInstalledPkgs()
+{
+    ensureValid();
+
+    return _haveInstalledPkgs;
+}
+
+
+bool PoolStats::anyRetractedPkgInstalled()
+{
+    ensureValid();
+
+    return _anyRetractedPkgInstalled;
+}
@@ -0,0 +1,143 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef PoolStats_h
+#define PoolStats_h
+
+
+#include <zypp/base/SerialNumber.h>
+
+
+/**
+ * Counts and flags about the packages and patches in the pool that are
+ * needed in several places, e.g. for the tab labels of the filter views:
+ * The number of available updates, the number of needed patches etc.
+ *
+ * All of them are computed together in one pass over the pool when one of
+ * them is requested, and then they are cached. They are recalculated
+ * automatically when the content of the pool changes (e.g. when repos are
+ * reloaded). When the status of any package or patch changes, call
+ * invalidate().
+ *
+ * This is a singleton class.
+ **/
+class PoolStats
+{
+public:
+
+    /**
+     * Return the singleton instance of this class.
+     * Create it if it doesn't exist yet.
+     **/
+    static PoolStats * instance();
+
+    /**
+     * Notification that the status of packages or patches changed,
+     * e.g. by the user or by the dependency resolver:
+     * Recalculate all values the next time one of them is requested.
+     **/
+    void invalidate() { _valid = false; }
+
+    /**
+     * Calculate all values if needed and then keep returning them without
+     * checking the pool until thaw() is called.
+     *
+     * Use this while the dependency resolver changes the pool in a worker
+     * thread.
+     **/
+    void freeze();
+
+    /**
+     * Go back to normal operation after freeze().
+     **/
+    void thaw() { _frozen = false; }
+
+    /**
+     * Return the number of packages that have an update available and that
+     * are not protected.
+     *
+     * See also YQPkgUpdatesFilterView::isUpdateAvailableFor().
+     **/
+    int updatesCount();
+
+    /**
+     * Return the number of packages that a global package update would
+     * change to S_Update, i.e. what
+     * YQPkgList::setPoolPkgStatus( S_Update, force, true ) would return.
+     **/
+    int updateCandidatesCount( bool force );
+
+    /**
+     * Return the number of needed patches, i.e. patches that are relevant
+     * and not installed or satisfied yet.
+     *
+     * See also YQPkgPatchList::isNeeded().
+     **/
+    int neededPatchesCount();
+
+    /**
+     * Return 'true' if there are any needed patches.
+     **/
+    bool haveNeededPatches() { return neededPatchesCount() > 0; }
+
+    /**
+     * Return 'true' if any package is installed.
+     **/
+    bool haveInstalledPkgs();
+
+    /**
+     * Return 'true' if any retracted package version is installed.
+     **/
+    bool anyRetractedPkgInstalled();
+
+
+protected:
+
+    /**
+     * Constructor. Use instance() instead.
+     **/
+    PoolStats();
+
+    /**
+     * Recalculate all values if they are not valid anymore.
+     **/
+    void ensureValid();
+
+    /**
+     * Calculate all values in one pass over the packages and one pass over
+     * the patches.
+     **/
+    void calc();
+
+
+    //
+    // Data members
+    //
+
+    bool _valid;
+    bool _frozen;
+    zypp::SerialNumberWatcher _poolSerial;
+
+    int  _updatesCount;
+    int  _updateCandidatesCount;
+    int  _forceUpdateCandidatesCount;
+    int  _neededPatchesCount;
+    bool _haveInstalledPkgs;
+    bool _anyRetractedPkgInstalled;
+};
+
+
+#endif // PoolStats_h
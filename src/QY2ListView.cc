@@ -321,19 +321,21 @@ QY2ListView::setSortByInsertionSequence( bool sortByInsertionSequence )
 
 
 QY2ListViewItem::QY2ListViewItem( QY2ListView *   parentListView,
-                                  const QString & text )
+                                  const QString & text,
+                                  int             type )
     : QTreeWidgetItem( parentListView,
-                       QStringList( text ), 1 )
+                       QStringList( text ), type )
 {
     _serial = parentListView->nextSerial();
 }
 
 
 QY2ListViewItem::QY2ListViewItem( QTreeWidgetItem * parentItem,
-                                  const QString &   text )
+                                  const QString &   text,
+                                  int               type )
     : QTreeWidgetItem( parentItem,
                        QStringList( text ),
-                       1 )
+                       type )
 {
     _serial = 0;
 
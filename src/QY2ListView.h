@@ -227,16 +227,22 @@ public:
 
     /**
      * Constructor for toplevel items.
+     *
+     * 'type' is the QTreeWidgetItem type. Derived classes can use a value
+     * of QTreeWidgetItem::UserType or above to identify their items
+     * without a dynamic_cast.
      **/
     QY2ListViewItem( QY2ListView *   parentListView,
-                     const QString & text = QString() );
+                     const QString & text = QString(),
+                     int             type = 1 );
 
 
     /**
      * Constructor for deeper level items.
      **/
     QY2ListViewItem( QTreeWidgetItem * parentItem,
-                     const QString &   text = QString() );
+                     const QString &   text = QString(),
+                     int               type = 1 );
 
     /**
      * Destructor
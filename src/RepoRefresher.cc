@@ -0,0 +1,260 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+
+#include <zypp/RepoManager.h>
+#include <zypp/repo/RepoException.h>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "StartupTimer.h"
+#include "utf8.h"
+#include "RepoRefresher.h"
+
+RepoRefresher::RepoRefresher( const zypp::RepoManagerOptions & options,
+                              QObject *                        parent )
+    : QObject( parent )
+    , _options( options )
+    , _forceRefresh( false )
+    , _latencyMillisec( 0 )
+    , _nextRepo( 0 )
+    , _worker( 0 )
+    , _running( false )
+{
+    // NOP
+}
+
+
+RepoRefresher::~RepoRefresher()
+{
+    delete _worker; // This waits for the worker to finish
+}
+
+
+void RepoRefresher::refresh( const RepoInfoList & repos )
+{
+    start( repos );
+    waitForFinished();
+}
+
+
+void RepoRefresher::waitForFinished()
+{
+    if ( ! isRunning() )
+        return;
+
+    // The signals from the worker are queued; they are delivered in this
+    // local event loop until the worker is finished.
+
+    QEventLoop eventLoop;
+    connect( this,       SIGNAL( allReposDone() ),
+             &eventLoop, SLOT  ( quit()         ) );
+
+    eventLoop.exec();
+}
+
+
+void RepoRefresher::start( const RepoInfoList & repos )
+{
+    if ( isRunning() )
+    {
+        logError() << "Refreshing repos is already in progress" << endl;
+        return;
+    }
+
+    delete _worker;
+    _worker = 0;
+    _failedRepos.clear();
+
+    _repos.assign( repos.begin(), repos.end() );
+    _nextRepo.storeRelease( 0 );
+
+    if ( _repos.empty() )
+        return;
+
+    logInfo() << "Refreshing " << _repos.size() << " repos in a worker thread" << endl;
+
+    _timer.start();
+
+    _worker = new RepoRefreshWorker( this );
+    CHECK_NEW( _worker );
+
+    connect( _worker, SIGNAL( repoStart      ( int ) ),
+             this,    SLOT  ( workerRepoStart( int ) ) );
+
+    connect( _worker, SIGNAL( repoDone       ( int, bool ) ),
+             this,    SLOT  ( workerRepoDone ( int, bool ) ) );
+
+    connect( _worker, SIGNAL( repoError      ( int ) ),
+             this,    SLOT  ( workerRepoError( int ) ) );
+
+    connect( _worker, SIGNAL( finished()       ),
+             this,    SLOT  ( workerFinished() ) );
+
+    _running = true;
+    _worker->start();
+}
+
+
+void RepoRefresher::cancel()
+{
+    if ( ! isRunning() )
+        return;
+
+    logInfo() << "Canceling the repo refresh" << endl;
+
+    // Any repo index that a worker takes from now on is past the end
+    _nextRepo.storeRelease( (int) _repos.size() );
+}
+
+
+bool RepoRefresher::takeNextRepo( int & indexRet, ZyppRepoInfo & repoRet )
+{
+    int index = _nextRepo.fetchAndAddOrdered( 1 );
+
+    if ( index >= (int) _repos.size() )
+        return false;
+
+    // _repos is not modified while the worker is running,
+    // so it is safe to read it from any thread.
+
+    indexRet = index;
+    repoRet  = _repos[ index ];
+
+    return true;
+}
+
+
+void RepoRefresher::workerRepoStart( int index )
+{
+    emit refreshRepoStart( _repos[ index ] );
+}
+
+
+void RepoRefresher::workerRepoDone( int index, bool cacheChanged )
+{
+    emit refreshRepoDone( _repos[ index ] );
+
+    if ( cacheChanged )
+        emit repoCacheChanged( _repos[ index ] );
+}
+
+
+void RepoRefresher::workerRepoError( int index )
+{
+    _failedRepos.push_back( _repos[ index ] );
+
+    emit refreshRepoError( _repos[ index ] );
+}
+
+
+void RepoRefresher::workerFinished()
+{
+    _running = false;
+
+    logInfo() << "Refreshing " << _repos.size() << " repos done after "
+              << _timer.elapsed() / 1000.0 << " sec" << endl;
+
+    emit allReposDone();
+}
+
+
+
+
+RepoRefreshWorker::RepoRefreshWorker( RepoRefresher * refresher )
+    : QThread( 0 )
+    , _refresher( refresher )
+{
+    // NOP
+}
+
+
+RepoRefreshWorker::~RepoRefreshWorker()
+{
+    wait();
+}
+
+
+void
+RepoRefreshWorker::run()
+{
+    zypp::RepoManager::RawMetadataRefreshPolicy refreshPolicy =
+        _refresher->forceRefresh() ?
+        zypp::RepoManager::RefreshForced : zypp::RepoManager::RefreshIfNeeded;
+
+    zypp::RepoManager::CacheBuildPolicy buildPolicy =
+        _refresher->forceRefresh() ?
+        zypp::RepoManager::BuildForced : zypp::RepoManager::BuildIfNeeded;
+
+    // The worker has its own repo manager so it doesn't share any state
+    // with the one of the GUI thread except what is on disk.
+
+    zypp::RepoManager repoManager( _refresher->options() );
+    ZyppRepoInfo      repo;
+    int               index = 0;
+
+    while ( _refresher->takeNextRepo( index, repo ) )
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        logInfo() << "Refreshing repo " << repo.name() << "..." << endl;
+        emit repoStart( index );
+
+        try
+        {
+            StartupTimer *   startupTimer   = StartupTimer::instance();
+            QString          alias          = fromUTF8( repo.alias() );
+            qint64           startMillisec  = startupTimer->elapsed();
+            zypp::RepoStatus oldCacheStatus = repoManager.cacheStatus( repo );
+
+            repoManager.refreshMetadata( repo, refreshPolicy );
+
+            // Simulate a slow mirror
+
+            if ( _refresher->latencyMillisec() > 0 )
+                QThread::msleep( _refresher->latencyMillisec() );
+
+            startupTimer->addPhase( "refreshMetadata " + alias, startMillisec,
+                                    startupTimer->elapsed() - startMillisec );
+
+            startMillisec = startupTimer->elapsed();
+            repoManager.buildCache( repo, buildPolicy );
+            startupTimer->addPhase( "buildCache " + alias, startMillisec,
+                                    startupTimer->elapsed() - startMillisec );
+
+            bool cacheChanged = ! ( repoManager.cacheStatus( repo ) == oldCacheStatus );
+
+            logInfo() << "Refreshing repo " << repo.name()
+                      << " done after " << timer.elapsed() / 1000.0 << " sec"
+                      << endl;
+
+            emit repoDone( index, cacheChanged );
+        }
+        catch ( const zypp::Exception & exception )
+        {
+            // There is no caller to rethrow to in a thread,
+            // so any exception means that this repo failed.
+
+            logWarning() << "CAUGHT zypp exception for repo " << repo.name()
+                         << ": " << exception.asString() << endl;
+
+            emit repoError( index );
+        }
+    }
+}
@@ -0,0 +1,257 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef RepoRefresher_h
+#define RepoRefresher_h
+
+
+#include <list>
+#include <vector>
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QThread>
+
+#include <zypp/RepoManagerOptions.h>
+
+#include "YQZypp.h"     // ZyppRepoInfo
+
+
+class RepoRefreshWorker;
+
+typedef std::list<ZyppRepoInfo> RepoInfoList;
+
+
+/**
+ * Refresh the metadata of a number of repos in a worker thread, so the GUI
+ * remains responsive, and report the progress for each repo.
+ *
+ * The worker thread refreshes the metadata of one repo after the other
+ * with its own zypp::RepoManager and builds its solv cache.
+ *
+ * This does not refresh several repos in parallel: libzypp is not designed
+ * for concurrent use. Even with a separate RepoManager for each thread, the
+ * media manager that does the downloads, the GPG key ring and the callback
+ * reports are process-wide and not thread-safe, so the downloads can't
+ * overlap, and they are what takes the time. The GPG key ring callbacks
+ * (see KeyRingCallbacks) ask the user in the GUI thread.
+ *
+ * The signals are emitted in the GUI thread as the repos are processed.
+ *
+ * Use refresh() to wait until all repos are done, or start() to refresh
+ * them in the background.
+ **/
+class RepoRefresher: public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor. The worker thread creates its own zypp::RepoManager
+     * with 'options'.
+     **/
+    RepoRefresher( const zypp::RepoManagerOptions & options,
+                   QObject *                        parent = 0 );
+
+    /**
+     * Destructor.
+     **/
+    virtual ~RepoRefresher();
+
+    /**
+     * Refresh the metadata and build the solv cache of all 'repos' in the
+     * worker thread. This returns when all of them are done; it runs a local
+     * event loop in the meantime to deliver the signals and to keep the GUI
+     * responsive.
+     **/
+    void refresh( const RepoInfoList & repos );
+
+    /**
+     * Start refreshing 'repos' in the background and return immediately.
+     * allReposDone() is emitted when all of them are done.
+     **/
+    void start( const RepoInfoList & repos );
+
+    /**
+     * Return 'true' if refreshing repos is still in progress.
+     **/
+    bool isRunning() const { return _running; }
+
+    /**
+     * Cancel refreshing repos: The worker doesn't take any more repos. The
+     * repo that is being refreshed right now is still finished, and
+     * allReposDone() is emitted as usual when that is done.
+     **/
+    void cancel();
+
+    /**
+     * Wait until the worker is finished. Like refresh(), this runs a
+     * local event loop in the meantime.
+     **/
+    void waitForFinished();
+
+    /**
+     * Return the repos that failed to refresh in the last refresh().
+     **/
+    const RepoInfoList & failedRepos() const { return _failedRepos; }
+
+    /**
+     * Set if the metadata should be refreshed and the solv cache rebuilt
+     * even if that is not needed. The default is 'false'.
+     **/
+    void setForceRefresh( bool value ) { _forceRefresh = value; }
+
+    /**
+     * Return 'true' if the metadata are refreshed even if not needed.
+     **/
+    bool forceRefresh() const { return _forceRefresh; }
+
+    /**
+     * Set an artificial latency in milliseconds for each repo refresh to
+     * simulate slow mirrors. The default is 0.
+     **/
+    void setLatencyMillisec( int millisec ) { _latencyMillisec = millisec; }
+
+    /**
+     * Return the artificial latency for each repo refresh in milliseconds.
+     **/
+    int latencyMillisec() const { return _latencyMillisec; }
+
+    /**
+     * Return the options for the zypp::RepoManager of the worker thread.
+     **/
+    const zypp::RepoManagerOptions & options() const { return _options; }
+
+    /**
+     * Take the next repo that is not yet handled and store its index in
+     * 'indexRet' and the repo in 'repoRet'. Return 'false' if there is none
+     * left.
+     *
+     * This is called in the worker thread.
+     **/
+    bool takeNextRepo( int & indexRet, ZyppRepoInfo & repoRet );
+
+
+signals:
+
+    /**
+     * Emitted when refreshing a repo starts.
+     **/
+    void refreshRepoStart( const ZyppRepoInfo & repo );
+
+    /**
+     * Emitted when refreshing a repo is done.
+     **/
+    void refreshRepoDone( const ZyppRepoInfo & repo );
+
+    /**
+     * Emitted when refreshing a repo failed.
+     **/
+    void refreshRepoError( const ZyppRepoInfo & repo );
+
+    /**
+     * Emitted after refreshRepoDone() if the solv cache of the repo was
+     * rebuilt, i.e. if the repo needs to be reloaded into the pool if it
+     * was already loaded.
+     **/
+    void repoCacheChanged( const ZyppRepoInfo & repo );
+
+    /**
+     * Emitted when all repos are done.
+     **/
+    void allReposDone();
+
+
+protected slots:
+
+    //
+    // Notifications from the worker thread.
+    // They are queued to the GUI thread.
+    //
+
+    void workerRepoStart( int index );
+    void workerRepoDone ( int index, bool cacheChanged );
+    void workerRepoError( int index );
+    void workerFinished();
+
+
+protected:
+
+    zypp::RepoManagerOptions    _options;
+    bool                        _forceRefresh;
+    int                         _latencyMillisec;
+
+    std::vector<ZyppRepoInfo>   _repos;
+    QAtomicInt                  _nextRepo;
+    RepoInfoList                _failedRepos;
+
+    RepoRefreshWorker *         _worker;
+    bool                        _running;
+    QElapsedTimer               _timer;
+};
+
+
+/**
+ * Worker thread for RepoRefresher: Take the next repo from the refresher,
+ * refresh it, and repeat until there are no more repos left.
+ **/
+class RepoRefreshWorker: public QThread
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor. Call start() to start working.
+     **/
+    RepoRefreshWorker( RepoRefresher * refresher );
+
+    /**
+     * Destructor. This waits for the thread to finish if it is still
+     * running.
+     **/
+    virtual ~RepoRefreshWorker();
+
+
+signals:
+
+    void repoStart( int index );
+    void repoDone ( int index, bool cacheChanged );
+    void repoError( int index );
+
+
+protected:
+
+    /**
+     * Refresh repos until there are no more left.
+     * This is executed in the worker thread.
+     *
+     * Reimplemented from QThread.
+     **/
+    virtual void run() override;
+
+
+    //
+    // Data members
+    //
+
+    RepoRefresher * _refresher;
+};
+
+
+#endif // RepoRefresher_h
@@ -123,6 +123,36 @@ bool SearchFilter::matches( const std::string & str ) const
 
 
 
+bool SearchFilter::isRefinementOf( const SearchFilter & previous ) const
+{
+    if ( _filterMode != previous.filterMode() ||
+         isCaseSensitive() != previous.isCaseSensitive() )
+    {
+        return false;
+    }
+
+    Qt::CaseSensitivity caseSensitivity =
+        isCaseSensitive() ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    switch ( _filterMode )
+    {
+        case Contains:   return _pattern.contains  ( previous.pattern(), caseSensitivity );
+        case StartsWith: return _pattern.startsWith( previous.pattern(), caseSensitivity );
+
+        default:         return false;
+    }
+}
+
+
+void SearchFilter::optimize()
+{
+    // The fixed string modes don't use the regular expression at all
+
+    if ( _filterMode == Wildcard || _filterMode == RegExp )
+        _regexp.optimize();
+}
+
+
 void SearchFilter::setCaseSensitive( bool sensitive )
 {
     if (sensitive)
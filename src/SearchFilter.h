@@ -60,6 +60,29 @@ public:
     bool matches( const QString &     str ) const;
     bool matches( const std::string & str ) const;
 
+    /**
+     * Return 'true' if this filter only narrows down the results of
+     * 'previous', i.e. if everything that matches this filter is
+     * guaranteed to also match 'previous'.
+     *
+     * This is the case if both are in the same "Contains" or "StartsWith"
+     * filter mode with the same case sensitivity, and this pattern extends
+     * the previous one (typically because the user typed more characters).
+     * Then it is sufficient to check the previous results against this
+     * filter instead of searching everything again.
+     **/
+    bool isRefinementOf( const SearchFilter & previous ) const;
+
+    /**
+     * Prepare this filter for matching a large number of strings: Compile
+     * the regular expression right away (only in the filter modes that use
+     * one) and let it optimize itself.
+     *
+     * This is optional; without it, the regular expression is compiled
+     * when it is used for the first time.
+     **/
+    void optimize();
+
     /**
      * Return the pattern.
      **/
@@ -0,0 +1,152 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSettings>
+
+#include "Logger.h"
+#include "YQi18n.h"
+#include "SolverStats.h"
+
+
+// Default threshold for a warning about a slow resolver run
+#define DEFAULT_SLOW_RUN_MILLISEC       2000
+
+
+QString
+SolverRun::toString( Trigger trigger )
+{
+    switch ( trigger )
+    {
+        case Resolve:           return "resolve";
+        case AutoResolve:       return "auto-resolve";
+        case VerifySystem:      return "verify-system";
+        case PackageUpdate:     return "package-update";
+        case DistUpgrade:       return "dist-upgrade";
+        case RepoSwitch:        return "repo-switch";
+    }
+
+    return "unknown";
+}
+
+
+QString
+SolverRun::userText( Trigger trigger )
+{
+    switch ( trigger )
+    {
+        case Resolve:           return _( "Check dependencies" );
+        case AutoResolve:       return _( "Autocheck"          );
+        case VerifySystem:      return _( "Verify system"      );
+        case PackageUpdate:     return _( "Package update"     );
+        case DistUpgrade:       return _( "Dist upgrade"       );
+        case RepoSwitch:        return _( "Repository switch"  );
+    }
+
+    return QString();
+}
+
+
+QString
+SolverRun::toJson() const
+{
+    QJsonObject obj;
+
+    obj[ "serial"   ] = serial;
+    obj[ "trigger"  ] = toString( trigger );
+    obj[ "start"    ] = startTime.toString( Qt::ISODateWithMs );
+    obj[ "millisec" ] = elapsedMillisec;
+    obj[ "poolSize" ] = poolSize;
+    obj[ "changed"  ] = changedSelectables;
+    obj[ "problems" ] = problems;
+    obj[ "success"  ] = success;
+
+    return QString::fromUtf8( QJsonDocument( obj ).toJson( QJsonDocument::Compact ) );
+}
+
+
+
+
+SolverStats::SolverStats()
+{
+    QSettings settings;
+    settings.beginGroup( "DependencyResolver" );
+    _slowRunMillisec = settings.value( "slowRunWarningMillisec", DEFAULT_SLOW_RUN_MILLISEC ).toInt();
+    settings.endGroup();
+}
+
+
+SolverStats::~SolverStats()
+{
+    // NOP
+}
+
+
+SolverStats *
+SolverStats::instance()
+{
+    static SolverStats instance;
+
+    return &instance;
+}
+
+
+void
+SolverStats::add( SolverRun run )
+{
+    run.serial = _runs.size() + 1;
+    _runs << run;
+
+    logInfo() << "Solver run: " << run.toJson() << endl;
+
+    if ( run.elapsedMillisec > _slowRunMillisec )
+    {
+        logWarning() << "Slow solver run #" << run.serial
+                     << " (" << SolverRun::toString( run.trigger ) << "): "
+                     << run.elapsedMillisec << " millisec; threshold "
+                     << _slowRunMillisec << " millisec" << endl;
+    }
+}
+
+
+qint64
+SolverStats::totalMillisec() const
+{
+    qint64 total = 0;
+
+    for ( const SolverRun & run: _runs )
+        total += run.elapsedMillisec;
+
+    return total;
+}
+
+
+void
+SolverStats::logSummary() const
+{
+    if ( _runs.isEmpty() )
+        return;
+
+    logInfo() << "--- BEGIN solver statistics ---" << endl;
+
+    for ( const SolverRun & run: _runs )
+        logInfo() << run.toJson() << endl;
+
+    logInfo() << "--- END solver statistics: "
+              << _runs.size() << " runs, "
+              << totalMillisec() << " millisec total ---" << endl;
+}
@@ -0,0 +1,139 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef SolverStats_h
+#define SolverStats_h
+
+
+#include <QDateTime>
+#include <QList>
+#include <QString>
+
+
+/**
+ * Statistics about one dependency resolver run.
+ **/
+struct SolverRun
+{
+    /**
+     * The action that caused the resolver run.
+     **/
+    enum Trigger
+    {
+        Resolve,        // Explicit resolver run, e.g. "Check Now" or "Accept"
+        AutoResolve,    // Background run after a status change ("Autocheck")
+        VerifySystem,
+        PackageUpdate,
+        DistUpgrade,
+        RepoSwitch
+    };
+
+    int       serial             = 0;
+    Trigger   trigger            = Resolve;
+    QDateTime startTime;
+    qint64    elapsedMillisec    = 0;
+    int       poolSize           = 0;   // Number of solvables in the pool
+    int       changedSelectables = 0;
+    int       problems           = 0;
+    bool      success            = true;
+
+    /**
+     * Return a short machine-readable name for 'trigger'.
+     **/
+    static QString toString( Trigger trigger );
+
+    /**
+     * Return a translated, human-readable name for 'trigger'.
+     **/
+    static QString userText( Trigger trigger );
+
+    /**
+     * Return this run as a one-line JSON object.
+     **/
+    QString toJson() const;
+};
+
+
+/**
+ * Statistics of all dependency resolver runs during this program run.
+ *
+ * Each run that is added is written to the log as one line of JSON, and if
+ * it took longer than a threshold, a warning is added. The threshold can be
+ * configured with "slowRunWarningMillisec" in the "DependencyResolver"
+ * section of the settings.
+ *
+ * This is a singleton class.
+ **/
+class SolverStats
+{
+public:
+
+    /**
+     * Return the singleton instance of this class.
+     * Create it if it doesn't exist yet.
+     **/
+    static SolverStats * instance();
+
+    /**
+     * Add a resolver run. This assigns its serial number.
+     **/
+    void add( SolverRun run );
+
+    /**
+     * Return all resolver runs so far.
+     **/
+    const QList<SolverRun> & runs() const { return _runs; }
+
+    /**
+     * Return the total time of all resolver runs so far.
+     **/
+    qint64 totalMillisec() const;
+
+    /**
+     * Return the threshold for a warning about a slow resolver run.
+     **/
+    int slowRunMillisec() const { return _slowRunMillisec; }
+
+    /**
+     * Write all resolver runs to the log as a machine-readable section:
+     * One line of JSON per run between a start and an end marker.
+     **/
+    void logSummary() const;
+
+
+protected:
+
+    /**
+     * Constructor. Use instance() instead.
+     **/
+    SolverStats();
+
+    /**
+     * Destructor.
+     **/
+    virtual ~SolverStats();
+
+
+    //
+    // Data members
+    //
+
+    QList<SolverRun> _runs;
+    int              _slowRunMillisec;
+};
+
+
+#endif // SolverStats_h
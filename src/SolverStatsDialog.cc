@@ -0,0 +1,164 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#include <QBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QTreeWidget>
+
+#include "MainWindow.h"
+#include "SolverStats.h"
+#include "YQi18n.h"
+#include "SolverStatsDialog.h"
+
+
+#define SPACING         4       // between subwidgets
+#define MARGIN          9       // around the widget
+
+
+enum SolverStatsColumns
+{
+    SerialCol = 0,
+    StartCol,
+    TriggerCol,
+    TimeCol,
+    PoolSizeCol,
+    ChangedCol,
+    ProblemsCol
+};
+
+
+SolverStatsDialog::SolverStatsDialog( QWidget * parent )
+    : QDialog( parent ? parent : MainWindow::instance() )
+{
+    // Dialog title
+    setWindowTitle( _( "Solver Statistics" ) );
+
+    setSizeGripEnabled( true );
+    setMinimumSize( 750, 400 );
+
+
+    // Outer (main) layout
+
+    QVBoxLayout * layout = new QVBoxLayout();
+    Q_CHECK_PTR( layout );
+    setLayout( layout );
+    layout->setContentsMargins( MARGIN, MARGIN, MARGIN, MARGIN );
+    layout->setSpacing( SPACING );
+
+
+    // Summary
+
+    _summaryLabel = new QLabel( this );
+    Q_CHECK_PTR( _summaryLabel );
+    layout->addWidget( _summaryLabel );
+
+
+    // List of resolver runs
+
+    _runsList = new QTreeWidget( this );
+    Q_CHECK_PTR( _runsList );
+    layout->addWidget( _runsList );
+
+    _runsList->setRootIsDecorated( false );
+    _runsList->setHeaderLabels( QStringList()
+                                << _( "Run" )
+                                << _( "Start" )
+                                << _( "Trigger" )
+                                << _( "Time [ms]" )
+                                << _( "Pool Size" )
+                                << _( "Changed" )
+                                << _( "Problems" ) );
+
+
+    // Button box to center the single button
+
+    QHBoxLayout * hbox = new QHBoxLayout();
+    Q_CHECK_PTR( hbox );
+    layout->addLayout( hbox );
+    hbox->addStretch();
+
+    QPushButton * okButton = new QPushButton( _( "&OK" ), this );
+    Q_CHECK_PTR( okButton );
+    hbox->addWidget( okButton );
+    okButton->setDefault( true );
+
+    hbox->addStretch();
+
+    connect( okButton, SIGNAL( clicked() ),
+             this,     SLOT  ( accept()  ) );
+
+    populate();
+}
+
+
+void
+SolverStatsDialog::showSolverStatsDialog( QWidget * parent )
+{
+    SolverStatsDialog dialog( parent );
+    dialog.exec();
+}
+
+
+void
+SolverStatsDialog::populate()
+{
+    const SolverStats *      stats = SolverStats::instance();
+    const QList<SolverRun> & runs  = stats->runs();
+
+    qint64 maxMillisec = 0;
+
+    for ( const SolverRun & run: runs )
+    {
+        QTreeWidgetItem * item = new QTreeWidgetItem( _runsList );
+        Q_CHECK_PTR( item );
+
+        item->setText( SerialCol,   QString::number( run.serial ) );
+        item->setText( StartCol,    run.startTime.toString( "HH:mm:ss" ) );
+        item->setText( TriggerCol,  SolverRun::userText( run.trigger ) );
+        item->setText( TimeCol,     QString::number( run.elapsedMillisec ) );
+        item->setText( PoolSizeCol, QString::number( run.poolSize ) );
+        item->setText( ChangedCol,  QString::number( run.changedSelectables ) );
+        item->setText( ProblemsCol, QString::number( run.problems ) );
+
+        for ( int col = TimeCol; col <= ProblemsCol; ++col )
+            item->setTextAlignment( col, Qt::AlignRight );
+
+        if ( run.elapsedMillisec > stats->slowRunMillisec() )
+            item->setForeground( TimeCol, Qt::red );
+
+        maxMillisec = qMax( maxMillisec, run.elapsedMillisec );
+    }
+
+    for ( int col = 0; col < _runsList->columnCount(); ++col )
+        _runsList->resizeColumnToContents( col );
+
+    if ( runs.isEmpty() )
+    {
+        _summaryLabel->setText( _( "No dependency resolver runs yet." ) );
+    }
+    else
+    {
+        qint64 total = stats->totalMillisec();
+
+        _summaryLabel->setText( _( "%1 resolver runs; total: %2 ms; average: %3 ms; max: %4 ms" )
+                                .arg( runs.size() )
+                                .arg( total )
+                                .arg( total / runs.size() )
+                                .arg( maxMillisec ) );
+    }
+}
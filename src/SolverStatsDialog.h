@@ -0,0 +1,64 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef SolverStatsDialog_h
+#define SolverStatsDialog_h
+
+#include <QDialog>
+
+class QLabel;
+class QTreeWidget;
+class QWidget;
+
+
+/**
+ * Dialog that shows the statistics of all dependency resolver runs so far:
+ * What triggered each run, how long it took, how many packages it changed
+ * and how many problems it found.
+ **/
+class SolverStatsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Static convenience method: Post a solver statistics dialog.
+     **/
+    static void showSolverStatsDialog( QWidget * parent = 0 );
+
+
+protected:
+
+    /**
+     * Constructor. Use the static showSolverStatsDialog() method instead.
+     **/
+    SolverStatsDialog( QWidget * parent );
+
+    /**
+     * Fill the list and the summary with content.
+     **/
+    void populate();
+
+
+    // Data members
+
+    QTreeWidget * _runsList;
+    QLabel *      _summaryLabel;
+};
+
+
+#endif // SolverStatsDialog_h
@@ -0,0 +1,129 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef SpscRingBuffer_h
+#define SpscRingBuffer_h
+
+
+#include <vector>
+
+#include <QAtomicInteger>
+
+
+/**
+ * Lock-free ring buffer for exactly one producer thread and exactly one
+ * consumer thread.
+ *
+ * The producer only writes the tail index, the consumer only writes the
+ * head index; each one reads the other's index with acquire semantics and
+ * publishes its own with release semantics. That is all the
+ * synchronization that is needed for one producer and one consumer, so
+ * neither side ever blocks the other.
+ *
+ * 'T' needs to be copyable; keep it small since it is copied in and out.
+ * The capacity is rounded up to a power of 2.
+ **/
+template<typename T>
+class SpscRingBuffer
+{
+public:
+
+    /**
+     * Constructor.
+     **/
+    SpscRingBuffer( int capacity )
+        : _mask( roundUpToPowerOf2( capacity ) - 1 )
+        , _head( 0 )
+        , _tail( 0 )
+        {
+            _items.resize( _mask + 1 );
+        }
+
+    /**
+     * Append 'item' at the tail. Return 'false' if the buffer is full.
+     *
+     * Call this only from the producer thread.
+     **/
+    bool push( const T & item )
+        {
+            quint32 tail = _tail.loadRelaxed();
+
+            if ( tail - _head.loadAcquire() > _mask )       // Full
+                return false;
+
+            _items[ tail & _mask ] = item;
+            _tail.storeRelease( tail + 1 );
+
+            return true;
+        }
+
+    /**
+     * Take the item at the head and store it in 'item'. Return 'false' if
+     * the buffer is empty.
+     *
+     * Call this only from the consumer thread.
+     **/
+    bool pop( T & item )
+        {
+            quint32 head = _head.loadRelaxed();
+
+            if ( head == _tail.loadAcquire() )              // Empty
+                return false;
+
+            item = _items[ head & _mask ];
+            _head.storeRelease( head + 1 );
+
+            return true;
+        }
+
+    /**
+     * Return 'true' if the buffer is empty. This is only a snapshot if the
+     * other thread is active.
+     **/
+    bool isEmpty() const
+        { return _head.loadAcquire() == _tail.loadAcquire(); }
+
+    /**
+     * Return the capacity of the buffer.
+     **/
+    int capacity() const { return (int) _mask + 1; }
+
+
+protected:
+
+    static quint32 roundUpToPowerOf2( int value )
+        {
+            quint32 result = 1;
+
+            while ( result < (quint32) value )
+                result <<= 1;
+
+            return result;
+        }
+
+
+    //
+    // Data members
+    //
+
+    std::vector<T>          _items;
+    const quint32           _mask;
+    QAtomicInteger<quint32> _head;      // Written only by the consumer
+    QAtomicInteger<quint32> _tail;      // Written only by the producer
+};
+
+
+#endif // SpscRingBuffer_h
@@ -0,0 +1,182 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#include <algorithm>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+
+#include "Logger.h"
+#include "StartupTimer.h"
+
+
+StartupTimer::StartupTimer()
+    : _openPhases( 0 )
+    , _totalMillisec( -1 )
+{
+    _timer.start();
+}
+
+
+StartupTimer * StartupTimer::instance()
+{
+    static StartupTimer instance;
+
+    return &instance;
+}
+
+
+void StartupTimer::beginPhase( const QString & name )
+{
+    QMutexLocker locker( &_mutex );
+
+    if ( _totalMillisec >= 0 ) // finished?
+        return;
+
+    _phases << Phase { name, _timer.elapsed(), -1, _openPhases };
+    ++_openPhases;
+}
+
+
+void StartupTimer::endPhase( const QString & name )
+{
+    QMutexLocker locker( &_mutex );
+
+    if ( _totalMillisec >= 0 ) // finished?
+        return;
+
+    // Find the innermost open phase with that name
+
+    for ( int i = _phases.size() - 1; i >= 0; --i )
+    {
+        Phase & phase = _phases[ i ];
+
+        if ( phase.durationMillisec < 0 && phase.name == name )
+        {
+            phase.durationMillisec = _timer.elapsed() - phase.startMillisec;
+            --_openPhases;
+            return;
+        }
+    }
+
+    logError() << "No open startup phase " << name << endl;
+}
+
+
+void StartupTimer::addPhase( const QString & name,
+                             qint64          startMillisec,
+                             qint64          durationMillisec )
+{
+    QMutexLocker locker( &_mutex );
+
+    if ( _totalMillisec >= 0 ) // finished?
+        return;
+
+    _phases << Phase { name, startMillisec, durationMillisec, _openPhases };
+}
+
+
+void StartupTimer::finish()
+{
+    QMutexLocker locker( &_mutex );
+
+    if ( _totalMillisec < 0 )
+        _totalMillisec = _timer.elapsed();
+}
+
+
+bool StartupTimer::isFinished() const
+{
+    QMutexLocker locker( &_mutex );
+
+    return _totalMillisec >= 0;
+}
+
+
+QList<StartupTimer::Phase> StartupTimer::sortedPhases() const
+{
+    QMutexLocker locker( &_mutex );
+    QList<Phase> phases = _phases;
+
+    // Stable sort: Keep nested phases that start in the same millisecond
+    // after their parent.
+
+    std::stable_sort( phases.begin(), phases.end(),
+                      []( const Phase & a, const Phase & b )
+                      {
+                          return a.startMillisec < b.startMillisec;
+                      } );
+
+    return phases;
+}
+
+
+void StartupTimer::logReport() const
+{
+    logInfo() << "Startup timing [millisec]:" << endl;
+    logInfo() << QString( "%1 %2  %3" )
+        .arg( "Start", 8 ).arg( "Duration", 8 ).arg( "Phase" ) << endl;
+
+    for ( const Phase & phase: sortedPhases() )
+    {
+        QString duration = phase.durationMillisec < 0 ?
+            QString( "(open)" ) : QString::number( phase.durationMillisec );
+
+        logInfo() << QString( "%1 %2  %3%4" )
+            .arg( phase.startMillisec, 8 )
+            .arg( duration, 8 )
+            .arg( QString( 2 * phase.depth, ' ' ) )
+            .arg( phase.name ) << endl;
+    }
+
+    QMutexLocker locker( &_mutex );
+    logInfo() << QString( "%1 %2  %3" )
+        .arg( 0, 8 ).arg( _totalMillisec, 8 ).arg( "total" ) << endl;
+}
+
+
+QString StartupTimer::toJson() const
+{
+    QJsonArray phases;
+
+    for ( const Phase & phase: sortedPhases() )
+    {
+        QJsonObject obj;
+        obj[ "name"             ] = phase.name;
+        obj[ "startMillisec"    ] = phase.startMillisec;
+        obj[ "durationMillisec" ] = phase.durationMillisec;
+        obj[ "depth"            ] = phase.depth;
+
+        phases.append( obj );
+    }
+
+    QJsonObject result;
+
+    {
+        QMutexLocker locker( &_mutex );
+        result[ "totalMillisec" ] = _totalMillisec;
+    }
+
+#ifdef VERSION
+    result[ "version" ] = VERSION;
+#endif
+
+    result[ "phases" ] = phases;
+
+    return QString::fromUtf8( QJsonDocument( result ).toJson( QJsonDocument::Indented ) );
+}
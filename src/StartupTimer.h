@@ -0,0 +1,159 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef StartupTimer_h
+#define StartupTimer_h
+
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+
+/**
+ * Timer for the phases of the program startup: Connecting to zypp, loading
+ * the target, refreshing and loading the repos, creating the package
+ * selector etc.
+ *
+ * The time is measured from the creation of the instance, which should be
+ * as early as possible in main(). Phases can be nested; use the
+ * StartupPhase helper class to time a scope.
+ *
+ * When startup is complete, call finish() and then logReport() and / or
+ * toJson(). After finish(), any new phases are ignored, so code that is
+ * also used later (e.g. loading repos again) can stay instrumented.
+ *
+ * All functions are thread-safe so phases can also be added from worker
+ * threads.
+ **/
+class StartupTimer
+{
+public:
+
+    /**
+     * Return the singleton instance of this class. The first call creates
+     * it and starts the timer.
+     **/
+    static StartupTimer * instance();
+
+    /**
+     * Return the milliseconds since the startup began.
+     **/
+    qint64 elapsed() const { return _timer.elapsed(); }
+
+    /**
+     * Begin a phase. Phases that begin while this one is still open are
+     * nested inside it.
+     *
+     * Only call this and endPhase() from the GUI thread.
+     **/
+    void beginPhase( const QString & name );
+
+    /**
+     * End the phase 'name' that was started with beginPhase().
+     **/
+    void endPhase( const QString & name );
+
+    /**
+     * Add a phase that was measured somewhere else, e.g. in a worker
+     * thread. It is nested inside the phases that are currently open.
+     **/
+    void addPhase( const QString & name,
+                   qint64          startMillisec,
+                   qint64          durationMillisec );
+
+    /**
+     * Finish the startup: Record the total time and ignore any new phases
+     * from now on. Subsequent calls do nothing.
+     **/
+    void finish();
+
+    /**
+     * Return 'true' if finish() was already called.
+     **/
+    bool isFinished() const;
+
+    /**
+     * Write the timing table to the log.
+     **/
+    void logReport() const;
+
+    /**
+     * Return the timings in JSON format.
+     **/
+    QString toJson() const;
+
+
+protected:
+
+    /**
+     * Constructor. Use instance() instead.
+     **/
+    StartupTimer();
+
+    struct Phase
+    {
+        QString name;
+        qint64  startMillisec;
+        qint64  durationMillisec;   // -1 while the phase is open
+        int     depth;
+    };
+
+    /**
+     * Return the phases sorted by start time.
+     **/
+    QList<Phase> sortedPhases() const;
+
+
+    //
+    // Data members
+    //
+
+    QElapsedTimer _timer;
+    mutable QMutex _mutex;          // protects everything below
+    QList<Phase>  _phases;
+    int           _openPhases;
+    qint64        _totalMillisec;   // -1 until finish()
+};
+
+
+/**
+ * Helper class to time a scope as a startup phase:
+ *
+ *     {
+ *         StartupPhase phase( "loadTarget" );
+ *         ...
+ *     }
+ **/
+class StartupPhase
+{
+public:
+
+    StartupPhase( const QString & name )
+        : _name( name )
+        { StartupTimer::instance()->beginPhase( _name ); }
+
+    ~StartupPhase()
+        { StartupTimer::instance()->endPhase( _name ); }
+
+protected:
+
+    QString _name;
+};
+
+
+#endif // StartupTimer_h
@@ -34,21 +34,13 @@ YQPkgChangeLogView::YQPkgChangeLogView( QWidget * parent )
 
 YQPkgChangeLogView::~YQPkgChangeLogView()
 {
-    // NOP
+    stopRendering();
 }
 
 
-void
-YQPkgChangeLogView::showDetails( ZyppSel selectable )
+QString
+YQPkgChangeLogView::renderHtml( ZyppSel selectable )
 {
-    _selectable = selectable;
-
-    if ( ! selectable )
-    {
-	clear();
-	return;
-    }
-
     // logVerbose() << "Generating changelog..." << endl;
 
     QString html = htmlStart();
@@ -75,7 +67,7 @@ YQPkgChangeLogView::showDetails( ZyppSel selectable )
     }
 
     html += htmlEnd();
-    setHtml( html );
+    return html;
 }
 
 
@@ -91,6 +83,9 @@ QString YQPkgChangeLogView::changeLogTable( const zypp::Changelog & changeLog )
 	  it != changeLog.end();
 	  ++it )
     {
+        if ( QThread::currentThread()->isInterruptionRequested() )
+            break; // The result is not used anyway
+
 	QString changes = htmlEscape( fromUTF8( (*it).text() ) );
 	changes.replace( "\n", "<br>"  );
 	changes.replace( " ", "&nbsp;" );
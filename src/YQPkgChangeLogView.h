@@ -45,15 +45,15 @@ public:
      **/
     virtual ~YQPkgChangeLogView();
 
+protected:
+
     /**
-     * Show details for the specified package,
+     * Return the HTML for the specified package,
      * in this case the package description.
      *
      * Reimplemented from YQPkgGenericDetailsView.
      **/
-    virtual void showDetails( ZyppSel selectable ) override;
-
-protected:
+    virtual QString renderHtml( ZyppSel selectable ) override;
 
     /**
      * Format a change log list in HTML
@@ -27,6 +27,9 @@
 #include <zypp/ui/Selectable.h>
 
 #include "Logger.h"
+#include "PkgResolverScheduler.h"
+#include "PoolReaderThread.h"
+#include "YQPkgSelector.h"
 #include "YQi18n.h"
 #include "YQPkgClassificationFilterView.h"
 
@@ -197,6 +200,16 @@ YQPkgClassificationFilterView::slotSelectionChanged( QTreeWidgetItem * newSelect
 
 	if ( needSolverRun )
 	{
+            // Not at the same time as a background resolver run,
+            // and not while any thread reads the pool
+
+            YQPkgSelector * pkgSel = YQPkgSelector::instance();
+
+            if ( pkgSel )
+                pkgSel->resolverScheduler()->waitForIdle();
+
+            PoolReaderBlocker readerBlocker;
+
 	    QApplication::setOverrideCursor(Qt::WaitCursor);
 	    zypp::getZYpp()->resolver()->resolvePool();
 	    QApplication::restoreOverrideCursor();
@@ -20,6 +20,7 @@
 #include <zypp/ZYpp.h>
 #include <zypp/ZYppFactory.h>
 #include <zypp/Resolver.h>
+#include <zypp/sat/Pool.h>
 
 #include <QElapsedTimer>
 #include <QLabel>
@@ -33,7 +34,9 @@
 #include "BusyPopup.h"
 #include "Logger.h"
 #include "MainWindow.h"
+#include "PoolStats.h"
 #include "QY2LayoutUtils.h"
+#include "SolverStats.h"
 #include "WindowSettings.h"
 #include "YQPkgConflictList.h"
 #include "YQPkgConflictDialog.h"
@@ -169,15 +172,25 @@ YQPkgConflictDialog::sizeHint() const
 int
 YQPkgConflictDialog::solveAndShowConflicts()
 {
+    return solveAndShowConflicts( SolverRun::Resolve );
+}
+
+
+int
+YQPkgConflictDialog::solveAndShowConflicts( SolverRun::Trigger trigger )
+{
+    QElapsedTimer timer;
+
     prepareSolving();
     // logInfo() << "Resolving dependencies..." << endl;
 
+    timer.start();
     bool success = zypp::getZYpp()->resolver()->resolvePool();
     ++_resolverRunCount;
 
     // logDebug() << "Resolving dependencies done." << endl;
 
-    return processSolverResult( success );
+    return processSolverResult( success, trigger, timer.elapsed() );
 }
 
 
@@ -190,9 +203,12 @@ YQPkgConflictDialog::verifySystem( bool showBusyPopup )
         busyPopup = new BusyPopup( _( "Verifying System Dependencies" ),
                                    MainWindow::instance() );
 
+    QElapsedTimer timer;
+
     prepareSolving();
     logInfo() << "Verifying all system dependencies..." << endl;
 
+    timer.start();
     bool success = zypp::getZYpp()->resolver()->verifySystem();
     ++_resolverRunCount;
 
@@ -201,7 +217,7 @@ YQPkgConflictDialog::verifySystem( bool showBusyPopup )
     if ( busyPopup )
         delete busyPopup;
 
-    return processSolverResult( success );
+    return processSolverResult( success, SolverRun::VerifySystem, timer.elapsed() );
 }
 
 
@@ -230,7 +246,7 @@ YQPkgConflictDialog::doPackageUpdate()
               << timer.elapsed() / 1000.0 << " sec"
               << endl;
 
-    return processSolverResult( success );
+    return processSolverResult( success, SolverRun::PackageUpdate, timer.elapsed() );
 }
 
 
@@ -250,7 +266,7 @@ YQPkgConflictDialog::doDistUpgrade()
               << timer.elapsed() / 1000.0 << " sec"
               << endl;
 
-    return processSolverResult( success );
+    return processSolverResult( success, SolverRun::DistUpgrade, timer.elapsed() );
 }
 
 
@@ -277,12 +293,44 @@ YQPkgConflictDialog::prepareSolving()
 
 
 int
-YQPkgConflictDialog::processSolverResult( bool success )
+YQPkgConflictDialog::processAsyncSolverResult( bool   success,
+                                               qint64 elapsedMillisec )
+{
+    ++_resolverRunCount;
+
+    return processSolverResult( success, SolverRun::AutoResolve, elapsedMillisec );
+}
+
+
+int
+YQPkgConflictDialog::processSolverResult( bool               success,
+                                          SolverRun::Trigger trigger,
+                                          qint64             elapsedMillisec )
 {
     // Package states may have changed: The solver may have set packages to
     // autoInstall or autoUpdate. Make those changes known.
+    ZyppSelSet changed = changedSelectables();
+    PoolStats::instance()->invalidate();
+
+    emit selectablesChanged( changed );
     emit updatePackages();
 
+    ZyppProblemList problems;
+
+    if ( ! success )
+        problems = zypp::getZYpp()->resolver()->problems();
+
+    SolverRun run;
+    run.trigger            = trigger;
+    run.startTime          = QDateTime::currentDateTime().addMSecs( -elapsedMillisec );
+    run.elapsedMillisec    = elapsedMillisec;
+    run.poolSize           = (int) zypp::sat::Pool::instance().solvablesSize();
+    run.changedSelectables = (int) changed.size();
+    run.problems           = (int) problems.size();
+    run.success            = success;
+
+    SolverStats::instance()->add( run );
+
     normalCursor();
     int result = QDialog::Accepted;
 
@@ -298,7 +346,7 @@ YQPkgConflictDialog::processSolverResult( bool success )
         logDebug() << "Dependency conflict!" << endl;
         busyCursor();
 
-        _conflictList->fill( zypp::getZYpp()->resolver()->problems() );
+        _conflictList->fill( problems );
         normalCursor();
 
         if ( ! isVisible() )
@@ -312,6 +360,55 @@ YQPkgConflictDialog::processSolverResult( bool success )
 }
 
 
+YQPkgConflictDialog::StatusSnapshot
+YQPkgConflictDialog::statusSnapshot() const
+{
+    StatusSnapshot snapshot;
+    snapshot.reserve( _statusSnapshot.size() );
+
+    auto addStates = [&]( ZyppPoolIterator begin, ZyppPoolIterator end )
+        {
+            for ( ZyppPoolIterator it = begin; it != end; ++it )
+                snapshot.push_back( std::make_pair( *it, (*it)->status() ) );
+        };
+
+    addStates( zyppPkgBegin(),      zyppPkgEnd()      );
+    addStates( zyppPatternsBegin(), zyppPatternsEnd() );
+    addStates( zyppPatchesBegin(),  zyppPatchesEnd()  );
+
+    return snapshot;
+}
+
+
+ZyppSelSet
+YQPkgConflictDialog::changedSelectables()
+{
+    StatusSnapshot snapshot = statusSnapshot();
+    ZyppSelSet     changed;
+
+    // The pool does not change while the package selector is open, so the
+    // selectables are in the same order as in the previous snapshot; if
+    // not, everything counts as changed.
+
+    bool samePool = ( snapshot.size() == _statusSnapshot.size() );
+
+    for ( size_t i = 0; i < snapshot.size(); ++i )
+    {
+        if ( ! samePool ||
+             snapshot[i].first  != _statusSnapshot[i].first ||
+             snapshot[i].second != _statusSnapshot[i].second   )
+        {
+            changed.insert( snapshot[i].first );
+        }
+    }
+
+    _statusSnapshot.swap( snapshot );
+    logDebug() << changed.size() << " selectables changed their status" << endl;
+
+    return changed;
+}
+
+
 void
 YQPkgConflictDialog::askCreateSolverTestCase()
 {
@@ -18,8 +18,14 @@
 #define YQPkgConflictDialog_h
 
 
+#include <utility>
+#include <vector>
+
 #include <QDialog>
 
+#include "SolverStats.h"
+#include "YQZypp.h"
+
 class YQPkgConflictList;
 class QMenu;
 
@@ -71,6 +77,27 @@ public:
      **/
     static void resetIgnoredDependencyProblems();
 
+    /**
+     * Initialize solving: Post "busy" popup etc.
+     *
+     * This is called internally by all methods that run the resolver; use
+     * it directly only before running the resolver elsewhere, e.g. in a
+     * PkgResolverWorker thread.
+     **/
+    void prepareSolving();
+
+    /**
+     * Process the result of a resolver run that was started after
+     * prepareSolving() outside of this class, e.g. in a PkgResolverWorker
+     * thread: Post the conflict dialog if necessary.
+     *
+     * 'elapsedMillisec' is the duration of that resolver run for the
+     * solver statistics.
+     *
+     * Returns QDialog::Accepted or QDialog::Rejected.
+     **/
+    int processAsyncSolverResult( bool success, qint64 elapsedMillisec );
+
 
 public slots:
 
@@ -83,6 +110,12 @@ public slots:
      **/
     int solveAndShowConflicts();
 
+    /**
+     * The same as solveAndShowConflicts(), but with a different trigger
+     * for the solver statistics.
+     **/
+    int solveAndShowConflicts( SolverRun::Trigger trigger );
+
     /**
      * Run the package dependency solver for the currently installed system
      * plus the packages that are marked for installation (or update or...) and
@@ -136,20 +169,42 @@ signals:
      **/
     void updatePackages();
 
+    /**
+     * Emitted after each solver run with the selectables whose status
+     * changed since the previous solver run; after the first solver run,
+     * these are all packages, patterns and patches.
+     *
+     * This is emitted right before updatePackages(). Lists can use it to
+     * update only the items of those selectables.
+     **/
+    void selectablesChanged( const ZyppSelSet & selectables );
+
 
 protected:
 
-    /**
-     * Initialize solving: Post "busy" popup etc.
-     **/
-    void prepareSolving();
+    typedef std::vector<std::pair<ZyppSel, ZyppStatus> > StatusSnapshot;
 
     /**
      * Process the result of solving: Post conflict dialog, if neccessary.
      * 'success' is the return value of the preceding solver call.
+     * 'trigger' and 'elapsedMillisec' are for the solver statistics.
      * Returns either QDialog::Accepted or QDialog::Rejected.
      **/
-    int  processSolverResult( bool success );
+    int  processSolverResult( bool               success,
+                              SolverRun::Trigger trigger,
+                              qint64             elapsedMillisec );
+
+    /**
+     * Return the current status of all packages, patterns and patches.
+     **/
+    StatusSnapshot statusSnapshot() const;
+
+    /**
+     * Return the selectables whose status changed since the last call of
+     * this function and remember the current states for the next call.
+     * The first call returns all selectables.
+     **/
+    ZyppSelSet changedSelectables();
 
 
     //
@@ -158,6 +213,7 @@ protected:
 
     YQPkgConflictList * _conflictList;
     QMenu *             _expertMenu;
+    StatusSnapshot      _statusSnapshot;
 
     static YQPkgConflictDialog * _instance;
     static int                   _resolverRunCount;
@@ -33,21 +33,13 @@ YQPkgDependenciesView::YQPkgDependenciesView( QWidget * parent )
 
 YQPkgDependenciesView::~YQPkgDependenciesView()
 {
-    // NOP
+    stopRendering();
 }
 
 
-void
-YQPkgDependenciesView::showDetails( ZyppSel selectable )
+QString
+YQPkgDependenciesView::renderHtml( ZyppSel selectable )
 {
-    _selectable = selectable;
-
-    if ( ! selectable )
-    {
-	clear();
-	return;
-    }
-
     QString html_text = htmlStart();
     html_text += htmlHeading( selectable );
 
@@ -69,7 +61,7 @@ YQPkgDependenciesView::showDetails( ZyppSel selectable )
 
     html_text += htmlEnd();
 
-    setHtml( html_text );
+    return html_text;
 }
 
 
@@ -57,17 +57,9 @@ YQPkgDescriptionView::~YQPkgDescriptionView()
 }
 
 
-void
-YQPkgDescriptionView::showDetails( ZyppSel selectable )
+QString
+YQPkgDescriptionView::renderHtml( ZyppSel selectable )
 {
-    _selectable = selectable;
-
-    if ( ! selectable )
-    {
-        clear();
-        return;
-    }
-
     QString html_text = htmlStart();
 
     html_text += htmlHeading( selectable );
@@ -119,7 +111,7 @@ YQPkgDescriptionView::showDetails( ZyppSel selectable )
     }
 
     html_text += htmlEnd();
-    setHtml( html_text );
+    return html_text;
 }
 
 
@@ -47,14 +47,6 @@ public:
      **/
     virtual ~YQPkgDescriptionView();
 
-    /**
-     * Show details for the specified package:
-     * In this case the package description.
-     *
-     * Reimplemented from YQPkgGenericDetailsView.
-     **/
-    virtual void showDetails( ZyppSel selectable ) override;
-
 #if 0
     /**
      * Get the document pointed to by a hyperlink.
@@ -74,6 +66,22 @@ public:
 
 protected:
 
+    /**
+     * Return the HTML for the specified package:
+     * In this case the package description.
+     *
+     * Reimplemented from YQPkgGenericDetailsView.
+     **/
+    virtual QString renderHtml( ZyppSel selectable ) override;
+
+    /**
+     * Return 'false' since this view loads application icons which only
+     * works in the GUI thread.
+     *
+     * Reimplemented from YQPkgGenericDetailsView.
+     **/
+    virtual bool renderInThread() const override { return false; }
+
     /**
      * Format a multi-line text into paragraphs
      **/
@@ -29,6 +29,7 @@
 #include "YQPkgDiskUsageWarningDialog.h"
 
 #include "Logger.h"
+#include "PoolReaderThread.h"
 
 
 using std::set;
@@ -50,6 +51,10 @@ using std::set;
 #define OVERFLOW_MB_WARN        0
 #define OVERFLOW_MB_PROXIMITY   300
 
+// Collect update requests for this long before actually updating
+
+#define UPDATE_DELAY_MILLISEC   100
+
 
 typedef zypp::DiskUsageCounter::MountPointSet           ZyppDuSet;
 
@@ -58,9 +63,16 @@ typedef zypp::DiskUsageCounter::MountPointSet           ZyppDuSet;
 YQPkgDiskUsageList::YQPkgDiskUsageList( QWidget * parent,
                                         int       thresholdPercent )
     : QY2DiskUsageList( parent, true )
+    , _resizePending( false )
 {
     _debug = false;
 
+    _updateTimer.setSingleShot( true );
+    _updateTimer.setInterval( UPDATE_DELAY_MILLISEC );
+
+    connect( &_updateTimer, SIGNAL( timeout()            ),
+             this,          SLOT  ( updateDiskUsageNow() ) );
+
     ZyppDuSet diskUsage = zypp::getZYpp()->diskUsage();
 
     if ( diskUsage.empty() )
@@ -95,6 +107,28 @@ YQPkgDiskUsageList::YQPkgDiskUsageList( QWidget * parent,
 void
 YQPkgDiskUsageList::updateDiskUsage()
 {
+    // Don't restart the timer if it's already running: With a constant
+    // stream of requests, there should still be an update every now and then.
+
+    if ( ! _updateTimer.isActive() )
+        _updateTimer.start();
+}
+
+
+void
+YQPkgDiskUsageList::updateDiskUsageNow()
+{
+    if ( PoolReaderThread::isBlocked() )
+    {
+        // The resolver is busy changing the pool in a worker thread:
+        // Try again later.
+
+        _updateTimer.start();
+        return;
+    }
+
+    _updateTimer.stop();
+
     runningOutWarning.clear();
     overflowWarning.clear();
 
@@ -110,7 +144,14 @@ YQPkgDiskUsageList::updateDiskUsage()
             logError() << "No entry for mount point " << partitionDu.dir << endl;
     }
 
-    resizeColumnToContents( totalSizeCol() );
+    // Even if the list is not visible, the warnings need the current data;
+    // only resizing the column can wait until the list is shown.
+
+    if ( isVisible() )
+        resizeColumnToContents( totalSizeCol() );
+    else
+        _resizePending = true;
+
     postPendingWarnings();
 }
 
@@ -142,6 +183,19 @@ YQPkgDiskUsageList::postPendingWarnings()
 }
 
 
+void
+YQPkgDiskUsageList::showEvent( QShowEvent * event )
+{
+    QY2DiskUsageList::showEvent( event );
+
+    if ( _resizePending )
+    {
+        _resizePending = false;
+        resizeColumnToContents( totalSizeCol() );
+    }
+}
+
+
 QSize
 YQPkgDiskUsageList::sizeHint() const
 {
@@ -19,6 +19,7 @@
 
 #include <QKeyEvent>
 #include <QMap>
+#include <QTimer>
 
 #include <zypp/DiskUsageCounter.h>
 
@@ -166,9 +167,20 @@ public slots:
 
     /**
      * Update all statistical data in the list.
+     *
+     * This only schedules the update: Many calls in quick succession, e.g.
+     * from a bulk status change, result in only one update.
      **/
     void updateDiskUsage();
 
+    /**
+     * Update all statistical data in the list right away.
+     *
+     * While the dependency resolver is busy with the pool, this is
+     * postponed until it is done.
+     **/
+    void updateDiskUsageNow();
+
     /**
      * Post all pending disk space warnings based on the warning range
      * notifiers.
@@ -186,11 +198,21 @@ protected:
      **/
     virtual void keyPressEvent( QKeyEvent * ev ) override;
 
+    /**
+     * Resize the columns to the data that were updated while the list was
+     * not visible.
+     *
+     * Reimplemented from QWidget.
+     **/
+    virtual void showEvent( QShowEvent * event ) override;
+
 
     // Data members
 
     QMap<QString, YQPkgDiskUsageListItem*> _items;
     bool                                   _debug;
+    QTimer                                 _updateTimer;
+    bool                                   _resizePending;
 };
 
 
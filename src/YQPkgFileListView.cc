@@ -30,21 +30,13 @@ YQPkgFileListView::YQPkgFileListView( QWidget * parent )
 
 YQPkgFileListView::~YQPkgFileListView()
 {
-    // NOP
+    stopRendering();
 }
 
 
-void
-YQPkgFileListView::showDetails( ZyppSel selectable )
+QString
+YQPkgFileListView::renderHtml( ZyppSel selectable )
 {
-    _selectable = selectable;
-
-    if ( ! selectable )
-    {
-        clear();
-        return;
-    }
-
     QString html = htmlHeading( selectable,
                                 false ); // showVersion
 
@@ -62,7 +54,7 @@ YQPkgFileListView::showDetails( ZyppSel selectable )
         html += "<p><i>" + _( "Information only available for installed packages." ) + "</i></p>";
     }
 
-    setHtml( html );
+    return html;
 }
 
 
@@ -76,6 +68,9 @@ QString YQPkgFileListView::formatFileList( const std::list<string> & fileList )
           it != fileList.end() && lineCount < MAX_LINES;
           ++it, ++lineCount )
     {
+        if ( QThread::currentThread()->isInterruptionRequested() )
+            break; // The result is not used anyway
+
         QString line = htmlEscape( fromUTF8( *it ) );
 
         if ( line.contains( "/bin/"  ) ||
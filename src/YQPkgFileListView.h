@@ -42,15 +42,15 @@ public:
      **/
     virtual ~YQPkgFileListView();
 
+protected:
+
     /**
-     * Show details for the specified package:
+     * Return the HTML for the specified package:
      * In this case the package description.
      *
      * Reimplemented from YQPkgGenericDetailsView.
      **/
-    virtual void showDetails( ZyppSel selectable ) override;
-
-protected:
+    virtual QString renderHtml( ZyppSel selectable ) override;
 
     /**
      * Format a file list in HTML
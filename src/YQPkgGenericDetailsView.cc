@@ -19,9 +19,12 @@
 #include <zypp/Edition.h>
 #include <zypp/PoolItem.h>
 #include <zypp/ResObject.h>
+#include <zypp/sat/Pool.h>
 #include <zypp/ui/Selectable.h>
 
+#include "Exception.h"
 #include "Logger.h"
+#include "PoolReaderThread.h"
 #include "utf8.h"
 #include "YQPkgGenericDetailsView.h"
 
@@ -29,9 +32,20 @@
 #  define VERBOSE_DETAILS_VIEWS  0
 #endif
 
+// Number of rendered HTML pages to keep in the cache of each view
+#define HTML_CACHE_SIZE         50
+
+// Time the selection has to stay on an item until it is rendered
+#define RENDER_DELAY_MILLISEC   50
+
+// Try again this often to render while the resolver is busy
+#define READER_RETRY_MILLISEC   100
+
 
 YQPkgGenericDetailsView::YQPkgGenericDetailsView( QWidget * parent )
     : QTextBrowser( parent )
+    , _htmlCache( HTML_CACHE_SIZE )
+    , _renderWorker( 0 )
 {
     _selectable = 0;
     setFrameStyle( QFrame::NoFrame );
@@ -43,6 +57,18 @@ YQPkgGenericDetailsView::YQPkgGenericDetailsView( QWidget * parent )
                  this,       SLOT  ( reloadTab     ( int ) ) );
     }
 
+    _renderTimer.setSingleShot( true );
+    _renderTimer.setInterval( RENDER_DELAY_MILLISEC );
+
+    connect( &_renderTimer, SIGNAL( timeout()        ),
+             this,          SLOT  ( startRendering() ) );
+
+    _readerRetryTimer.setSingleShot( true );
+    _readerRetryTimer.setInterval( READER_RETRY_MILLISEC );
+
+    connect( &_readerRetryTimer, SIGNAL( timeout()          ),
+             this,               SLOT  ( retryShowDetails() ) );
+
     // DO NOT add anything like 'font-size: small' here; that makes the text
     // unreadable for everybody over 40 years of age.
 
@@ -80,7 +106,177 @@ YQPkgGenericDetailsView::YQPkgGenericDetailsView( QWidget * parent )
 
 YQPkgGenericDetailsView::~YQPkgGenericDetailsView()
 {
-    // NOP
+    stopRendering(); // Just in case a derived class didn't
+}
+
+
+void
+YQPkgGenericDetailsView::showDetails( ZyppSel selectable )
+{
+    _selectable = selectable;
+    _renderTimer.stop();
+    _readerRetryTimer.stop();
+
+    if ( ! selectable )
+    {
+        clear();
+        return;
+    }
+
+    if ( PoolReaderThread::isBlocked() )
+    {
+        // The resolver is busy with the pool in its worker thread. Even the
+        // cache lookup reads the package status, so wait until it's done.
+
+        _readerRetryTimer.start();
+        return;
+    }
+
+    // Selectables are only valid for the current pool content
+
+    if ( _poolSerial.remember( zypp::sat::Pool::instance().serial() ) )
+        _htmlCache.clear();
+
+    const QString * cachedHtml = _htmlCache.object( cacheKey( selectable ) );
+
+    if ( cachedHtml )
+    {
+        setHtml( *cachedHtml );
+        return;
+    }
+
+    if ( ! renderInThread() )
+    {
+        // Rendering may load repodata into the pool, so not while any
+        // pool reader thread is active either
+
+        if ( ! PoolReaderThread::canStart() )
+        {
+            _readerRetryTimer.start();
+            return;
+        }
+
+        QString * html = new QString( renderHtml( selectable ) );
+        CHECK_NEW( html );
+
+        setHtml( *html );
+        _htmlCache.insert( cacheKey( selectable ), html ); // takes ownership
+        return;
+    }
+
+    // Show at least the heading until the rest is rendered
+
+    setHtml( htmlStart() + htmlHeading( selectable ) + htmlEnd() );
+
+    if ( _renderWorker )
+    {
+        // Still busy with another selectable: Stop that (if it still can)
+        // and continue with this one when it's finished.
+
+        if ( _renderWorker->selectable() != selectable )
+            _renderWorker->requestInterruption();
+    }
+    else
+    {
+        _renderTimer.start();
+    }
+}
+
+
+void
+YQPkgGenericDetailsView::startRendering()
+{
+    if ( _renderWorker || ! _selectable )
+        return;
+
+    if ( ! PoolReaderThread::canStart() )
+    {
+        _readerRetryTimer.start();
+        return;
+    }
+
+#if VERBOSE_DETAILS_VIEWS
+    logVerbose() << metaObject()->className() << ": Rendering "
+                 << _selectable->name() << endl;
+#endif
+
+    _renderWorker = new PkgDetailsRenderWorker( this, _selectable, cacheKey( _selectable ) );
+    CHECK_NEW( _renderWorker );
+
+    connect( _renderWorker, SIGNAL( finished()      ),
+             this,          SLOT  ( renderingDone() ) );
+
+    _renderWorker->start();
+}
+
+
+void
+YQPkgGenericDetailsView::renderingDone()
+{
+    PkgDetailsRenderWorker * worker = _renderWorker;
+
+    if ( ! worker )
+        return;
+
+    _renderWorker = 0;
+    worker->deleteLater();
+
+    if ( worker->isInterruptionRequested() )
+    {
+        // The selection moved on while rendering, or the resolver needs
+        // the pool: The result might be incomplete, so don't use it.
+        // Render the current selectable again (or later).
+
+        if ( _selectable )
+            showDetails( _selectable );
+
+        return;
+    }
+
+    _htmlCache.insert( worker->cacheKey(), new QString( worker->html() ) );
+
+    if ( worker->selectable() == _selectable )
+        setHtml( worker->html() );
+    else if ( _selectable )
+        showDetails( _selectable );
+}
+
+
+void
+YQPkgGenericDetailsView::retryShowDetails()
+{
+    if ( _selectable )
+        showDetails( _selectable );
+}
+
+
+void
+YQPkgGenericDetailsView::stopRendering()
+{
+    _renderTimer.stop();
+    _readerRetryTimer.stop();
+
+    if ( _renderWorker )
+    {
+        _renderWorker->disconnect( this );
+        _renderWorker->requestInterruption();
+
+        delete _renderWorker; // This waits for the thread to finish
+        _renderWorker = 0;
+    }
+}
+
+
+PkgDetailsCacheKey
+YQPkgGenericDetailsView::cacheKey( ZyppSel selectable )
+{
+    PkgDetailsCacheKey key;
+
+    key.selectable = selectable.get();
+    key.candidate  = selectable ? selectable->candidateObj().resolvable().get() : 0;
+    key.status     = selectable ? (int) selectable->status() : -1;
+
+    return key;
 }
 
 
@@ -243,3 +439,32 @@ YQPkgGenericDetailsView::hcell( QString contents )
 }
 
 
+
+//
+//----------------------------------------------------------------------
+//
+
+
+PkgDetailsRenderWorker::PkgDetailsRenderWorker( YQPkgGenericDetailsView *  view,
+                                                ZyppSel                    selectable,
+                                                const PkgDetailsCacheKey & cacheKey )
+    : PoolReaderThread()
+    , _view( view )
+    , _selectable( selectable )
+    , _cacheKey( cacheKey )
+{
+    // NOP
+}
+
+
+PkgDetailsRenderWorker::~PkgDetailsRenderWorker()
+{
+    wait();
+}
+
+
+void
+PkgDetailsRenderWorker::readPool()
+{
+    _html = _view->renderHtml( _selectable );
+}
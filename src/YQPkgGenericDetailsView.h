@@ -19,25 +19,136 @@
 
 
 #include <zypp-core/Date.h>
+#include <zypp/base/SerialNumber.h>
 
 #include "YQZypp.h"
+#include "PoolReaderThread.h"
+#include <QCache>
 #include <QTextBrowser>
+#include <QTimer>
 
 
 class QTabWidget;
+class YQPkgGenericDetailsView;
 
 using std::string;
 
 
+/**
+ * Key for the HTML cache of a details view: The HTML depends on the
+ * selectable, its candidate (which the user can change in the versions
+ * view) and its status.
+ **/
+struct PkgDetailsCacheKey
+{
+    const void * selectable;
+    const void * candidate;
+    int          status;
+
+    bool operator==( const PkgDetailsCacheKey & other ) const
+    {
+        return selectable == other.selectable &&
+               candidate  == other.candidate  &&
+               status     == other.status;
+    }
+};
+
+
+inline size_t qHash( const PkgDetailsCacheKey & key, size_t seed = 0 )
+{
+    return qHashMulti( seed, key.selectable, key.candidate, key.status );
+}
+
+
+/**
+ * Worker thread to render the HTML of a details view for one selectable
+ * with YQPkgGenericDetailsView::renderHtml() without blocking the GUI
+ * thread. When it is done, the inherited QThread::finished() signal is
+ * emitted.
+ *
+ * Use QThread::requestInterruption() when the result is no longer needed.
+ * Views with expensive loops check for that and stop early.
+ *
+ * Rendering change logs or file lists loads that repodata into the pool,
+ * so this must not run at the same time as the dependency resolver; see
+ * PoolReaderThread. The worker counts as an active pool reader from its
+ * construction on, not only once the thread runs.
+ **/
+class PkgDetailsRenderWorker: public PoolReaderThread
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor. Call start() to start rendering.
+     **/
+    PkgDetailsRenderWorker( YQPkgGenericDetailsView *  view,
+                            ZyppSel                    selectable,
+                            const PkgDetailsCacheKey & cacheKey );
+
+    /**
+     * Destructor. This waits for the thread to finish.
+     **/
+    virtual ~PkgDetailsRenderWorker();
+
+    /**
+     * Return the selectable that this worker renders.
+     **/
+    ZyppSel selectable() const { return _selectable; }
+
+    /**
+     * Return the cache key of the selectable when rendering was started.
+     **/
+    const PkgDetailsCacheKey & cacheKey() const { return _cacheKey; }
+
+    /**
+     * Return the rendered HTML. Only call this after the thread is finished.
+     **/
+    const QString & html() const { return _html; }
+
+
+protected:
+
+    /**
+     * Render the HTML. This is executed in the worker thread.
+     *
+     * Implemented from PoolReaderThread.
+     **/
+    virtual void readPool() override;
+
+
+    //
+    // Data members
+    //
+
+    YQPkgGenericDetailsView * _view;
+    ZyppSel                   _selectable;
+    PkgDetailsCacheKey        _cacheKey;
+    QString                   _html;
+};
+
+
 /**
  * Abstract base class for details views. Handles generic stuff like HTML
  * formatting, Qt slots and display only if this view is visible at all: It may
  * be hidden if it's part of a QTabWidget.
+ *
+ * Derived classes only generate the HTML in renderHtml(). This class keeps
+ * the most recently used results in a cache, and it calls renderHtml() in a
+ * worker thread (unless renderInThread() returns 'false'), only after the
+ * selection stayed on the same item for a moment: Holding down the arrow key
+ * in a package list does not render each item that is passed.
+ *
+ * While the dependency resolver is busy with the pool, all of that waits
+ * until it is done, including views that render in the GUI thread.
  **/
 class YQPkgGenericDetailsView : public QTextBrowser
 {
     Q_OBJECT
 
+    friend class PkgDetailsRenderWorker;
+
 protected:
 
     /**
@@ -124,10 +235,10 @@ public slots:
     // slot clear() inherited from QTextEdit
 
     /**
-     * Show details for the specified package.
-     * Reimplement this in derived classes.
+     * Show details for the specified package: Use the cached HTML if there
+     * is any, otherwise render it with renderHtml().
      **/
-    virtual void showDetails( ZyppSel selectable ) = 0;
+    virtual void showDetails( ZyppSel selectable );
 
 
 
@@ -137,11 +248,66 @@ protected slots:
 
     virtual void reload() { QTextBrowser::reload(); }
 
+    /**
+     * Start a worker thread to render the HTML for the current selectable.
+     **/
+    void startRendering();
+
+    /**
+     * Called when the render worker thread is finished.
+     **/
+    void renderingDone();
+
+    /**
+     * Show the details of the current selectable again after that had to
+     * wait for the dependency resolver.
+     **/
+    void retryShowDetails();
+
 
 protected:
 
-    QTabWidget * _parentTab;
-    ZyppSel      _selectable;
+    /**
+     * Return the HTML for 'selectable' (which is never 0).
+     * Implement this in derived classes.
+     *
+     * Unless renderInThread() returns 'false', this is called in a worker
+     * thread, so it must not access any widgets, QPixmaps or other
+     * GUI-thread-only data. Expensive loops should stop early if
+     * QThread::currentThread()->isInterruptionRequested().
+     **/
+    virtual QString renderHtml( ZyppSel selectable ) = 0;
+
+    /**
+     * Return 'true' if renderHtml() can be called in a worker thread.
+     * Derived classes can reimplement this.
+     **/
+    virtual bool renderInThread() const { return true; }
+
+    /**
+     * Stop the render worker thread and wait for it.
+     *
+     * Call this in the destructor of each derived class: The worker thread
+     * calls renderHtml() of the derived class, so it has to be finished
+     * before any part of the derived class is destroyed.
+     **/
+    void stopRendering();
+
+    /**
+     * Return the cache key for 'selectable' in its current state.
+     **/
+    static PkgDetailsCacheKey cacheKey( ZyppSel selectable );
+
+
+    // Data members
+
+    QTabWidget *                         _parentTab;
+    ZyppSel                              _selectable;
+    QCache<PkgDetailsCacheKey, QString>  _htmlCache;
+    zypp::SerialNumberWatcher            _poolSerial;
+    QTimer                               _renderTimer;
+    QTimer                               _readerRetryTimer;
+    PkgDetailsRenderWorker *             _renderWorker;
 };
 
 
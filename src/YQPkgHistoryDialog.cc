@@ -15,25 +15,25 @@
 
 
 #include <QBoxLayout>
-#include <QEventLoop>
+#include <QDate>
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QLineEdit>
 #include <QList>
+#include <QLocale>
 #include <QMessageBox>
 #include <QPushButton>
-#include <QSignalBlocker>
 #include <QSplitter>
+#include <QStandardPaths>
 #include <QTreeWidget>
 
-#include <zypp-core/Date.h>
-#include <zypp-core/Pathname.h>
 #include <zypp-core/Url.h>
-#include <zypp-core/base/Exception.h>
-#include <zypp/parser/HistoryLogReader.h>
 #include <zypp/Edition.h>
 
+#include "Exception.h"
 #include "Logger.h"
 #include "MainWindow.h"
+#include "PkgHistoryIndex.h"
 #include "QY2CursorHelper.h"
 #include "YQIconPool.h"
 #include "YQi18n.h"
@@ -46,11 +46,14 @@
 #define MARGIN		9	// around the widget
 
 #define FILENAME	"/var/log/zypp/history"
+#define CACHE_FILENAME  "zypp-history.index"  // in ~/.cache/openSUSE/Myrlyn
 
 
 
 YQPkgHistoryDialog::YQPkgHistoryDialog( QWidget * parent )
     : QDialog( parent ? parent : MainWindow::instance() )
+    , _index( 0 )
+    , _worker( 0 )
 {
     // Dialog title
     setWindowTitle( _( "Package History" ) );
@@ -75,6 +78,16 @@ YQPkgHistoryDialog::YQPkgHistoryDialog( QWidget * parent )
     layout->addWidget( label );
 
 
+    // Package name filter
+
+    _filterEdit = new QLineEdit( this );
+    CHECK_NEW( _filterEdit );
+    layout->addWidget( _filterEdit );
+    _filterEdit->setPlaceholderText( _( "Filter by package name" ) );
+    _filterEdit->setClearButtonEnabled( true );
+    _filterEdit->setEnabled( false ); // Until the history is read
+
+
     // Splitter between the trees
 
     QSplitter * splitter = new QSplitter( Qt::Horizontal, this );
@@ -90,12 +103,13 @@ YQPkgHistoryDialog::YQPkgHistoryDialog( QWidget * parent )
     _datesTree->setRootIsDecorated( false );
 
 
-    // Tree for the actions: Action items below a date item parent
+    // Flat list for the actions of the selected date
 
     _actionsTree = new QTreeWidget( splitter );
     _actionsTree->setColumnCount( 2 );
     _actionsTree->setHeaderLabels( QStringList( _( "Action" ) ) << _( "Version/URL" ) );
     _actionsTree->setColumnWidth( 0, 350 );
+    _actionsTree->setRootIsDecorated( false );
 
 
     // Horizontal stretch factors for each tree in the splitter
@@ -127,170 +141,245 @@ YQPkgHistoryDialog::YQPkgHistoryDialog( QWidget * parent )
     connect( _datesTree,        SIGNAL( itemSelectionChanged() ),
 	    this,               SLOT  ( selectDate()           ) );
 
-    connect( _actionsTree,      SIGNAL( itemSelectionChanged() ),
-	    this,               SLOT  ( selectAction()         ) );
+    connect( _filterEdit,       SIGNAL( textChanged( QString ) ),
+             this,              SLOT  ( filterChanged()        ) );
 }
 
 
-void
-YQPkgHistoryDialog::showHistoryDialog( QWidget* parent)
+YQPkgHistoryDialog::~YQPkgHistoryDialog()
 {
-    YQPkgHistoryDialog dialog( parent );
+    if ( _worker )
+    {
+        // The dialog was closed while the history was still being read
 
-    // Give instant feedback: Show the dialog and process the "show" event
-    // immediately so the window opens immediately (albeit empty)
+        _worker->requestInterruption();
+        delete _worker; // This waits for the thread to finish
+        normalCursor();
+    }
 
-    dialog.show();
-    QEventLoop eventLoop;
-    eventLoop.processEvents( QEventLoop::ExcludeUserInputEvents,
-			     200 ); // millisec
+    delete _index;
+}
 
-    busyCursor();
-    dialog.populate(); // This takes a moment
-    normalCursor();
 
+void
+YQPkgHistoryDialog::showHistoryDialog( QWidget* parent)
+{
+    YQPkgHistoryDialog dialog( parent );
+
+    dialog.startReading(); // This does not block
     dialog.exec();
 }
 
 
 void
-YQPkgHistoryDialog::populate()
+YQPkgHistoryDialog::startReading()
 {
-    YQPkgHistoryItemCollector itemCollector( _datesTree, _actionsTree );
-    zypp::parser::HistoryLogReader reader( FILENAME,
-                                           zypp::parser::HistoryLogReader::Options(),
-                                           itemCollector );
-    try
-    {
-	reader.readAll();
-    }
-    catch (  const zypp::Exception & exception )
-    {
-        logWarning() << "CAUGHT zypp exception: " << exception.asUserHistory() << endl;
-        showReadHistoryWarning( fromUTF8( exception.asUserHistory() ) );
-    }
+    _index  = new PkgHistoryIndex( FILENAME );
+    CHECK_NEW( _index );
+
+    _index->setCacheFile( QStandardPaths::writableLocation( QStandardPaths::CacheLocation )
+                          + "/" + CACHE_FILENAME );
+
+    _worker = new PkgHistoryWorker( _index, this );
+    CHECK_NEW( _worker );
+
+    connect( _worker, SIGNAL( finished()    ),
+             this,    SLOT  ( readingDone() ) );
+
+    busyCursor();
+    _worker->start();
 }
 
 
 void
-YQPkgHistoryDialog::showReadHistoryWarning( const QString & message )
+YQPkgHistoryDialog::readingDone()
 {
-    QMessageBox msgBox;
+    bool success = _worker->success();
 
-    // Translators: This is a (short) text indicating that something went
-    // wrong while trying to read the history file.
+    _worker->deleteLater();
+    _worker = 0;
+    normalCursor();
 
-    QString heading = _( "Unable to read history" );
+    if ( ! success )
+        showReadHistoryWarning( _index->errorMessage() );
 
-    if (  heading.length() < 25 )    // Avoid very narrow message boxes
+    _filterEdit->setEnabled( true );
+    fillDatesTree();
+
+    // Select the latest date
+
+    int count = _datesTree->topLevelItemCount();
+
+    if ( count > 0 )
     {
-        QString blanks;
-        blanks.fill( ' ', 50 - heading.length() );
-        heading += blanks;
+        QTreeWidgetItem * item = _datesTree->topLevelItem( count - 1 );
+        _datesTree->setCurrentItem( item );
+        _datesTree->scrollToItem( item );
     }
-
-    msgBox.setText( heading );
-    msgBox.setIcon( QMessageBox::Warning );
-    msgBox.setInformativeText( message );
-    msgBox.exec();
 }
 
 
 void
-YQPkgHistoryDialog::selectDate()
+YQPkgHistoryDialog::fillDatesTree()
 {
-    QString item = _datesTree->selectedItems().first()->text( 0 );
-    QList<QTreeWidgetItem *> items = _actionsTree->findItems( item, Qt::MatchExactly, 0);
+    _datesTree->clear();
+    _actionsTree->clear();
 
-    if ( items.size() > 0 )
+    if ( ! _index )
+        return;
+
+    const QVector<PkgHistoryIndex::Day> & days = _index->days();
+    QList<QTreeWidgetItem *> items;
+
+    if ( _filterEdit->text().trimmed().isEmpty() )
+    {
+        for ( int dayNo = 0; dayNo < days.size(); ++dayNo )
+        {
+            QTreeWidgetItem * item = new QTreeWidgetItem( QStringList( formatDate( days[ dayNo ].date ) ) );
+            item->setData( 0, Qt::UserRole, dayNo );
+            items << item;
+        }
+    }
+    else
     {
-        QSignalBlocker sigBlocker( this );
+        // The records are in ascending order, so are their days
+
+        const QVector<PkgHistoryIndex::Record> & records = _index->records();
+        int lastDayNo = -1;
+
+        for ( int recordNo: _filterRecords )
+        {
+            int dayNo = (int) records[ recordNo ].day;
 
-	_actionsTree->expandItem( items.first() );
-	_actionsTree->setCurrentItem( items.first() );
-	_actionsTree->scrollToItem( items.first(), QAbstractItemView::PositionAtTop );
+            if ( dayNo != lastDayNo )
+            {
+                QTreeWidgetItem * item = new QTreeWidgetItem( QStringList( formatDate( days[ dayNo ].date ) ) );
+                item->setData( 0, Qt::UserRole, dayNo );
+                items << item;
+
+                lastDayNo = dayNo;
+            }
+        }
     }
+
+    _datesTree->addTopLevelItems( items );
 }
 
 
 void
-YQPkgHistoryDialog::selectAction()
+YQPkgHistoryDialog::fillActionsTree( int dayNo )
 {
-    QTreeWidgetItem * item = _actionsTree->selectedItems().first();
+    _actionsTree->clear();
 
-    // if this is not a top-level item, better pick a top-level one
+    if ( ! _index )
+        return;
 
-    if ( item->parent() )
-	item = item->parent();
+    QVector<int> recordNos;
 
-    QList<QTreeWidgetItem *> items = _datesTree->findItems( item->text( 0 ),
-                                                            Qt::MatchExactly | Qt::MatchRecursive,
-                                                            0 );
-    if (  items.size() > 0 )
+    if ( _filterEdit->text().trimmed().isEmpty() )
     {
-        QSignalBlocker sigBlocker( this );
-	_datesTree->setCurrentItem( items.first());
+        recordNos = _index->dayRecords( dayNo );
     }
-}
+    else
+    {
+        const QVector<PkgHistoryIndex::Record> & records = _index->records();
 
+        for ( int recordNo: _filterRecords )
+        {
+            if ( (int) records[ recordNo ].day == dayNo )
+                recordNos << recordNo;
+        }
+    }
 
-//
-//----------------------------------------------------------------------
-//
+    QList<QTreeWidgetItem *> items;
 
+    for ( const zypp::HistoryLogData::Ptr & item_ptr: _index->readRecords( recordNos ) )
+    {
+        QStringList columns = actionColumns( item_ptr );
+
+        if ( ! columns.isEmpty() )
+        {
+            QTreeWidgetItem * actionItem = new QTreeWidgetItem( columns );
+            actionItem->setIcon( 0, actionIcon( item_ptr->action() ) );
+            items << actionItem;
+        }
+    }
 
-YQPkgHistoryItemCollector::YQPkgHistoryItemCollector( QTreeWidget * datesTree,
-                                                      QTreeWidget * actionsTree )
-    : _datesTree( datesTree )
-    , _actionsTree( actionsTree )
-    , _actionsDateItem(0)
-{
-    // NOP
+    _actionsTree->addTopLevelItems( items );
 }
 
 
-bool
-YQPkgHistoryItemCollector::operator() ( const zypp::HistoryLogData::Ptr & item_ptr )
+QString
+YQPkgHistoryDialog::formatDate( const QByteArray & date ) const
 {
-    QString actionDate = fromUTF8( item_ptr->date().form( "%e %B %Y" ) );
+    QDate qDate = QDate::fromString( QString::fromLatin1( date ), Qt::ISODate );
 
-    if ( actionDate != _lastDate ) // First action for a new date?
-    {
-        addDatesTreeItem( actionDate );
-        addActionsDateItem( actionDate );
+    if ( ! qDate.isValid() )
+        return QString::fromLatin1( date );
 
-        _lastDate = actionDate;
-    }
+    return QLocale().toString( qDate, "d MMMM yyyy" );
+}
+
+
+void
+YQPkgHistoryDialog::showReadHistoryWarning( const QString & message )
+{
+    QMessageBox msgBox;
 
-    QStringList columns = actionColumns( item_ptr );
+    // Translators: This is a (short) text indicating that something went
+    // wrong while trying to read the history file.
 
-    if ( ! columns.isEmpty() )
+    QString heading = _( "Unable to read history" );
+
+    if (  heading.length() < 25 )    // Avoid very narrow message boxes
     {
-        QTreeWidgetItem * actionItem = new QTreeWidgetItem( _actionsDateItem, columns );
-        actionItem->setIcon( 0, actionIcon( item_ptr->action() ) );
+        QString blanks;
+        blanks.fill( ' ', 50 - heading.length() );
+        heading += blanks;
     }
 
-    return true;
+    msgBox.setText( heading );
+    msgBox.setIcon( QMessageBox::Warning );
+    msgBox.setInformativeText( message );
+    msgBox.exec();
 }
 
 
 void
-YQPkgHistoryItemCollector::addDatesTreeItem( const QString & actionDate )
+YQPkgHistoryDialog::selectDate()
 {
-    new QTreeWidgetItem( _datesTree, QStringList( actionDate ) );
+    QTreeWidgetItem * item = _datesTree->currentItem();
+
+    if ( item )
+        fillActionsTree( item->data( 0, Qt::UserRole ).toInt() );
+    else
+        _actionsTree->clear();
 }
 
 
 void
-YQPkgHistoryItemCollector::addActionsDateItem( const QString & actionDate )
+YQPkgHistoryDialog::filterChanged()
 {
-    _actionsDateItem = new QTreeWidgetItem( _actionsTree, QStringList( actionDate ) );
-    _actionsDateItem->setExpanded( true );
+    QString pattern = _filterEdit->text().trimmed();
+
+    if ( pattern.isEmpty() )
+        _filterRecords.clear();
+    else if ( _index )
+        _filterRecords = _index->pkgRecords( pattern );
+
+    fillDatesTree();
+
+    // Select the latest matching date
+
+    int count = _datesTree->topLevelItemCount();
+
+    if ( count > 0 )
+        _datesTree->setCurrentItem( _datesTree->topLevelItem( count - 1 ) );
 }
 
 
 QStringList
-YQPkgHistoryItemCollector::actionColumns( const zypp::HistoryLogData::Ptr & item_ptr )
+YQPkgHistoryDialog::actionColumns( const zypp::HistoryLogData::Ptr & item_ptr )
 {
     QStringList columns;
 
@@ -363,7 +452,7 @@ YQPkgHistoryItemCollector::actionColumns( const zypp::HistoryLogData::Ptr & item
 
 
 QPixmap
-YQPkgHistoryItemCollector::actionIcon( zypp::HistoryActionID id )
+YQPkgHistoryDialog::actionIcon( zypp::HistoryActionID id )
 {
     switch ( id.toEnum() )
     {
@@ -18,16 +18,25 @@
 #define YQPkgHistoryDialog_h
 
 #include <QDialog>
+#include <QVector>
 #include <zypp/HistoryLogData.h>
 
+class PkgHistoryIndex;
+class PkgHistoryWorker;
+class QLineEdit;
 class QObject;
 class QTreeWidget;
-class QTreeWidgetItem;
 class QWidget;
 
 
 /**
  * Pkg status and History as a standalone popup dialog.
+ *
+ * The history file is scanned into a PkgHistoryIndex in a worker thread, so
+ * the dialog opens immediately even for a very long history. The index is
+ * cached in ~/.cache/openSUSE/Myrlyn, so only new actions need to be
+ * scanned the next time. The actions are only read from the file for the
+ * date that the user selects.
  **/
 class YQPkgHistoryDialog : public QDialog
 {
@@ -40,6 +49,11 @@ public:
      **/
     static void showHistoryDialog( QWidget* parent = 0);
 
+    /**
+     * Destructor.
+     **/
+    virtual ~YQPkgHistoryDialog();
+
 
 protected:
 
@@ -50,69 +64,32 @@ protected:
     YQPkgHistoryDialog( QWidget * parent );
 
     /**
-     * Fill the trees with content.
+     * Start scanning the history file in a worker thread.
+     * readingDone() is called when that is finished.
      **/
-    void populate();
+    void startReading();
 
     /**
-     * Show a warning pop-up if there was an error reading the history file.
+     * Fill the dates tree with all dates or, if there is a package name
+     * filter, with the dates with actions for matching packages.
      **/
-    void showReadHistoryWarning( const QString & message );
-
-
-protected slots:
-
-    void selectDate();
-    void selectAction();
-
-
-protected:
-
-    // Data members
-
-    QTreeWidget * _datesTree;   // Flat list for dates
-    QTreeWidget * _actionsTree; // Tree with action items below date items
-};
-
-
-/**
- * Helper class to populate both tree widgets in this dialog with zypp history
- * actions.
- *
- * This is used as a functor for a zypp::parser::HistoryLogReader where it is
- * called for each history item found while parsing the history file.
- **/
-class YQPkgHistoryItemCollector
-{
-public:
+    void fillDatesTree();
 
     /**
-     * Constructor. This stores the widget pointers so items can later be added
-     * to those trees when libzypp calls operator() for each history item.
+     * Fill the actions tree with the actions of day 'dayNo' in the index
+     * that match the package name filter (if there is one).
      **/
-    YQPkgHistoryItemCollector( QTreeWidget * datesTree,
-                               QTreeWidget * actionsTree );
+    void fillActionsTree( int dayNo );
 
     /**
-     * Functor method that is called by zypp::parser::HistoryLogReader for each
-     * history item (for each action). This will add an item for the action
-     * and, if needed, a parent item for the date and an item in the dates
-     * tree.
+     * Format a date "yyyy-MM-dd" from the history file for the user.
      **/
-    bool operator() ( const zypp::HistoryLogData::Ptr & item_ptr );
-
-protected:
+    QString formatDate( const QByteArray & date ) const;
 
     /**
-     * Add one item in the "dates" tree for the specified date.
-     **/
-    void addDatesTreeItem  ( const QString & actionDate );
-
-    /**
-     * Add one item in the "actions" tree for the specified date.
-     * This item will act as the parent item for all actions on that date.
+     * Show a warning pop-up if there was an error reading the history file.
      **/
-    void addActionsDateItem( const QString & actionDate );
+    void showReadHistoryWarning( const QString & message );
 
     /**
      * Format columns for one action, depending on the action type.
@@ -120,20 +97,39 @@ protected:
      * Return an empty QStringList if this is not an action that is suitable to
      * be shown to the user.
      **/
-    QStringList actionColumns( const zypp::HistoryLogData::Ptr & item_ptr );
+    static QStringList actionColumns( const zypp::HistoryLogData::Ptr & item_ptr );
 
     /**
      * Return a suitable icon for an action.
      **/
-    QPixmap actionIcon( zypp::HistoryActionID id );
+    static QPixmap actionIcon( zypp::HistoryActionID id );
+
+
+protected slots:
+
+    /**
+     * Called when the worker thread is done scanning the history file.
+     **/
+    void readingDone();
+
+    void selectDate();
 
+    /**
+     * Apply the package name filter from the filter line edit.
+     **/
+    void filterChanged();
+
+
+protected:
 
     // Data members
 
-    QTreeWidget *     _datesTree;
-    QTreeWidget *     _actionsTree;
-    QTreeWidgetItem * _actionsDateItem;  // parent item for all actions of this date
-    QString           _lastDate;         // initialized empty like all QStrings
+    QTreeWidget *      _datesTree;       // Flat list for dates
+    QTreeWidget *      _actionsTree;     // Flat list for the actions of one date
+    QLineEdit *        _filterEdit;
+    PkgHistoryIndex *  _index;
+    PkgHistoryWorker * _worker;
+    QVector<int>       _filterRecords;   // Index records matching the filter
 };
 
 
@@ -27,7 +27,7 @@
 #endif
 
 
-YQPkgLangList::YQPkgLangList( QWidget * parent )
+YQPkgLangList::YQPkgLangList( QWidget * parent, bool autoFill )
     : YQPkgObjList( parent )
 {
     // FIXME: The base class works with zypp::Resolvable, but zypp::Locale
@@ -64,9 +64,11 @@ YQPkgLangList::YQPkgLangList( QWidget * parent )
                                                QTreeWidgetItem * ) ),
              this, SLOT  ( filter() ) );
 
-    fillList();
-    selectSomething();
-    resizeColumnToContents(_statusCol);
+    if ( autoFill )
+    {
+        fillList();
+        selectSomething();
+    }
 
     logVerbose() << "Creating language list done" << endl;
 }
@@ -93,6 +95,8 @@ YQPkgLangList::fillList()
         addLangItem( *it );
     }
 
+    resizeColumnToContents( _statusCol );
+
     // logVerbose() << "Language list filled" << endl;
 }
 
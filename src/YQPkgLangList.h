@@ -32,9 +32,12 @@ class YQPkgLangList : public YQPkgObjList
 public:
 
     /**
-     * Constructor
+     * Constructor.
+     *
+     * Set 'autoFill' to 'false' if you don't want the list to be filled in the
+     * constructor. In that case, use fillList() when it is needed.
      **/
-    YQPkgLangList( QWidget * parent );
+    YQPkgLangList( QWidget * parent, bool autoFill = true );
 
     /**
      * Destructor
@@ -44,6 +47,11 @@ public:
 
 public slots:
 
+    /**
+     * Fill the language list.
+     **/
+    void fillList();
+
     /**
      * Notification that a new filter is the one to be shown.
      **/
@@ -97,14 +105,6 @@ signals:
      * Emitted when filtering is finished.
      **/
     void filterFinished();
-
-
-protected slots:
-
-    /**
-     * Fill the language list.
-     **/
-    void fillList();
 };
 
 
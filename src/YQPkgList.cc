@@ -20,6 +20,8 @@
 #include <QMenu>
 
 #include "Logger.h"
+#include "PoolReaderThread.h"
+#include "PoolStats.h"
 #include "QY2CursorHelper.h"
 #include "YQi18n.h"
 #include "utf8.h"
@@ -133,15 +135,7 @@ YQPkgList::addPkgItem( ZyppSel  selectable,
 bool
 YQPkgList::haveInstalledPkgs()
 {
-    for ( ZyppPoolIterator it = zyppPkgBegin();
-          it != zyppPkgEnd();
-          ++it )
-    {
-        if ( (*it)->installedObj() )
-            return true;
-    }
-
-    return false;
+    return PoolStats::instance()->haveInstalledPkgs();
 }
 
 
@@ -443,6 +437,24 @@ int
 YQPkgList::globalSetPkgStatus( ZyppStatus newStatus, bool force, bool countOnly )
 {
     busyCursor();
+    int changedCount = setPoolPkgStatus( newStatus, force, countOnly );
+
+    if ( changedCount > 0 && ! countOnly )
+    {
+        emit updateItemStates();
+        emit updatePackages();
+        emit statusChanged();
+    }
+
+    normalCursor();
+
+    return changedCount;
+}
+
+
+int
+YQPkgList::setPoolPkgStatus( ZyppStatus newStatus, bool force, bool countOnly )
+{
     int changedCount = 0;
 
     for ( ZyppPoolIterator it = zyppPkgBegin();
@@ -495,7 +507,10 @@ YQPkgList::globalSetPkgStatus( ZyppStatus newStatus, bool force, bool countOnly
             if ( doChange )
             {
                 if ( ! countOnly && oldStatus != S_Protected )
+                {
                     selectable->setStatus( newStatus );
+                    PoolStats::instance()->invalidate();
+                }
 
                 changedCount++;
                 // logInfo() << "Updating " << selectable->name() << endl;
@@ -503,15 +518,6 @@ YQPkgList::globalSetPkgStatus( ZyppStatus newStatus, bool force, bool countOnly
         }
     }
 
-    if ( changedCount > 0 && ! countOnly )
-    {
-        emit updateItemStates();
-        emit updatePackages();
-        emit statusChanged();
-    }
-
-    normalCursor();
-
     return changedCount;
 }
 
@@ -553,6 +559,9 @@ YQPkgListItem::updateData()
 QString
 YQPkgListItem::toolTip( int col )
 {
+    if ( PoolReaderThread::isBlocked() ) // The resolver is busy with the pool
+        return QString();
+
     QString text;
     QString name = _zyppObj->name().c_str();
 
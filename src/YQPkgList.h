@@ -60,6 +60,7 @@ public:
 
     /**
      * Returns 'true' if there are any installed packages.
+     * This is cached in PoolStats.
      **/
     static bool haveInstalledPkgs();
 
@@ -78,6 +79,14 @@ public:
      **/
     int globalSetPkgStatus( ZyppStatus newStatus, bool force, bool countOnly );
 
+    /**
+     * The pool-wide part of globalSetPkgStatus() without any signals or
+     * busy cursor, so other package list classes can use it as well.
+     *
+     * Return value: The number of status changes
+     **/
+    static int setPoolPkgStatus( ZyppStatus newStatus, bool force, bool countOnly );
+
 
     /**
      * Reimplemented from QListView / QWidget:
@@ -0,0 +1,1968 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#include <algorithm>
+#include <numeric>      // std::iota()
+#include <utility>      // std::make_pair()
+#include <vector>
+
+#include <QAction>
+#include <QApplication>
+#include <QFontMetrics>
+#include <QHeaderView>
+#include <QKeyEvent>
+#include <QMenu>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "QY2CursorHelper.h"
+#include "YQPkgList.h"
+#include "YQPkgTextDialog.h"
+#include "YQi18n.h"
+#include "utf8.h"
+
+#include "YQPkgListView.h"
+
+
+#define STATUS_ICON_SIZE        16
+#define STATUS_COL_WIDTH        28
+#define MAGIC_MISSING_WIDTH     15
+
+
+YQPkgListModel::YQPkgListModel( YQPkgListView * parent )
+    : QAbstractItemModel( parent )
+    , _view( parent )
+    , _rowIndexValid( false )
+    , _statesFrozen( false )
+    , _statusCol( -1 )
+    , _nameCol( -1 )
+    , _summaryCol( -1 )
+    , _versionCol( -1 )
+    , _instVersionCol( -1 )
+    , _sizeCol( -1 )
+{
+    int numCol = 0;
+
+    _headers << "";                _statusCol  = numCol++;
+    _headers << _( "Package"    ); _nameCol    = numCol++;
+    _headers << _( "Summary"    ); _summaryCol = numCol++;
+
+    if ( YQPkgList::haveInstalledPkgs() )
+    {
+        // Combined column for both versions: 1.2.3 (1.2.4)
+
+        _headers << _( "Installed (Available)" ); _instVersionCol = numCol++;
+        _versionCol = _instVersionCol;
+    }
+    else
+    {
+        _headers << _( "Version" ); _versionCol = numCol++;
+    }
+
+    _headers << _( "Size" ); _sizeCol = numCol++;
+}
+
+
+YQPkgListModel::~YQPkgListModel()
+{
+    // NOP
+}
+
+
+bool
+YQPkgListModel::makeRow( ZyppSel selectable,
+                         ZyppPkg zyppPkg,
+                         bool    dimmed,
+                         Row &   row ) const
+{
+    if ( ! zyppPkg )
+        zyppPkg = tryCastToZyppPkg( selectable->theObj() );
+
+    if ( ! zyppPkg )
+    {
+        logError() << "No package for " << selectable->name() << endl;
+        return false;
+    }
+
+    row.selectable = selectable;
+    row.zyppPkg    = zyppPkg;
+    row.dimmed     = dimmed;
+
+    return true;
+}
+
+
+int
+YQPkgListModel::addPkg( ZyppSel selectable,
+                        ZyppPkg zyppPkg,
+                        bool    dimmed )
+{
+    commitPending(); // Keep the insertion order
+
+    Row newRow;
+
+    if ( ! makeRow( selectable, zyppPkg, dimmed, newRow ) )
+        return -1;
+
+    if ( isExcluded( newRow ) )
+    {
+        _excludedRows.append( newRow );
+        return -1;
+    }
+
+    // If there is a message row, it remains the last one
+
+    int row = _rows.size();
+
+    beginInsertRows( QModelIndex(), row, row );
+    _rows.append( newRow );
+    _rowIndexValid = false;
+    endInsertRows();
+
+    return row;
+}
+
+
+void
+YQPkgListModel::appendPkg( ZyppSel selectable,
+                           ZyppPkg zyppPkg,
+                           bool    dimmed )
+{
+    Row newRow;
+
+    if ( ! makeRow( selectable, zyppPkg, dimmed, newRow ) )
+        return;
+
+    if ( isExcluded( newRow ) )
+        _excludedRows.append( newRow );
+    else
+        _pendingRows.append( newRow );
+}
+
+
+int
+YQPkgListModel::commitPending()
+{
+    int count = _pendingRows.size();
+
+    if ( count == 0 )
+        return 0;
+
+    // If there is a message row, it remains the last one
+
+    int first = _rows.size();
+
+    beginInsertRows( QModelIndex(), first, first + count - 1 );
+    _rows += _pendingRows;
+    _pendingRows.clear();
+    _rowIndexValid = false;
+    endInsertRows();
+
+    return count;
+}
+
+
+void
+YQPkgListModel::clear()
+{
+    beginResetModel();
+
+    _rows.clear();
+    _excludedRows.clear();
+    _pendingRows.clear();
+    _versionIcons.clear();
+    _rowIndex.clear();
+    _rowIndexValid = false;
+    _message.clear();
+
+    endResetModel();
+}
+
+
+void
+YQPkgListModel::setMessage( const QString & text )
+{
+    int row = _rows.size();
+
+    if ( _message.isEmpty() && ! text.isEmpty() )
+    {
+        beginInsertRows( QModelIndex(), row, row );
+        _message = text;
+        endInsertRows();
+    }
+    else if ( ! _message.isEmpty() && text.isEmpty() )
+    {
+        beginRemoveRows( QModelIndex(), row, row );
+        _message.clear();
+        endRemoveRows();
+    }
+    else if ( ! text.isEmpty() )
+    {
+        _message = text;
+        emit dataChanged( index( row, 0 ), index( row, columnCount() - 1 ) );
+    }
+}
+
+
+ZyppSel
+YQPkgListModel::selectable( int row ) const
+{
+    if ( row < 0 || row >= _rows.size() )
+        return ZyppSel();
+
+    return _rows.at( row ).selectable;
+}
+
+
+ZyppPkg
+YQPkgListModel::zyppPkg( int row ) const
+{
+    if ( row < 0 || row >= _rows.size() )
+        return ZyppPkg();
+
+    return _rows.at( row ).zyppPkg;
+}
+
+
+void
+YQPkgListModel::setVersionIcon( int row, const QIcon & icon )
+{
+    if ( row < 0 || row >= _rows.size() || _versionCol < 0 )
+        return;
+
+    const zypp::ui::Selectable * sel = _rows.at( row ).selectable.get();
+
+    if ( icon.isNull() )
+        _versionIcons.remove( sel );
+    else
+        _versionIcons.insert( sel, icon );
+
+    QModelIndex cell = index( row, _versionCol );
+    emit dataChanged( cell, cell, { Qt::DecorationRole } );
+}
+
+
+void
+YQPkgListModel::updateStates()
+{
+    if ( _rows.isEmpty() )
+        return;
+
+    emit dataChanged( index( 0, _statusCol ),
+                      index( _rows.size() - 1, _statusCol ),
+                      { Qt::DecorationRole, Qt::ToolTipRole } );
+}
+
+
+void
+YQPkgListModel::updateStates( const ZyppSelSet & selectables )
+{
+    if ( _rows.isEmpty() || selectables.empty() || _statusCol < 0 )
+        return;
+
+    if ( (int) selectables.size() > _rows.size() / 4 )
+    {
+        // One notification for the whole column is cheaper than looking up
+        // each selectable and notifying for each row separately.
+
+        updateStates();
+        return;
+    }
+
+    if ( ! _rowIndexValid )
+        rebuildRowIndex();
+
+    for ( const ZyppSel & selectable: selectables )
+    {
+        RowIndex::const_iterator it = _rowIndex.constFind( selectable.get() );
+
+        while ( it != _rowIndex.constEnd() && it.key() == selectable.get() )
+        {
+            QModelIndex cell = index( it.value(), _statusCol );
+            emit dataChanged( cell, cell, { Qt::DecorationRole, Qt::ToolTipRole } );
+            ++it;
+        }
+    }
+}
+
+
+void
+YQPkgListModel::rebuildRowIndex()
+{
+    _rowIndex.clear();
+    _rowIndex.reserve( _rows.size() );
+
+    for ( int row = 0; row < _rows.size(); ++row )
+        _rowIndex.insert( _rows.at( row ).selectable.get(), row );
+
+    _rowIndexValid = true;
+}
+
+
+void
+YQPkgListModel::updateData()
+{
+    if ( _rows.isEmpty() )
+        return;
+
+    emit dataChanged( index( 0, 0 ),
+                      index( _rows.size() - 1, columnCount() - 1 ) );
+}
+
+
+void
+YQPkgListModel::freezeStates( int firstCachedRow, int lastCachedRow )
+{
+    _frozenStates.clear();
+    _frozenStates.reserve( _rows.size() + _pendingRows.size() );
+    _frozenDisplay.clear();
+
+    for ( const Row & row: _rows )
+        _frozenStates.insert( row.selectable.get(), poolState( row.selectable ) );
+
+    for ( const Row & row: _pendingRows )
+        _frozenStates.insert( row.selectable.get(), poolState( row.selectable ) );
+
+    firstCachedRow = qMax( firstCachedRow, 0 );
+    lastCachedRow  = qMin( lastCachedRow, (int) _rows.size() - 1 );
+
+    for ( int i = firstCachedRow; i <= lastCachedRow; ++i )
+    {
+        const Row &   row = _rows.at( i );
+        FrozenDisplay display;
+
+        for ( int col = 0; col < columnCount(); ++col )
+        {
+            display.texts       << text( row, col );
+            display.foregrounds << foreground( row, col );
+        }
+
+        _frozenDisplay.insert( row.selectable.get(), display );
+    }
+
+    _statesFrozen = true;
+}
+
+
+void
+YQPkgListModel::thawStates()
+{
+    if ( ! _statesFrozen )
+        return;
+
+    _statesFrozen = false;
+    _frozenStates.clear();
+    _frozenDisplay.clear();
+
+    updateData();
+}
+
+
+YQPkgListModel::RowState
+YQPkgListModel::rowState( const Row & row ) const
+{
+    if ( ! _statesFrozen )
+        return poolState( row.selectable );
+
+    // Rows that were added after freezeStates() don't have a valid state
+
+    return _frozenStates.value( row.selectable.get(),
+                                RowState { S_NoInst, zypp::ResStatus::USER, ZyppObj(), ZyppObj(), false } );
+}
+
+
+YQPkgListModel::RowState
+YQPkgListModel::poolState( ZyppSel selectable )
+{
+    return RowState { selectable->status(),
+                      selectable->modifiedBy(),
+                      selectable->candidateObj(),
+                      selectable->installedObj(),
+                      true };
+}
+
+
+void
+YQPkgListModel::addExcludeRule( YQPkgObjList::ExcludeRule * rule )
+{
+    _excludeRules.push_back( rule );
+}
+
+
+void
+YQPkgListModel::applyExcludeRules()
+{
+    beginResetModel();
+
+    QVector<Row> allRows = _rows + _pendingRows + _excludedRows;
+    _rows.clear();
+    _pendingRows.clear();
+    _excludedRows.clear();
+
+    for ( const Row & row: allRows )
+    {
+        if ( isExcluded( row ) )
+            _excludedRows.append( row );
+        else
+            _rows.append( row );
+    }
+
+    _rowIndexValid = false;
+
+    endResetModel();
+}
+
+
+bool
+YQPkgListModel::isExcluded( const Row & row ) const
+{
+    for ( YQPkgObjList::ExcludeRule * rule: _excludeRules )
+    {
+        if ( rule->isEnabled() && rule->match( text( row, rule->column() ) ) )
+            return true;
+    }
+
+    return false;
+}
+
+
+QModelIndex
+YQPkgListModel::index( int row, int column, const QModelIndex & parent ) const
+{
+    if ( parent.isValid() ||
+         row    < 0 || row    >= rowCount()  ||
+         column < 0 || column >= columnCount() )
+    {
+        return QModelIndex();
+    }
+
+    return createIndex( row, column );
+}
+
+
+QModelIndex
+YQPkgListModel::parent( const QModelIndex & index ) const
+{
+    // This is a flat list: No item has a parent.
+
+    return QModelIndex();
+}
+
+
+int
+YQPkgListModel::rowCount( const QModelIndex & parent ) const
+{
+    if ( parent.isValid() )
+        return 0;
+
+    return _rows.size() + ( _message.isEmpty() ? 0 : 1 );
+}
+
+
+int
+YQPkgListModel::columnCount( const QModelIndex & parent ) const
+{
+    if ( parent.isValid() )
+        return 0;
+
+    return _headers.size();
+}
+
+
+QVariant
+YQPkgListModel::headerData( int             section,
+                            Qt::Orientation orientation,
+                            int             role ) const
+{
+    if ( orientation == Qt::Horizontal && role == Qt::DisplayRole )
+        return _headers.value( section );
+
+    return QVariant();
+}
+
+
+Qt::ItemFlags
+YQPkgListModel::flags( const QModelIndex & index ) const
+{
+    if ( ! index.isValid() )
+        return Qt::NoItemFlags;
+
+    if ( isMessageRow( index.row() ) )
+        return Qt::ItemIsEnabled;
+
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+
+QVariant
+YQPkgListModel::data( const QModelIndex & index, int role ) const
+{
+    if ( ! index.isValid() )
+        return QVariant();
+
+    int col = index.column();
+
+    if ( isMessageRow( index.row() ) )
+    {
+        if ( role == Qt::DisplayRole && col == _nameCol )
+            return _message;
+
+        return QVariant();
+    }
+
+    if ( index.row() >= _rows.size() )
+        return QVariant();
+
+    const Row & row = _rows.at( index.row() );
+
+    if ( _statesFrozen )
+    {
+        // The resolver is busy with the pool: Don't read anything from it,
+        // not even the package names.
+
+        switch ( role )
+        {
+            case Qt::DisplayRole:
+                return text( index.row(), col );
+
+            case Qt::ForegroundRole:
+
+                if ( row.dimmed )
+                    return _view->palette().color( QPalette::Disabled, QPalette::Text );
+
+                return _frozenDisplay.value( row.selectable.get() ).foregrounds.value( col );
+
+            case Qt::ToolTipRole:
+                return QVariant();
+
+            default:
+                break; // The status icon uses the frozen state
+        }
+    }
+
+    switch ( role )
+    {
+        case Qt::DisplayRole:
+            return text( row, col );
+
+        case Qt::DecorationRole:
+
+            if ( col == _statusCol )
+            {
+                RowState state = rowState( row );
+
+                if ( ! state.valid )
+                    return QVariant();
+
+                bool bySelection = ( state.modifiedBy == zypp::ResStatus::APPL_LOW ||
+                                     state.modifiedBy == zypp::ResStatus::APPL_HIGH  );
+
+                return YQPkgObjList::pkgStatusIcon( state.status,
+                                                    _view->editable(),
+                                                    bySelection );
+            }
+
+            if ( col == _versionCol && ! _versionIcons.isEmpty() )
+            {
+                QIcon icon = _versionIcons.value( row.selectable.get() );
+
+                if ( ! icon.isNull() )
+                    return icon;
+            }
+            break;
+
+        case Qt::ForegroundRole:
+            return foreground( row, col );
+
+        case Qt::TextAlignmentRole:
+
+            if ( col == _sizeCol )
+                return QVariant( Qt::AlignRight | Qt::AlignVCenter );
+            break;
+
+        case Qt::ToolTipRole:
+            return toolTip( row, col );
+
+        default:
+            break;
+    }
+
+    return QVariant();
+}
+
+
+QString
+YQPkgListModel::text( int row, int col ) const
+{
+    if ( row < 0 || row >= _rows.size() )
+        return QString();
+
+    if ( _statesFrozen ) // Don't read the pool while the resolver is busy
+        return _frozenDisplay.value( _rows.at( row ).selectable.get() ).texts.value( col );
+
+    return text( _rows.at( row ), col );
+}
+
+
+QString
+YQPkgListModel::text( const Row & row, int col ) const
+{
+    if ( col < 0 )
+        return QString();
+
+    ZyppObj zyppObj = row.zyppPkg;
+
+    if ( col == _nameCol )
+        return fromUTF8( zyppObj->name() );
+
+    if ( col == _summaryCol )
+        return fromUTF8( zyppObj->summary() );
+
+    if ( col == _sizeCol )
+    {
+        zypp::ByteCount size = zyppObj->installSize();
+
+        return size > 0L ? fromUTF8( size.asString() ) : QString();
+    }
+
+    if ( col != _versionCol && col != _instVersionCol )
+        return QString();
+
+    RowState state = rowState( row );
+
+    if ( ! state.valid )
+        return QString();
+
+    const ZyppObj candidate = state.candidate;
+    const ZyppObj installed = state.installed;
+
+    if ( _versionCol == _instVersionCol ) // Both versions in the same column: 1.2.3 (1.2.4)
+    {
+        if ( installed )
+        {
+            if ( zyppObj != installed && zyppObj != candidate )
+                return fromUTF8( zyppObj->edition().asString() );
+
+            if ( candidate && installed->edition() != candidate->edition() )
+            {
+                return QString( "%1 (%2)" )
+                    .arg( fromUTF8( installed->edition().asString() ) )
+                    .arg( fromUTF8( candidate->edition().asString() ) );
+            }
+
+            // No candidate or both versions are the same anyway
+
+            return fromUTF8( installed->edition().asString() );
+        }
+
+        if ( candidate )
+            return QString( "(%1)" ).arg( fromUTF8( candidate->edition().asString() ) );
+
+        return fromUTF8( zyppObj->edition().asString() );
+    }
+
+    // Separate columns for installed and available versions
+
+    if ( col == _instVersionCol )
+        return installed ? fromUTF8( installed->edition().asString() ) : QString();
+
+    if ( zyppObj != installed && zyppObj != candidate )
+        return fromUTF8( zyppObj->edition().asString() );
+
+    return candidate ? fromUTF8( candidate->edition().asString() ) : QString();
+}
+
+
+QVariant
+YQPkgListModel::foreground( const Row & row, int col ) const
+{
+    if ( row.dimmed )
+        return _view->palette().color( QPalette::Disabled, QPalette::Text );
+
+    if ( col < 0 || ( col != _versionCol && col != _instVersionCol ) )
+        return QVariant();
+
+    RowState state = rowState( row );
+
+    if ( ! state.valid )
+        return QVariant();
+
+    if ( installedIsNewer( state ) )
+        return _view->redTextColor();
+
+    if ( candidateIsNewer( state ) )
+        return _view->blueTextColor();
+
+    return QVariant();
+}
+
+
+QString
+YQPkgListModel::toolTip( const Row & row, int col ) const
+{
+    RowState state = rowState( row );
+
+    if ( ! state.valid )
+        return QString();
+
+    if ( col == _statusCol )
+    {
+        QString tip = YQPkgObjList::pkgStatusText( state.status );
+
+        switch ( state.status )
+        {
+            case S_AutoDel:
+            case S_AutoInstall:
+            case S_AutoUpdate:
+                {
+                    if ( state.modifiedBy == zypp::ResStatus::APPL_LOW ||
+                         state.modifiedBy == zypp::ResStatus::APPL_HIGH  )
+                    {
+                        // Translators: Additional hint what caused an auto-status
+                        tip += "\n" + _( "(by a software selection)" );
+                    }
+                    else
+                    {
+                        tip += "\n" + _( "(by dependencies)" );
+                    }
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        return tip;
+    }
+
+    QString text = fromUTF8( row.zyppPkg->name() ) + "\n\n";
+    QString installed;
+    QString candidate;
+
+    if ( state.installed )
+    {
+        installed  = fromUTF8( state.installed->edition().asString() );
+        installed += "-";
+        installed += fromUTF8( state.installed->arch().asString() );
+        installed  = _( "Installed Version: %1" ).arg( installed );
+    }
+
+    if ( state.candidate )
+    {
+        candidate  = fromUTF8( state.candidate->edition().asString() );
+        candidate += "-";
+        candidate += fromUTF8( state.candidate->arch().asString() );
+    }
+
+    if ( state.installed )
+    {
+        text += installed + "\n";
+
+        if ( state.candidate )
+        {
+            // Translators: This is the relation between two versions of one package
+            // if both versions are the same, e.g., both "1.2.3-42", "1.2.3-42"
+            QString relation = _( "same" );
+
+            if ( candidateIsNewer( state ) ) relation = _( "newer" );
+            if ( installedIsNewer( state ) ) relation = _( "older" );
+
+            // Translators: %1 is the version, %2 is one of "newer", "older", "same"
+            text += _( "Available Version: %1 (%2)" ).arg( candidate ).arg( relation );
+        }
+        else
+        {
+            text += _( "Not available for installation" );
+        }
+    }
+    else // not installed
+    {
+        text += candidate;
+    }
+
+    return text;
+}
+
+
+bool
+YQPkgListModel::candidateIsNewer( ZyppSel selectable )
+{
+    return candidateIsNewer( poolState( selectable ) );
+}
+
+
+bool
+YQPkgListModel::installedIsNewer( ZyppSel selectable )
+{
+    return installedIsNewer( poolState( selectable ) );
+}
+
+
+bool
+YQPkgListModel::candidateIsNewer( const RowState & state )
+{
+    return state.candidate && state.installed &&
+        state.installed->edition() < state.candidate->edition();
+}
+
+
+bool
+YQPkgListModel::installedIsNewer( const RowState & state )
+{
+    if ( ! state.installed )
+        return false;
+
+    return ! state.candidate || state.candidate->edition() < state.installed->edition();
+}
+
+
+int
+YQPkgListModel::versionPoints( ZyppSel selectable )
+{
+    int points = 0;
+
+    if ( installedIsNewer( selectable ) )   points += 1000;
+    if ( candidateIsNewer( selectable ) )   points += 100;
+    if ( selectable->hasInstalledObj() )    points += 10;
+    if ( selectable->hasCandidateObj() )    points += 1;
+
+    return points;
+}
+
+
+template<typename SortKeyFunc>
+void
+YQPkgListModel::sortByKey( QVector<int> &  sortedRows,
+                           SortKeyFunc     sortKey,
+                           Qt::SortOrder   order ) const
+{
+    typedef decltype( sortKey( _rows.first() ) ) SortKey;
+
+    // Not a QVector: QCollatorSortKey has no default constructor
+
+    std::vector<SortKey> keys;
+    keys.reserve( _rows.size() );
+
+    for ( const Row & row: _rows )
+        keys.push_back( sortKey( row ) );
+
+    std::stable_sort( sortedRows.begin(), sortedRows.end(),
+                      [&]( int row1, int row2 )
+                      {
+                          if ( order == Qt::AscendingOrder )
+                              return keys[ row1 ] < keys[ row2 ];
+                          else
+                              return keys[ row2 ] < keys[ row1 ];
+                      } );
+}
+
+
+void
+YQPkgListModel::sort( int col, Qt::SortOrder order )
+{
+    if ( _rows.size() < 2 )
+        return;
+
+    emit layoutAboutToBeChanged( QList<QPersistentModelIndex>(),
+                                 QAbstractItemModel::VerticalSortHint );
+
+    // Sort a vector of row numbers rather than the rows themselves so the
+    // persistent indexes (e.g. the current item) can be moved along.
+
+    QVector<int> sortedRows( _rows.size() );
+    std::iota( sortedRows.begin(), sortedRows.end(), 0 );
+
+    // Same criteria as YQPkgObjListItem::operator<()
+
+    if ( col < 0 )
+    {
+        // Leave the order unchanged
+    }
+    else if ( col == _nameCol )
+    {
+        sortByKey( sortedRows,
+                   []( const Row & row ) { return YQPkgObjList::nameSortKey( row.zyppPkg->name() ); },
+                   order );
+    }
+    else if ( col == _summaryCol )
+    {
+        sortByKey( sortedRows,
+                   []( const Row & row ) { return YQPkgObjList::summarySortKey( row.zyppPkg->summary() ); },
+                   order );
+    }
+    else if ( col == _sizeCol )
+    {
+        sortByKey( sortedRows,
+                   []( const Row & row ) { return (qint64) row.zyppPkg->installSize(); },
+                   order );
+    }
+    else if ( col == _statusCol )
+    {
+        sortByKey( sortedRows,
+                   []( const Row & row )
+                   {
+                       return std::make_pair( (int) row.selectable->status(),
+                                              YQPkgObjList::nameSortKey( row.zyppPkg->name() ) );
+                   },
+                   order );
+    }
+    else if ( col == _versionCol || col == _instVersionCol )
+    {
+        sortByKey( sortedRows,
+                   []( const Row & row )
+                   {
+                       return YQPkgObjList::versionSortKey( versionPoints( row.selectable ),
+                                                            row.zyppPkg->edition() );
+                   },
+                   order );
+    }
+
+    QVector<Row> newRows;
+    QVector<int> newPos( _rows.size() );
+    newRows.reserve( _rows.size() );
+
+    for ( int i = 0; i < sortedRows.size(); ++i )
+    {
+        newRows.append( _rows.at( sortedRows.at( i ) ) );
+        newPos[ sortedRows.at( i ) ] = i;
+    }
+
+    _rows.swap( newRows );
+    _rowIndexValid = false;
+
+    const QModelIndexList oldIndexes = persistentIndexList();
+
+    for ( const QModelIndex & oldIndex: oldIndexes )
+    {
+        if ( oldIndex.row() < newPos.size() ) // Not the message row
+        {
+            changePersistentIndex( oldIndex,
+                                   index( newPos.at( oldIndex.row() ), oldIndex.column() ) );
+        }
+    }
+
+    emit layoutChanged( QList<QPersistentModelIndex>(),
+                        QAbstractItemModel::VerticalSortHint );
+}
+
+
+
+
+YQPkgListView::YQPkgListView( QWidget * parent )
+    : QTreeView( parent )
+    , _model( 0 )
+    , _editable( true )
+    , _installedContextMenu( 0 )
+    , _notInstalledContextMenu( 0 )
+    , actionSetCurrentInstall( 0 )
+    , actionSetCurrentDontInstall( 0 )
+    , actionSetCurrentKeepInstalled( 0 )
+    , actionSetCurrentDelete( 0 )
+    , actionSetCurrentUpdate( 0 )
+    , actionSetCurrentUpdateForce( 0 )
+    , actionSetCurrentTaboo( 0 )
+    , actionSetCurrentProtected( 0 )
+    , actionSetListInstall( 0 )
+    , actionSetListDontInstall( 0 )
+    , actionSetListKeepInstalled( 0 )
+    , actionSetListDelete( 0 )
+    , actionSetListUpdate( 0 )
+    , actionSetListUpdateForce( 0 )
+    , actionSetListTaboo( 0 )
+    , actionSetListProtected( 0 )
+{
+    initColors();
+    resetBestColWidths();
+
+    _commitTimer.setSingleShot( true );
+    _commitTimer.setInterval( 0 );
+
+    connect( &_commitTimer, SIGNAL( timeout()            ),
+             this,          SLOT  ( commitPendingItems() ) );
+
+    _model = new YQPkgListModel( this );
+    CHECK_NEW( _model );
+    setModel( _model );
+
+    setRootIsDecorated( false );
+    setUniformRowHeights( true ); // Allows the view to skip measuring each row
+    setAllColumnsShowFocus( true );
+    setSelectionMode( QAbstractItemView::SingleSelection );
+    setSelectionBehavior( QAbstractItemView::SelectRows );
+
+    header()->setStretchLastSection( false );
+    header()->setSectionResizeMode( QHeaderView::Interactive );
+    header()->setSortIndicatorShown( true );
+    header()->setSectionsClickable( true );
+
+    // This lets the header call _model->sort() when the user clicks on a
+    // column header.
+
+    setSortingEnabled( true );
+    sortByColumn( statusCol(), Qt::AscendingOrder );
+
+    createActions();
+
+    connect( selectionModel(), SIGNAL( currentChanged   ( QModelIndex, QModelIndex ) ),
+             this,             SLOT  ( currentRowChanged( QModelIndex ) ) );
+
+    connect( this,             SIGNAL( clicked          ( QModelIndex ) ),
+             this,             SLOT  ( pkgClicked       ( QModelIndex ) ) );
+
+    connect( this,             SIGNAL( doubleClicked    ( QModelIndex ) ),
+             this,             SLOT  ( pkgClicked       ( QModelIndex ) ) );
+
+    connect( this,             SIGNAL( customContextMenuRequested( QPoint ) ),
+             this,             SLOT  ( slotCustomContextMenu     ( QPoint ) ) );
+
+    setContextMenuPolicy( Qt::CustomContextMenu );
+}
+
+
+YQPkgListView::~YQPkgListView()
+{
+    // NOP
+}
+
+
+void
+YQPkgListView::initColors()
+{
+    _normalTextColor = palette().color( QPalette::Active, QPalette::Text );
+    QColor backgroundColor = palette().color( QPalette::Active, QPalette::Base );
+
+    if ( backgroundColor.lightness() >= 128 )  // light Theme: 0 (black) .. 255 (white)
+    {
+        _blueTextColor = Qt::blue;
+        _redTextColor  = Qt::red;
+    }
+    else  // dark Theme
+    {
+        _blueTextColor = Qt::cyan;
+        _redTextColor  = Qt::red;
+    }
+}
+
+
+QSize
+YQPkgListView::sizeHint() const
+{
+    return QSize( 600, 350 );
+}
+
+
+void
+YQPkgListView::addPkgItem( ZyppSel selectable,
+                           ZyppPkg zyppPkg )
+{
+    addPkgItem( selectable, zyppPkg, false );
+}
+
+
+void
+YQPkgListView::addPkgItemDimmed( ZyppSel selectable,
+                                 ZyppPkg zyppPkg )
+{
+    addPkgItem( selectable, zyppPkg, true );
+}
+
+
+void
+YQPkgListView::addPkgItem( ZyppSel selectable,
+                           ZyppPkg zyppPkg,
+                           bool    dimmed )
+{
+    if ( ! selectable )
+    {
+        logError() << "NULL zypp::ui::Selectable!" << endl;
+        return;
+    }
+
+    // Don't insert the row right away: Collect all packages of this filter
+    // run and insert them in one go when control returns to the event loop
+    // or when the filter is finished, whatever comes first.
+
+    _model->appendPkg( selectable, zyppPkg, dimmed );
+
+    if ( ! _commitTimer.isActive() )
+        _commitTimer.start();
+}
+
+
+void
+YQPkgListView::commitPendingItems()
+{
+    _commitTimer.stop();
+
+    int count = _model->commitPending();
+
+    if ( count > 0 )
+    {
+        int lastRow = _model->pkgCount() - 1;
+
+        updateBestColWidths( lastRow - count + 1, lastRow );
+        optimizeColumnWidths();
+    }
+}
+
+
+void
+YQPkgListView::clear()
+{
+    emit currentItemChanged( ZyppSel() );
+
+    _commitTimer.stop();
+    _model->clear();
+    resetBestColWidths();
+    optimizeColumnWidths();
+}
+
+
+void
+YQPkgListView::resort()
+{
+    commitPendingItems();
+
+    sortByColumn( header()->sortIndicatorSection(),
+                  header()->sortIndicatorOrder() );
+}
+
+
+void
+YQPkgListView::selectSomething()
+{
+    commitPendingItems();
+
+    if ( _model->pkgCount() > 0 )
+        setCurrentIndex( _model->index( 0, 0 ) ); // Sends a signal
+}
+
+
+void
+YQPkgListView::selectNextItem()
+{
+    int row = currentIndex().row() + 1;
+
+    if ( row > 0 && row < _model->pkgCount() )
+    {
+        QModelIndex next = _model->index( row, 0 );
+
+        scrollTo( next );
+        setCurrentIndex( next );
+    }
+}
+
+
+void
+YQPkgListView::updateItemStates()
+{
+    _model->updateStates();
+}
+
+
+void
+YQPkgListView::updateChangedItems( const ZyppSelSet & selectables )
+{
+    _model->updateStates( selectables );
+}
+
+
+void
+YQPkgListView::updateItemData()
+{
+    _model->updateData();
+}
+
+
+void
+YQPkgListView::freezeStates()
+{
+    int firstRow = indexAt( viewport()->rect().topLeft()    ).row();
+    int lastRow  = indexAt( viewport()->rect().bottomLeft() ).row();
+
+    if ( firstRow < 0 )
+        firstRow = 0;
+
+    if ( lastRow < 0 ) // Below the last row
+        lastRow = _model->rowCount() - 1;
+
+    // One more page above and below in case the user scrolls
+
+    int pageSize = lastRow - firstRow + 1;
+    _model->freezeStates( firstRow - pageSize, lastRow + pageSize );
+}
+
+
+void
+YQPkgListView::thawStates()
+{
+    _model->thawStates();
+}
+
+
+void
+YQPkgListView::addExcludeRule( YQPkgObjList::ExcludeRule * rule )
+{
+    _model->addExcludeRule( rule );
+}
+
+
+void
+YQPkgListView::applyExcludeRules()
+{
+    _commitTimer.stop(); // The model takes care of the pending packages
+    _model->applyExcludeRules();
+    resetBestColWidths();
+
+    if ( _model->pkgCount() > 0 )
+        updateBestColWidths( 0, _model->pkgCount() - 1 );
+
+    optimizeColumnWidths();
+
+    if ( _model->excludedCount() > 0 )
+        logVerbose() << _model->excludedCount() << " packages excluded" << endl;
+
+    resort();
+}
+
+
+void
+YQPkgListView::message( const QString & text )
+{
+    _model->setMessage( text );
+}
+
+
+void
+YQPkgListView::maybeSetFocus()
+{
+    // Do not take away the keyboard focus from another list or tree widget
+    // that also has internal navigation with the cursor keys.
+    // See YQPkgObjList::shouldKeepFocus().
+
+    if ( ! dynamic_cast<QAbstractItemView *>( QApplication::focusWidget() ) )
+        setFocus();
+}
+
+
+ZyppSel
+YQPkgListView::currentSelectable() const
+{
+    return _model->selectable( currentIndex().row() );
+}
+
+
+void
+YQPkgListView::currentRowChanged( const QModelIndex & current )
+{
+    emit currentItemChanged( _model->selectable( current.row() ) );
+}
+
+
+void
+YQPkgListView::pkgClicked( const QModelIndex & index )
+{
+    // Only left button clicks get here;
+    // context menus are handled in slotCustomContextMenu()
+
+    if ( index.isValid() && index.column() == statusCol() && _editable )
+        cycleStatus( index.row() );
+}
+
+
+void
+YQPkgListView::setStatus( int row, ZyppStatus newStatus, bool sendSignals )
+{
+    ZyppSel selectable = _model->selectable( row );
+
+    if ( ! selectable )
+        return;
+
+    ZyppStatus oldStatus = selectable->status();
+    selectable->setStatus( newStatus );
+
+    if ( sendSignals && oldStatus != selectable->status() )
+    {
+        updateItemStates();
+        emit updatePackages();
+    }
+}
+
+
+void
+YQPkgListView::setCurrentStatus( ZyppStatus newStatus,
+                                 bool       doSelectNextItem,
+                                 bool       ifNewerOnly )
+{
+    int     row        = currentIndex().row();
+    ZyppSel selectable = _model->selectable( row );
+
+    if ( ! selectable )
+        return;
+
+    if ( _editable && ( YQPkgListModel::candidateIsNewer( selectable ) || ! ifNewerOnly ) )
+    {
+        if ( newStatus != selectable->status() )
+        {
+            setStatus( row, newStatus );
+
+            if ( YQPkgObjListItem::showLicenseAgreement( selectable ) )
+                showNotifyTexts( selectable, newStatus );
+            else // License not confirmed: Status is now S_Taboo or S_Del
+                updateItemStates();
+
+            emit statusChanged();
+        }
+    }
+
+    if ( doSelectNextItem )
+        selectNextItem();
+}
+
+
+void
+YQPkgListView::setAllItemStatus( ZyppStatus newStatus, bool force )
+{
+    if ( ! _editable )
+        return;
+
+    commitPendingItems();
+    busyCursor();
+
+    // Only the visible packages: Those that are excluded by an exclude rule
+    // (e.g. -devel or -debuginfo packages) are intentionally not affected.
+
+    for ( int row = 0; row < _model->pkgCount(); ++row )
+    {
+        ZyppSel selectable = _model->selectable( row );
+
+        if ( newStatus == selectable->status() )
+            continue;
+
+        if ( newStatus == S_Update )
+        {
+            if ( force )
+            {
+                setStatus( row, newStatus,
+                           false );   // sendSignals
+            }
+            else
+            {
+                if ( selectable->installedObj()         &&
+                     selectable->status() != S_Protected &&
+                     selectable->updateCandidateObj()      )
+                {
+                    selectable->setOnSystem( selectable->updateCandidateObj() );
+                }
+            }
+        }
+        else
+        {
+            setStatus( row, newStatus,
+                       false );       // sendSignals
+        }
+    }
+
+    updateItemStates();
+    emit updatePackages();
+
+    normalCursor();
+    emit statusChanged();
+}
+
+
+int
+YQPkgListView::globalSetPkgStatus( ZyppStatus newStatus, bool force, bool countOnly )
+{
+    busyCursor();
+    int changedCount = YQPkgList::setPoolPkgStatus( newStatus, force, countOnly );
+
+    if ( changedCount > 0 && ! countOnly )
+    {
+        updateItemStates();
+        emit updatePackages();
+        emit statusChanged();
+    }
+
+    normalCursor();
+
+    return changedCount;
+}
+
+
+void
+YQPkgListView::cycleStatus( int row )
+{
+    ZyppSel selectable = _model->selectable( row );
+
+    if ( ! selectable || ! _editable )
+        return;
+
+    ZyppStatus oldStatus = selectable->status();
+    ZyppStatus newStatus = oldStatus;
+
+    switch ( oldStatus )
+    {
+        case S_Install:
+            newStatus = S_NoInst;
+            break;
+
+        case S_Protected:
+            newStatus = selectable->hasCandidateObj() ?
+                S_KeepInstalled: S_NoInst;
+            break;
+
+        case S_Taboo:
+            newStatus = selectable->hasInstalledObj() ?
+                S_KeepInstalled : S_NoInst;
+            break;
+
+        case S_KeepInstalled:
+            newStatus = selectable->hasCandidateObj() ?
+                S_Update : S_Del;
+            break;
+
+        case S_Update:
+            newStatus = S_Del;
+            break;
+
+        case S_AutoUpdate:
+            newStatus = S_KeepInstalled;
+            break;
+
+        case S_Del:
+        case S_AutoDel:
+            newStatus = S_KeepInstalled;
+            break;
+
+        case S_NoInst:
+            if ( selectable->hasCandidateObj() )
+            {
+                newStatus = S_Install;
+            }
+            else
+            {
+                logWarning() << "No candidate for " << selectable->name() << endl;
+                newStatus = S_NoInst;
+            }
+            break;
+
+        case S_AutoInstall:
+            newStatus = S_NoInst;
+            break;
+    }
+
+    if ( oldStatus != newStatus )
+    {
+        setStatus( row, newStatus );
+
+        if ( YQPkgObjListItem::showLicenseAgreement( selectable ) )
+            showNotifyTexts( selectable, newStatus );
+        else // License not confirmed: Status is now S_Taboo or S_Del
+            updateItemStates();
+
+        emit statusChanged();
+    }
+}
+
+
+void
+YQPkgListView::showNotifyTexts( ZyppSel selectable, ZyppStatus status )
+{
+    if ( ! selectable || ! selectable->hasCandidateObj() )
+        return;
+
+    std::string text;
+
+    switch ( status )
+    {
+        case S_Install:
+            text = selectable->candidateObj()->insnotify();
+            break;
+
+        case S_NoInst:
+        case S_Del:
+        case S_Taboo:
+            text = selectable->candidateObj()->delnotify();
+            break;
+
+        default: break;
+    }
+
+    if ( ! text.empty() )
+    {
+        logDebug() << "Showing notify text" << endl;
+        YQPkgTextDialog::showText( this, selectable, text );
+    }
+}
+
+
+void
+YQPkgListView::createActions()
+{
+    actionSetCurrentInstall       = createAction( S_Install,       "[+]"      );
+    actionSetCurrentDontInstall   = createAction( S_NoInst,        "[-]"      );
+    actionSetCurrentKeepInstalled = createAction( S_KeepInstalled, "[<], [-]" );
+    actionSetCurrentDelete        = createAction( S_Del,           "[-]"      );
+    actionSetCurrentUpdate        = createAction( S_Update,        "[>], [+]" );
+
+    actionSetCurrentUpdateForce   = createAction( _( "Update unconditionally" ),
+                                                  YQPkgObjList::pkgStatusIcon( S_Update, true  ),
+                                                  YQPkgObjList::pkgStatusIcon( S_Update, false ),
+                                                  "",
+                                                  true );
+
+    actionSetCurrentTaboo         = createAction( S_Taboo,         "[!]"    );
+    actionSetCurrentProtected     = createAction( S_Protected,     "[*]"    );
+
+    actionSetListInstall          = createAction( S_Install,       "", true );
+    actionSetListDontInstall      = createAction( S_NoInst,        "", true );
+    actionSetListKeepInstalled    = createAction( S_KeepInstalled, "", true );
+    actionSetListDelete           = createAction( S_Del,           "", true );
+    actionSetListProtected        = createAction( S_Protected,     "", true );
+
+    actionSetListUpdate           = createAction( _( "Update if newer version available" ),
+                                                  YQPkgObjList::pkgStatusIcon( S_Update, true  ),
+                                                  YQPkgObjList::pkgStatusIcon( S_Update, false ),
+                                                  "",
+                                                  true );
+
+    actionSetListUpdateForce      = createAction( _( "Update unconditionally" ),
+                                                  YQPkgObjList::pkgStatusIcon( S_Update, true  ),
+                                                  YQPkgObjList::pkgStatusIcon( S_Update, false ),
+                                                  "",
+                                                  true );
+
+    actionSetListTaboo            = createAction( S_Taboo,         "", true );
+
+    connect( actionSetCurrentInstall,        SIGNAL( triggered() ), this, SLOT( setCurrentInstall()       ) );
+    connect( actionSetCurrentDontInstall,    SIGNAL( triggered() ), this, SLOT( setCurrentDontInstall()   ) );
+    connect( actionSetCurrentKeepInstalled,  SIGNAL( triggered() ), this, SLOT( setCurrentKeepInstalled() ) );
+    connect( actionSetCurrentDelete,         SIGNAL( triggered() ), this, SLOT( setCurrentDelete()        ) );
+    connect( actionSetCurrentUpdate,         SIGNAL( triggered() ), this, SLOT( setCurrentUpdate()        ) );
+    connect( actionSetCurrentUpdateForce,    SIGNAL( triggered() ), this, SLOT( setCurrentUpdateForce()   ) );
+    connect( actionSetCurrentTaboo,          SIGNAL( triggered() ), this, SLOT( setCurrentTaboo()         ) );
+    connect( actionSetCurrentProtected,      SIGNAL( triggered() ), this, SLOT( setCurrentProtected()     ) );
+    connect( actionSetListInstall,           SIGNAL( triggered() ), this, SLOT( setListInstall()          ) );
+    connect( actionSetListDontInstall,       SIGNAL( triggered() ), this, SLOT( setListDontInstall()      ) );
+    connect( actionSetListKeepInstalled,     SIGNAL( triggered() ), this, SLOT( setListKeepInstalled()    ) );
+    connect( actionSetListDelete,            SIGNAL( triggered() ), this, SLOT( setListDelete()           ) );
+    connect( actionSetListUpdate,            SIGNAL( triggered() ), this, SLOT( setListUpdate()           ) );
+    connect( actionSetListUpdateForce,       SIGNAL( triggered() ), this, SLOT( setListUpdateForce()      ) );
+    connect( actionSetListTaboo,             SIGNAL( triggered() ), this, SLOT( setListTaboo()            ) );
+    connect( actionSetListProtected,         SIGNAL( triggered() ), this, SLOT( setListProtected()        ) );
+}
+
+
+QAction *
+YQPkgListView::createAction( ZyppStatus      status,
+                             const QString & key,
+                             bool            enabled )
+{
+    return createAction( YQPkgObjList::pkgStatusText( status ),
+                         YQPkgObjList::pkgStatusIcon( status, true  ),
+                         YQPkgObjList::pkgStatusIcon( status, false ),
+                         key,
+                         enabled );
+}
+
+
+QAction *
+YQPkgListView::createAction( const QString & text,
+                             const QPixmap & icon,
+                             const QPixmap & insensitiveIcon,
+                             const QString & key,
+                             bool            enabled )
+{
+    QString label = text;
+
+    if ( ! key.isEmpty() )
+        label += "\t" + key;
+
+    QIcon iconSet( icon );
+
+    if ( ! insensitiveIcon.isNull() )
+        iconSet.addPixmap( insensitiveIcon, QIcon::Disabled );
+
+    QAction * action = new QAction( label,      // text
+                                    this );     // parent
+    CHECK_NEW( action );
+    action->setEnabled( enabled );
+    action->setIcon( iconSet );
+
+    return action;
+}
+
+
+QMenu *
+YQPkgListView::notInstalledContextMenu()
+{
+    if ( ! _notInstalledContextMenu )
+    {
+        _notInstalledContextMenu = new QMenu( this );
+        CHECK_NEW( _notInstalledContextMenu );
+
+        _notInstalledContextMenu->addAction( actionSetCurrentInstall     );
+        _notInstalledContextMenu->addAction( actionSetCurrentDontInstall );
+        _notInstalledContextMenu->addAction( actionSetCurrentTaboo       );
+
+        addAllInListSubMenu( _notInstalledContextMenu );
+    }
+
+    return _notInstalledContextMenu;
+}
+
+
+QMenu *
+YQPkgListView::installedContextMenu()
+{
+    if ( ! _installedContextMenu )
+    {
+        _installedContextMenu = new QMenu( this );
+        CHECK_NEW( _installedContextMenu );
+
+        _installedContextMenu->addAction( actionSetCurrentKeepInstalled );
+        _installedContextMenu->addAction( actionSetCurrentDelete        );
+        _installedContextMenu->addAction( actionSetCurrentUpdate        );
+        _installedContextMenu->addAction( actionSetCurrentUpdateForce   );
+        _installedContextMenu->addAction( actionSetCurrentProtected     );
+
+        addAllInListSubMenu( _installedContextMenu );
+    }
+
+    return _installedContextMenu;
+}
+
+
+QMenu *
+YQPkgListView::addAllInListSubMenu( QMenu * menu )
+{
+    QMenu * submenu = new QMenu( menu );
+    CHECK_NEW( submenu );
+
+    submenu->addAction( actionSetListInstall       );
+    submenu->addAction( actionSetListDontInstall   );
+    submenu->addAction( actionSetListKeepInstalled );
+    submenu->addAction( actionSetListDelete        );
+    submenu->addAction( actionSetListUpdate        );
+    submenu->addAction( actionSetListUpdateForce   );
+    submenu->addAction( actionSetListTaboo         );
+    submenu->addAction( actionSetListProtected     );
+
+    QAction * action = menu->addMenu( submenu );
+    action->setText( _( "&All in This List" ) );
+
+    return submenu;
+}
+
+
+void
+YQPkgListView::updateActions()
+{
+    ZyppSel selectable = currentSelectable();
+
+    if ( selectable )
+    {
+        if ( selectable->hasInstalledObj() )
+        {
+            actionSetCurrentInstall->setEnabled( false );
+            actionSetCurrentDontInstall->setEnabled( false );
+            actionSetCurrentTaboo->setEnabled( false );
+            actionSetCurrentProtected->setEnabled( true );
+
+            actionSetCurrentKeepInstalled->setEnabled( true );
+            actionSetCurrentDelete->setEnabled( true );
+            actionSetCurrentUpdate->setEnabled( selectable->hasCandidateObj() );
+            actionSetCurrentUpdateForce->setEnabled( selectable->hasCandidateObj() );
+        }
+        else
+        {
+            actionSetCurrentInstall->setEnabled( selectable->hasCandidateObj() );
+            actionSetCurrentDontInstall->setEnabled( true );
+            actionSetCurrentTaboo->setEnabled( true );
+            actionSetCurrentProtected->setEnabled( false );
+
+            actionSetCurrentKeepInstalled->setEnabled( false );
+            actionSetCurrentDelete->setEnabled( false );
+            actionSetCurrentUpdate->setEnabled( false );
+            actionSetCurrentUpdateForce->setEnabled( false );
+        }
+    }
+    else  // ! selectable
+    {
+        actionSetCurrentInstall->setEnabled( false );
+        actionSetCurrentDontInstall->setEnabled( false );
+        actionSetCurrentTaboo->setEnabled( false );
+
+        actionSetCurrentKeepInstalled->setEnabled( false );
+        actionSetCurrentDelete->setEnabled( false );
+        actionSetCurrentUpdate->setEnabled( false );
+        actionSetCurrentUpdateForce->setEnabled( false );
+        actionSetCurrentProtected->setEnabled( false );
+    }
+}
+
+
+void
+YQPkgListView::slotCustomContextMenu( const QPoint & pos )
+{
+    ZyppSel selectable = currentSelectable();
+
+    if ( selectable && _editable )
+    {
+        updateActions();
+
+        QMenu * contextMenu =
+            ! selectable->installedEmpty() ?
+            installedContextMenu() : notInstalledContextMenu();
+
+        if ( contextMenu )
+            contextMenu->popup( viewport()->mapToGlobal( pos ) );
+    }
+}
+
+
+void
+YQPkgListView::keyPressEvent( QKeyEvent * event )
+{
+    ZyppSel selectable = currentSelectable();
+
+    if ( event && selectable )
+    {
+        bool       installed = selectable->hasInstalledObj();
+        ZyppStatus status    = selectable->status();
+
+        switch( event->key() )
+        {
+            case Qt::Key_Space:  // Cycle
+                cycleStatus( currentIndex().row() );
+                event->accept();
+                return;
+
+            case Qt::Key_Plus:  // Grab everything - install or update
+
+                if ( installed )
+                {
+                    ZyppStatus newStatus = S_KeepInstalled;
+
+                    if ( YQPkgListModel::candidateIsNewer( selectable ) )
+                        newStatus = S_Update;
+
+                    setCurrentStatus( newStatus );
+                }
+                else
+                    setCurrentStatus( S_Install );
+
+                event->accept();
+                return;
+
+            case Qt::Key_Minus: // Get rid of everything - don't install or delete
+                setCurrentStatus( installed ? S_Del : S_NoInst );
+                event->accept();
+                return;
+
+            case Qt::Key_Exclam:  // Taboo
+
+                if ( ! installed )
+                    setCurrentStatus( S_Taboo );
+
+                event->accept();
+                return;
+
+            case Qt::Key_Asterisk:  // Protected
+
+                if ( installed )
+                    setCurrentStatus( S_Protected );
+
+                event->accept();
+                return;
+
+            case Qt::Key_Greater:  // Update what can be updated
+
+                if ( installed && YQPkgListModel::candidateIsNewer( selectable ) )
+                    setCurrentStatus( S_Update );
+
+                event->accept();
+                return;
+
+            case Qt::Key_Less:  // Revert update
+
+                if ( status == S_Update ||
+                     status == S_AutoUpdate )
+                {
+                    setCurrentStatus( S_KeepInstalled );
+                }
+
+                event->accept();
+                return;
+        }
+    }
+
+    QTreeView::keyPressEvent( event );
+}
+
+
+void
+YQPkgListView::resetBestColWidths()
+{
+    _bestStatusColWidth      = 0;
+    _bestNameColWidth        = 0;
+    _bestSummaryColWidth     = 0;
+    _bestVersionColWidth     = 0;
+    _bestInstVersionColWidth = 0;
+    _bestSizeColWidth        = 0;
+}
+
+
+void
+YQPkgListView::updateBestColWidths( int firstRow, int lastRow )
+{
+    QFontMetrics fontMetrics( font() );
+
+    // Measuring text with the font metrics is expensive, so for each column
+    // only the longest text (by number of characters) of the new rows is
+    // measured. This is not exact for proportional fonts, but good enough
+    // for a column width that will be clamped to a reasonable range anyway.
+
+    auto colWidth = [&]( int col )
+        {
+            QString longest;
+
+            for ( int row = firstRow; row <= lastRow; ++row )
+            {
+                QString text = _model->text( row, col );
+
+                if ( text.size() > longest.size() )
+                    longest = text;
+            }
+
+            return fontMetrics.boundingRect( longest ).width()
+                + ( STATUS_ICON_SIZE / 2 );
+        };
+
+    _bestStatusColWidth  = STATUS_COL_WIDTH;
+    _bestNameColWidth    = qMax( _bestNameColWidth,    colWidth( nameCol()    ) );
+    _bestSummaryColWidth = qMax( _bestSummaryColWidth, colWidth( summaryCol() ) );
+    _bestVersionColWidth = qMax( _bestVersionColWidth, colWidth( versionCol() ) );
+    _bestSizeColWidth    = qMax( _bestSizeColWidth,    colWidth( sizeCol()    ) );
+
+    if ( instVersionCol() >= 0 && instVersionCol() != versionCol() )
+        _bestInstVersionColWidth = qMax( _bestInstVersionColWidth, colWidth( instVersionCol() ) );
+
+    //
+    // Regardless of all the above voodoo, set some reasonable min and max widths.
+    //
+
+    _bestNameColWidth    = qBound( 120, _bestNameColWidth,    280 );
+    _bestSummaryColWidth = qBound( 350, _bestSummaryColWidth, 500 );
+
+    if ( instVersionCol() == versionCol() )     // combined column for both versions
+    {
+        _bestVersionColWidth = qBound( 120, _bestVersionColWidth, 280 );
+    }
+    else // two columns
+    {
+        _bestVersionColWidth     = qBound( 120, _bestVersionColWidth,     200 );
+        _bestInstVersionColWidth = qBound( 120, _bestInstVersionColWidth, 200 );
+    }
+
+    _bestSizeColWidth = qBound( 100, _bestSizeColWidth, 150 );
+}
+
+
+void
+YQPkgListView::optimizeColumnWidths()
+{
+    int  colCount           = 4;  // Number of columns: name, summary, version, size
+    int  statusIconColWidth = _bestStatusColWidth;
+    bool separateInstVersionCol = instVersionCol() >= 0 && instVersionCol() != versionCol();
+
+    if ( statusIconColWidth == 0 )
+        statusIconColWidth = STATUS_COL_WIDTH;
+
+    int bestWidthsSum =
+        _bestStatusColWidth
+        + _bestNameColWidth
+        + _bestSummaryColWidth
+        + _bestVersionColWidth
+        + _bestSizeColWidth;
+
+    if ( separateInstVersionCol )
+    {
+        bestWidthsSum += _bestInstVersionColWidth;
+        colCount++;
+    }
+
+
+    // Check if we have less visible space than we need
+
+    int visibleSpace = viewport()->width() - MAGIC_MISSING_WIDTH;
+
+    if ( visibleSpace < 0 )
+        return;
+
+    if ( bestWidthsSum >= visibleSpace )
+    {
+        // There is not enough visible space to show all columns with optimal
+        // widths: Only reduce the width of the "summary" column beyond its
+        // optimal width. If this is not enough, we will get a horizontal
+        // scroll bar.
+
+        int reducedSummaryWidth = visibleSpace - bestWidthsSum + _bestSummaryColWidth;
+        reducedSummaryWidth = qMax( reducedSummaryWidth, 400 );
+
+        setColumnWidth( statusCol(),  statusIconColWidth   );
+        setColumnWidth( nameCol(),    _bestNameColWidth    );
+        setColumnWidth( summaryCol(), reducedSummaryWidth  );
+        setColumnWidth( versionCol(), _bestVersionColWidth );
+
+        if ( separateInstVersionCol )
+            setColumnWidth( instVersionCol(), _bestInstVersionColWidth );
+
+        setColumnWidth( sizeCol(), _bestSizeColWidth );
+    }
+    else // There is enough visible space
+    {
+        // Distribute the remaining visible space to all columns
+        // except the status icon column
+
+        int addSpace  = ( visibleSpace - bestWidthsSum ) / colCount;
+        int addSpaceR = ( visibleSpace - bestWidthsSum ) % colCount;
+
+        setColumnWidth( statusCol(),  statusIconColWidth              );
+        setColumnWidth( nameCol(),    _bestNameColWidth    + addSpace );
+        setColumnWidth( summaryCol(), _bestSummaryColWidth + addSpace );
+        setColumnWidth( versionCol(), _bestVersionColWidth + addSpace );
+
+        if ( separateInstVersionCol )
+            setColumnWidth( instVersionCol(), _bestInstVersionColWidth + addSpace );
+
+        setColumnWidth( sizeCol(), _bestSizeColWidth + addSpace + addSpaceR );
+    }
+}
+
+
+void
+YQPkgListView::resizeEvent( QResizeEvent * event )
+{
+    QTreeView::resizeEvent( event );
+
+    // Avoid column width optimization when only the height changes
+    // because the horizontal scroll bar appears / disappears
+
+    if ( event->size().width() != event->oldSize().width() )
+        optimizeColumnWidths();
+}
@@ -0,0 +1,831 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+ */
+
+
+#ifndef YQPkgListView_h
+#define YQPkgListView_h
+
+
+#include <QAbstractItemModel>
+#include <QColor>
+#include <QHash>
+#include <QIcon>
+#include <QMenu>
+#include <QResizeEvent>
+#include <QTimer>
+#include <QTreeView>
+#include <QVector>
+
+#include "YQPkgObjList.h"
+#include "YQZypp.h"
+
+
+class QAction;
+class QKeyEvent;
+class YQPkgListView;
+
+
+/**
+ * Model for the main package list of the package selector.
+ *
+ * Unlike YQPkgList (a QTreeWidget with one heap-allocated item per package,
+ * each with its own texts, colors and icons for each column), this model only
+ * stores one compact row per package with the handles to the zypp objects.
+ * Everything that is displayed is computed on demand in data(), i.e. only for
+ * the rows that are currently visible in the view.
+ *
+ * The model is flat (no tree structure). It has the same columns as
+ * YQPkgList: Status, name, summary, version(s), size.
+ **/
+class YQPkgListModel: public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor.
+     **/
+    YQPkgListModel( YQPkgListView * parent );
+
+    /**
+     * Destructor
+     **/
+    virtual ~YQPkgListModel();
+
+
+    // Column numbers; -1 if there is no such column
+
+    int statusCol()      const { return _statusCol;      }
+    int nameCol()        const { return _nameCol;        }
+    int summaryCol()     const { return _summaryCol;     }
+    int versionCol()     const { return _versionCol;     }
+    int instVersionCol() const { return _instVersionCol; }
+    int sizeCol()        const { return _sizeCol;        }
+
+    /**
+     * Add a package row at the end of the list.
+     *
+     * If any of the exclude rules matches, the package is not visible, but
+     * it is kept in the model so it can be shown again when the exclude rules
+     * change.
+     *
+     * Return value: The new row number or -1 if the package is excluded.
+     **/
+    int addPkg( ZyppSel selectable,
+                ZyppPkg zyppPkg,
+                bool    dimmed = false );
+
+    /**
+     * Queue a package for adding it at the end of the list with the next
+     * commitPending() call. The views don't see it until then.
+     *
+     * Use this when adding many packages at once: This avoids notifying the
+     * views for every single row.
+     *
+     * The exclude rules are checked right away, i.e. with the rules that are
+     * active at the time of this call.
+     **/
+    void appendPkg( ZyppSel selectable,
+                    ZyppPkg zyppPkg,
+                    bool    dimmed = false );
+
+    /**
+     * Add all packages queued with appendPkg() to the list with one single
+     * row insertion.
+     *
+     * Return value: The number of new rows. They start at row
+     * pkgCount() - <return value>.
+     **/
+    int commitPending();
+
+    /**
+     * Return the number of packages queued with appendPkg() that are not
+     * committed yet.
+     **/
+    int pendingCount() const { return _pendingRows.size(); }
+
+    /**
+     * Remove all packages (including pending ones) and the message (if there
+     * is one).
+     **/
+    void clear();
+
+    /**
+     * Set a one-line message that is displayed in the name column of an
+     * extra row at the end of the list. An empty text removes that row.
+     **/
+    void setMessage( const QString & text );
+
+    /**
+     * Return the number of (visible) packages in the list.
+     * Unlike rowCount(), this does not include the message row.
+     **/
+    int pkgCount() const { return _rows.size(); }
+
+    /**
+     * Return the selectable of a row or 0 if there is no such row
+     * (or if it is the message row).
+     **/
+    ZyppSel selectable( int row ) const;
+
+    /**
+     * Return the package of a row or 0 if there is no such row
+     * (or if it is the message row).
+     **/
+    ZyppPkg zyppPkg( int row ) const;
+
+    /**
+     * Set an additional icon for the version column of 'row'.
+     * An empty icon removes it again.
+     **/
+    void setVersionIcon( int row, const QIcon & icon );
+
+    /**
+     * Notify the attached views that the status of all packages may have
+     * changed. This is cheap since nothing is recomputed here; the view will
+     * only request the status icons of the rows it actually displays.
+     **/
+    void updateStates();
+
+    /**
+     * Notify the attached views that the status of the packages of
+     * 'selectables' may have changed. This only notifies about the rows of
+     * those packages.
+     **/
+    void updateStates( const ZyppSelSet & selectables );
+
+    /**
+     * Notify the attached views that all package data may have changed,
+     * e.g. after a candidate change.
+     **/
+    void updateData();
+
+    /**
+     * Remember the status and the versions of all packages and use them
+     * until thawStates() is called rather than getting them from the pool.
+     * Also remember the display texts and colors of the rows from
+     * 'firstCachedRow' to 'lastCachedRow'; the other rows are shown
+     * without any text until then, and there are no tooltips.
+     *
+     * Use this while the dependency resolver changes the pool in a worker
+     * thread: The views still repaint in the meantime, and even the names
+     * and versions of the packages are read from the pool.
+     **/
+    void freezeStates( int firstCachedRow, int lastCachedRow );
+
+    /**
+     * Get the status and the versions from the pool again after
+     * freezeStates() and notify the attached views.
+     **/
+    void thawStates();
+
+    /**
+     * Return the display text of a column of a row. While the states are
+     * frozen, this is only the remembered text, if any.
+     **/
+    QString text( int row, int col ) const;
+
+    /**
+     * Add an exclude rule. The model does not take ownership.
+     **/
+    void addExcludeRule( YQPkgObjList::ExcludeRule * rule );
+
+    /**
+     * Apply all exclude rules to all packages, including those that are
+     * currently excluded.
+     **/
+    void applyExcludeRules();
+
+    /**
+     * Return the number of currently excluded packages.
+     **/
+    int excludedCount() const { return _excludedRows.size(); }
+
+    /**
+     * Return 'true' if the candidate of 'selectable' is newer than the
+     * installed version.
+     **/
+    static bool candidateIsNewer( ZyppSel selectable );
+
+    /**
+     * Return 'true' if the installed version of 'selectable' is newer than
+     * the candidate or if there is no candidate.
+     **/
+    static bool installedIsNewer( ZyppSel selectable );
+
+    /**
+     * Calculate a numerical value to compare versions.
+     * See YQPkgObjListItem::versionPoints().
+     **/
+    static int versionPoints( ZyppSel selectable );
+
+
+    //
+    // Reimplemented from QAbstractItemModel
+    //
+
+    virtual QModelIndex index( int                 row,
+                               int                 column,
+                               const QModelIndex & parent = QModelIndex() ) const override;
+
+    virtual QModelIndex parent( const QModelIndex & index ) const override;
+
+    virtual int rowCount   ( const QModelIndex & parent = QModelIndex() ) const override;
+    virtual int columnCount( const QModelIndex & parent = QModelIndex() ) const override;
+
+    virtual QVariant data( const QModelIndex & index,
+                           int                 role = Qt::DisplayRole ) const override;
+
+    virtual QVariant headerData( int             section,
+                                 Qt::Orientation orientation,
+                                 int             role = Qt::DisplayRole ) const override;
+
+    virtual Qt::ItemFlags flags( const QModelIndex & index ) const override;
+
+    /**
+     * Sort the packages by 'column'. This uses the same criteria as
+     * YQPkgObjListItem::operator<().
+     **/
+    virtual void sort( int column, Qt::SortOrder order = Qt::AscendingOrder ) override;
+
+
+protected:
+
+    /**
+     * One row of the package list: Only the handles to the backend objects.
+     * All texts, icons and colors are created on demand in data().
+     **/
+    struct Row
+    {
+        ZyppSel selectable;
+        ZyppPkg zyppPkg;
+        bool    dimmed;
+    };
+
+    /**
+     * The values of a row that the dependency resolver might change.
+     **/
+    struct RowState
+    {
+        ZyppStatus                       status;
+        zypp::ResStatus::TransactByValue modifiedBy;
+        ZyppObj                          candidate;
+        ZyppObj                          installed;
+        bool                             valid;
+    };
+
+    /**
+     * Return the current state of 'row': From the pool, or after
+     * freezeStates() the one that was remembered then. If a row was added
+     * after freezeStates(), its state is not valid.
+     **/
+    RowState rowState( const Row & row ) const;
+
+    /**
+     * Get the state of 'selectable' from the pool.
+     **/
+    static RowState poolState( ZyppSel selectable );
+
+    /**
+     * Return 'true' if the candidate is newer than the installed version.
+     **/
+    static bool candidateIsNewer( const RowState & state );
+
+    /**
+     * Return 'true' if the installed version is newer than the candidate
+     * or if there is no candidate.
+     **/
+    static bool installedIsNewer( const RowState & state );
+
+    /**
+     * Return the text for column 'col' of 'row'.
+     **/
+    QString text( const Row & row, int col ) const;
+
+    /**
+     * Return the foreground color for column 'col' of 'row' or an invalid
+     * QVariant if the default color should be used.
+     **/
+    QVariant foreground( const Row & row, int col ) const;
+
+    /**
+     * Return the tool tip for column 'col' of 'row'.
+     **/
+    QString toolTip( const Row & row, int col ) const;
+
+    /**
+     * Return 'true' if any enabled exclude rule matches 'row'.
+     **/
+    bool isExcluded( const Row & row ) const;
+
+    /**
+     * Create a row for a package. Return 'false' if there is no package.
+     **/
+    bool makeRow( ZyppSel selectable,
+                  ZyppPkg zyppPkg,
+                  bool    dimmed,
+                  Row &   row ) const;
+
+    /**
+     * Sort 'sortedRows' (row numbers) by the key that 'sortKey' returns for
+     * each row. The keys are calculated only once per row before sorting,
+     * so each comparison is just a comparison of two keys.
+     **/
+    template<typename SortKeyFunc>
+    void sortByKey( QVector<int> &  sortedRows,
+                    SortKeyFunc     sortKey,
+                    Qt::SortOrder   order ) const;
+
+    /**
+     * Return 'true' if 'row' is the message row.
+     **/
+    bool isMessageRow( int row ) const
+        { return ! _message.isEmpty() && row == _rows.size(); }
+
+    /**
+     * Rebuild the index of rows by selectable.
+     **/
+    void rebuildRowIndex();
+
+    typedef QMultiHash<const zypp::ui::Selectable *, int> RowIndex;
+
+
+    //
+    // Data members
+    //
+
+    YQPkgListView *     _view;
+    QVector<Row>        _rows;
+    QVector<Row>        _excludedRows;
+    QVector<Row>        _pendingRows;
+    QString             _message;
+    QStringList         _headers;
+
+    QHash<const zypp::ui::Selectable *, QIcon> _versionIcons;
+
+    // Rows by selectable. This is rebuilt on demand after the rows changed.
+    RowIndex            _rowIndex;
+    bool                _rowIndexValid;
+
+    // States remembered by freezeStates()
+    QHash<const zypp::ui::Selectable *, RowState> _frozenStates;
+    bool                _statesFrozen;
+
+    // Display data remembered by freezeStates(): The texts and the text
+    // colors of all columns of some rows
+    struct FrozenDisplay
+    {
+        QStringList       texts;
+        QVector<QVariant> foregrounds;
+    };
+
+    QHash<const zypp::ui::Selectable *, FrozenDisplay> _frozenDisplay;
+
+    YQPkgObjList::ExcludeRuleList _excludeRules;
+
+    int                 _statusCol;
+    int                 _nameCol;
+    int                 _summaryCol;
+    int                 _versionCol;
+    int                 _instVersionCol;
+    int                 _sizeCol;
+};
+
+
+
+/**
+ * Model/view replacement for YQPkgList for the main package list of the
+ * package selector that can cope with tens of thousands of packages.
+ *
+ * This provides the same columns, slots, signals, context menus and actions
+ * as YQPkgList, so it can be connected to the filter views in exactly the
+ * same way.
+ **/
+class YQPkgListView: public QTreeView
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor
+     **/
+    YQPkgListView( QWidget * parent );
+
+    /**
+     * Destructor
+     **/
+    virtual ~YQPkgListView();
+
+    /**
+     * Return the model of this view.
+     **/
+    YQPkgListModel * pkgModel() const { return _model; }
+
+
+    // Column numbers
+
+    int statusCol()      const { return _model->statusCol();      }
+    int nameCol()        const { return _model->nameCol();        }
+    int summaryCol()     const { return _model->summaryCol();     }
+    int versionCol()     const { return _model->versionCol();     }
+    int instVersionCol() const { return _model->instVersionCol(); }
+    int sizeCol()        const { return _model->sizeCol();        }
+
+
+    // Text colors
+
+    QColor normalTextColor() const { return _normalTextColor; }
+    QColor blueTextColor()   const { return _blueTextColor;   }
+    QColor redTextColor()    const { return _redTextColor;    }
+
+    /**
+     * Return whether or not the packages in this list are editable, i.e. the
+     * user can change their status. Lists are editable by default.
+     **/
+    bool editable() const { return _editable; }
+
+    /**
+     * Set the list's editable status.
+     **/
+    void setEditable( bool editable = true ) { _editable = editable; }
+
+    /**
+     * Return the selectable of the current row or 0 if there is none.
+     **/
+    ZyppSel currentSelectable() const;
+
+    /**
+     * Set the status of the current package.
+     * Automatically selects the next item if 'selectNextItem' is 'true'.
+     **/
+    void setCurrentStatus( ZyppStatus newStatus,
+                           bool       selectNextItem = false,
+                           bool       ifNewerOnly    = false );
+
+    /**
+     * Set the status of all packages in this list to 'newStatus', if
+     * possible. Only one single statusChanged() signal is emitted.
+     *
+     * 'force' overrides sensible defaults like setting only packages to
+     * 'update' that really come with a newer version.
+     **/
+    void setAllItemStatus( ZyppStatus newStatus, bool force = false );
+
+    /**
+     * Set the status of all packages in the pool to a new value.
+     * See YQPkgList::globalSetPkgStatus().
+     *
+     * Return value: The number of status changes
+     **/
+    int globalSetPkgStatus( ZyppStatus newStatus, bool force, bool countOnly );
+
+    /**
+     * Add a submenu "All in this list..." to 'menu'.
+     * Returns the newly created submenu.
+     **/
+    QMenu * addAllInListSubMenu( QMenu * menu );
+
+    /**
+     * Add an exclude rule to this list. The list does not take ownership.
+     **/
+    void addExcludeRule( YQPkgObjList::ExcludeRule * rule );
+
+    /**
+     * Reserve a reasonable amount of space.
+     *
+     * Reimplemented from QWidget.
+     **/
+    virtual QSize sizeHint() const override;
+
+
+public slots:
+
+    /**
+     * Add a pkg to the list. Connect a filter's filterMatch() signal to this
+     * slot. Remember to connect filterStart() to clear().
+     *
+     * The package is not inserted immediately; all packages added in a row
+     * are inserted together with one single model update when control
+     * returns to the event loop or when resort() or selectSomething() is
+     * called (typically from the filter's filterFinished() signal).
+     **/
+    void addPkgItem( ZyppSel selectable,
+                     ZyppPkg zyppPkg );
+
+    /**
+     * Add a pkg to the list, but display it dimmed (grey text foreground
+     * rather than normal black).
+     **/
+    void addPkgItemDimmed( ZyppSel selectable,
+                           ZyppPkg zyppPkg );
+
+    /**
+     * Add a pkg to the list.
+     **/
+    void addPkgItem( ZyppSel selectable,
+                     ZyppPkg zyppPkg,
+                     bool    dimmed );
+
+    /**
+     * Insert all packages that were added with addPkgItem() and not inserted
+     * yet, and update the column widths once for all of them.
+     **/
+    void commitPendingItems();
+
+    /**
+     * Remove all packages from the list.
+     **/
+    void clear();
+
+    /**
+     * Sort the list again according to the current sort column and order.
+     **/
+    void resort();
+
+    /**
+     * Make the first package the current one (if there is any).
+     **/
+    void selectSomething();
+
+    /**
+     * Select the next package, i.e. move the selection one row down.
+     **/
+    void selectNextItem();
+
+    /**
+     * Update the status icons of all packages.
+     **/
+    void updateItemStates();
+
+    /**
+     * Update the status icons of the packages of 'selectables' only.
+     **/
+    void updateChangedItems( const ZyppSelSet & selectables );
+
+    /**
+     * Update all data of all packages.
+     **/
+    void updateItemData();
+
+    /**
+     * Don't get the package states from the pool until thawStates().
+     * See YQPkgListModel::freezeStates(). The display data of the visible
+     * rows and of one page above and below them are kept.
+     **/
+    void freezeStates();
+
+    /**
+     * Get the package states from the pool again.
+     **/
+    void thawStates();
+
+    /**
+     * Apply all exclude rules to all packages, including those that are
+     * currently excluded.
+     **/
+    void applyExcludeRules();
+
+    /**
+     * Display a one-line message in the list.
+     **/
+    void message( const QString & text );
+
+    /**
+     * Update the actions for the current package (if any).
+     **/
+    void updateActions();
+
+    /**
+     * Set the keyboard focus to this list unless the focus is currently on a
+     * similar widget that relies on heavy keyboard interaction, like another
+     * list.
+     **/
+    void maybeSetFocus();
+
+    /**
+     * Emit an updatePackages() signal.
+     **/
+    void sendUpdatePackages() { emit updatePackages(); }
+
+    /**
+     * Emit a statusChanged() signal.
+     **/
+    void sendStatusChanged() { emit statusChanged(); }
+
+
+    // Direct access to some states for menu actions
+
+    void setCurrentInstall()       { setCurrentStatus( S_Install        ); }
+    void setCurrentDontInstall()   { setCurrentStatus( S_NoInst         ); }
+    void setCurrentKeepInstalled() { setCurrentStatus( S_KeepInstalled  ); }
+    void setCurrentDelete()        { setCurrentStatus( S_Del            ); }
+    void setCurrentUpdate()        { setCurrentStatus( S_Update, false, true ); }
+    void setCurrentUpdateForce()   { setCurrentStatus( S_Update         ); }
+    void setCurrentTaboo()         { setCurrentStatus( S_Taboo          ); }
+    void setCurrentProtected()     { setCurrentStatus( S_Protected      ); }
+
+    void setListInstall()          { setAllItemStatus( S_Install        ); }
+    void setListDontInstall()      { setAllItemStatus( S_NoInst         ); }
+    void setListKeepInstalled()    { setAllItemStatus( S_KeepInstalled  ); }
+    void setListDelete()           { setAllItemStatus( S_Del            ); }
+    void setListUpdate()           { setAllItemStatus( S_Update         ); }
+    void setListUpdateForce()      { setAllItemStatus( S_Update, true   ); }
+    void setListTaboo()            { setAllItemStatus( S_Taboo          ); }
+    void setListProtected()        { setAllItemStatus( S_Protected      ); }
+
+
+signals:
+
+    /**
+     * Emitted when a package is selected.
+     * May be called with a null pointer if no package is selected.
+     **/
+    void currentItemChanged( ZyppSel selectable );
+
+    /**
+     * Emitted when the status of a package is changed.
+     **/
+    void statusChanged();
+
+    /**
+     * Emitted when it's time to update displayed package information,
+     * e.g., package states.
+     **/
+    void updatePackages();
+
+
+protected slots:
+
+    /**
+     * Notification that the current index changed.
+     **/
+    void currentRowChanged( const QModelIndex & current );
+
+    /**
+     * Mouse click or double click on a cell: Cycle the package status if it
+     * was the status column.
+     **/
+    void pkgClicked( const QModelIndex & index );
+
+    /**
+     * Show the context menu for the current package.
+     **/
+    void slotCustomContextMenu( const QPoint & pos );
+
+
+protected:
+
+    /**
+     * Set the status of the package in 'row'.
+     *
+     * If 'sendSignals' is 'true' (default), the usual update signals are
+     * sent if the status actually changed.
+     **/
+    void setStatus( int row, ZyppStatus newStatus, bool sendSignals = true );
+
+    /**
+     * Cycle the status of the package in 'row' to the next valid value.
+     **/
+    void cycleStatus( int row );
+
+    /**
+     * Display the notify text (if there is any) of 'selectable' that
+     * corresponds to 'status' (S_Install, S_Del) in a pop-up window.
+     **/
+    void showNotifyTexts( ZyppSel selectable, ZyppStatus status );
+
+    /**
+     * Initialize the text colors depending on the widget theme
+     * (light or dark).
+     **/
+    void initColors();
+
+    /**
+     * Create the actions for the context menus.
+     **/
+    void createActions();
+
+    /**
+     * Create an action based on a package status.
+     * 'key' is only a descriptive text, no true accelerator.
+     **/
+    QAction * createAction( ZyppStatus      status,
+                            const QString & key     = QString(),
+                            bool            enabled = false );
+
+    /**
+     * Low-level: Create an action.
+     * 'key' is only a descriptive text, no true accelerator.
+     **/
+    QAction * createAction( const QString & text,
+                            const QPixmap & icon            = QPixmap(),
+                            const QPixmap & insensitiveIcon = QPixmap(),
+                            const QString & key             = QString(),
+                            bool            enabled         = false );
+
+    /**
+     * Return the context menu for installed packages.
+     * Creates the menu upon the first call.
+     **/
+    QMenu * installedContextMenu();
+
+    /**
+     * Return the context menu for packages that are not installed.
+     * Creates the menu upon the first call.
+     **/
+    QMenu * notInstalledContextMenu();
+
+    /**
+     * Reset the optimal column width values.
+     **/
+    void resetBestColWidths();
+
+    /**
+     * Update the optimal column widths with the content of the rows from
+     * 'firstRow' to 'lastRow' (including both).
+     **/
+    void updateBestColWidths( int firstRow, int lastRow );
+
+    /**
+     * Optimize the column widths depending on content and the available
+     * horizontal space.
+     **/
+    void optimizeColumnWidths();
+
+    /**
+     * Event handler for keyboard input.
+     * Only very special keys are processed here.
+     *
+     * Reimplemented from QAbstractItemView.
+     **/
+    virtual void keyPressEvent( QKeyEvent * event ) override;
+
+    /**
+     * Handler for resize events.
+     * Triggers column width optimization.
+     *
+     * Reimplemented from QAbstractScrollArea.
+     **/
+    virtual void resizeEvent( QResizeEvent * event ) override;
+
+
+    //
+    // Data members
+    //
+
+    YQPkgListModel * _model;
+    bool             _editable;
+    QTimer           _commitTimer;
+
+    QColor           _normalTextColor;
+    QColor           _blueTextColor;
+    QColor           _redTextColor;
+
+    QMenu *          _installedContextMenu;
+    QMenu *          _notInstalledContextMenu;
+
+    int              _bestStatusColWidth;
+    int              _bestNameColWidth;
+    int              _bestSummaryColWidth;
+    int              _bestVersionColWidth;
+    int              _bestInstVersionColWidth;
+    int              _bestSizeColWidth;
+
+
+public:
+
+    QAction * actionSetCurrentInstall;
+    QAction * actionSetCurrentDontInstall;
+    QAction * actionSetCurrentKeepInstalled;
+    QAction * actionSetCurrentDelete;
+    QAction * actionSetCurrentUpdate;
+    QAction * actionSetCurrentUpdateForce;
+    QAction * actionSetCurrentTaboo;
+    QAction * actionSetCurrentProtected;
+
+    QAction * actionSetListInstall;
+    QAction * actionSetListDontInstall;
+    QAction * actionSetListKeepInstalled;
+    QAction * actionSetListDelete;
+    QAction * actionSetListUpdate;
+    QAction * actionSetListUpdateForce;
+    QAction * actionSetListTaboo;
+    QAction * actionSetListProtected;
+};
+
+
+#endif // ifndef YQPkgListView_h
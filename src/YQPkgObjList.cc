@@ -16,6 +16,7 @@
 
 #include <QAction>
 #include <QApplication>
+#include <QCollator>
 #include <QDebug>
 #include <QHeaderView>
 #include <QKeyEvent>
@@ -26,8 +27,11 @@
 
 #include "LicenseCache.h"
 #include "Logger.h"
+#include "PkgResolverScheduler.h"
+#include "PoolReaderThread.h"
 #include "QY2CursorHelper.h"
 #include "YQIconPool.h"
+#include "YQPkgSelector.h"
 #include "YQPkgTextDialog.h"
 #include "YQi18n.h"
 #include "utf8.h"
@@ -193,6 +197,7 @@ YQPkgObjList::clear()
 {
     emit currentItemChanged( ZyppSel() );
     _excludedItemsCount = 0;
+    _itemIndex.clear();
 
     QY2ListView::clear();
 }
@@ -206,8 +211,40 @@ YQPkgObjList::resetContent()
 }
 
 
+void
+YQPkgObjList::addToItemIndex( YQPkgObjListItem * item )
+{
+    if ( item && item->selectable() )
+        _itemIndex.insert( item->selectable().get(), item );
+}
+
+
+void
+YQPkgObjList::updateChangedItems( const ZyppSelSet & selectables )
+{
+    for ( const ZyppSel & selectable: selectables )
+    {
+        QMultiHash<const zypp::ui::Selectable *, YQPkgObjListItem *>::const_iterator it =
+            _itemIndex.constFind( selectable.get() );
+
+        while ( it != _itemIndex.constEnd() && it.key() == selectable.get() )
+        {
+            it.value()->updateStatus();
+            ++it;
+        }
+    }
+}
+
+
 QPixmap
 YQPkgObjList::statusIcon( ZyppStatus status, bool enabled, bool bySelection )
+{
+    return pkgStatusIcon( status, enabled, bySelection );
+}
+
+
+QPixmap
+YQPkgObjList::pkgStatusIcon( ZyppStatus status, bool enabled, bool bySelection )
 {
     QPixmap icon = YQIconPool::pkgNoInst();
 
@@ -258,6 +295,13 @@ YQPkgObjList::statusIcon( ZyppStatus status, bool enabled, bool bySelection )
 
 QString
 YQPkgObjList::statusText( ZyppStatus status ) const
+{
+    return pkgStatusText( status );
+}
+
+
+QString
+YQPkgObjList::pkgStatusText( ZyppStatus status )
 {
     switch ( status )
     {
@@ -277,6 +321,34 @@ YQPkgObjList::statusText( ZyppStatus status ) const
 }
 
 
+QByteArray
+YQPkgObjList::nameSortKey( const string & name )
+{
+    return QByteArray::fromStdString( name ).toLower();
+}
+
+
+QCollatorSortKey
+YQPkgObjList::summarySortKey( const string & summary )
+{
+    // Creating a QCollator is expensive, so use the same one for all keys.
+
+    static QCollator collator;
+
+    return collator.sortKey( fromUTF8( summary ) );
+}
+
+
+QByteArray
+YQPkgObjList::versionSortKey( int versionPoints, const zypp::Edition & edition )
+{
+    // Max. 1111 version points, so 4 digits are always enough
+
+    return QByteArray::number( versionPoints ).rightJustified( 4, '0' )
+        + QByteArray( edition.c_str() );
+}
+
+
 void
 YQPkgObjList::setCurrentStatus( ZyppStatus newStatus, bool doSelectNextItem, bool ifNewerOnly )
 {
@@ -838,13 +910,15 @@ YQPkgObjList::shouldKeepFocus( QWidget * widget ) const
 YQPkgObjListItem::YQPkgObjListItem( YQPkgObjList * pkgObjList,
                                     ZyppSel        selectable,
                                     ZyppObj        zyppObj )
-    : QY2ListViewItem( pkgObjList )
+    : QY2ListViewItem( pkgObjList, QString(), ItemType )
     , _pkgObjList( pkgObjList )
     , _selectable( selectable )
     , _zyppObj( zyppObj )
     , _editable( true )
     , _excluded( false )
+    , _sizeSortKey( 0 )
 {
+    _pkgObjList->addToItemIndex( this );
     init();
 }
 
@@ -853,24 +927,27 @@ YQPkgObjListItem::YQPkgObjListItem( YQPkgObjList *    pkgObjList,
                                     QY2ListViewItem * parent,
                                     ZyppSel           selectable,
                                     ZyppObj           zyppObj )
-    : QY2ListViewItem( parent )
+    : QY2ListViewItem( parent, QString(), ItemType )
     , _pkgObjList( pkgObjList )
     , _selectable( selectable )
     , _zyppObj( zyppObj )
     , _editable( true )
     , _excluded( false )
+    , _sizeSortKey( 0 )
 {
+    _pkgObjList->addToItemIndex( this );
     init();
 }
 
 
 YQPkgObjListItem::YQPkgObjListItem( YQPkgObjList * pkgObjList )
-    : QY2ListViewItem( pkgObjList )
+    : QY2ListViewItem( pkgObjList, QString(), ItemType )
     , _pkgObjList( pkgObjList )
     , _selectable( 0 )
     , _zyppObj( 0 )
     , _editable( true )
     , _excluded( false )
+    , _sizeSortKey( 0 )
 {
 }
 
@@ -904,6 +981,13 @@ YQPkgObjListItem::init()
     if ( installed && ! candidate )
         _installedIsNewer = true;
 
+    _nameSortKey    = nameSortKey( zyppObj()->name() );
+    _sizeSortKey    = zyppObj()->installSize();
+    _versionSortKey = versionSortKey( versionPoints(), zyppObj()->edition() );
+
+    if ( summaryCol() >= 0 )
+        _summarySortKey = summarySortKey( zyppObj()->summary() );
+
     if ( nameCol()    >= 0 )  setText( nameCol(),     zyppObj()->name()    );
     if ( summaryCol() >= 0 )  setText( summaryCol(),  zyppObj()->summary() );
 
@@ -1067,6 +1151,15 @@ YQPkgObjListItem::setStatus( ZyppStatus newStatus, bool sendSignals )
 void
 YQPkgObjListItem::solveResolvableCollections()
 {
+    // Not at the same time as a background resolver run,
+    // and not while any thread reads the pool
+
+    YQPkgSelector * pkgSel = YQPkgSelector::instance();
+
+    if ( pkgSel )
+        pkgSel->resolverScheduler()->waitForIdle();
+
+    PoolReaderBlocker readerBlocker;
     zypp::getZYpp()->resolver()->resolvePool();
 }
 
@@ -1299,6 +1392,9 @@ YQPkgObjListItem::showLicenseAgreement( ZyppSel sel )
 QString
 YQPkgObjListItem::toolTip( int col )
 {
+    if ( PoolReaderThread::isBlocked() ) // The resolver is busy with the pool
+        return QString();
+
     if ( col == statusCol() )
     {
         QString tip = _pkgObjList->statusText( status() );
@@ -1331,25 +1427,33 @@ YQPkgObjListItem::toolTip( int col )
 
 bool YQPkgObjListItem::operator<( const QTreeWidgetItem & otherListViewItem ) const
 {
-    const YQPkgObjListItem * other = dynamic_cast<const YQPkgObjListItem *> (&otherListViewItem);
+    // Check the item type rather than doing a dynamic_cast: This is called
+    // very often when sorting a large list.
+
+    const YQPkgObjListItem * other = 0;
+
+    if ( otherListViewItem.type() == ItemType )
+        other = static_cast<const YQPkgObjListItem *>( &otherListViewItem );
+
     int col = treeWidget()->sortColumn();
 
-    if ( other )
+    if ( other && _zyppObj && other->_zyppObj )
     {
         if ( col == nameCol() )
         {
-            return ( strcasecmp( this->zyppObj()->name().c_str(), other->zyppObj()->name().c_str() ) < 0 );
+            return _nameSortKey < other->_nameSortKey;
         }
         if ( col == summaryCol() )
         {
             // locale aware sort
-            return ( strcoll( this->zyppObj()->summary().c_str(), other->zyppObj()->summary().c_str() ) < 0 );
+            if ( _summarySortKey && other->_summarySortKey )
+                return *_summarySortKey < *other->_summarySortKey;
         }
         if ( col == sizeCol() )
         {
             // Numeric sort by size
 
-            return ( this->zyppObj()->installSize() < other->zyppObj()->installSize() );
+            return _sizeSortKey < other->_sizeSortKey;
         }
         else if ( col == statusCol() )
         {
@@ -1358,10 +1462,12 @@ bool YQPkgObjListItem::operator<( const QTreeWidgetItem & otherListViewItem ) co
             // where they make most sense. We want to show dangerous or
             // noteworthy states first - e.g., "taboo" which should seldeom
             // occur, but when it does, it is important.
+            //
+            // The status can change at any time, so there is no sort key for it.
 
             bool result = ( this->status() < other->status() );
             if ( ! result && this->status() == other->status() )
-                result = this->zyppObj()->name() < other->zyppObj()->name();
+                result = _nameSortKey < other->_nameSortKey;
             return result;
         }
         else if ( col == instVersionCol() ||
@@ -1376,15 +1482,10 @@ bool YQPkgObjListItem::operator<( const QTreeWidgetItem & otherListViewItem ) co
             //
             // Within these categories, sort versions by ASCII - OK, it's
             // pretty random, but predictable.
+            //
+            // The sort key contains both.
 
-            int thisPoints  = this->versionPoints();
-            int otherPoints = other->versionPoints();
-
-            if (thisPoints == otherPoints )
-                return ( QString (this->zyppObj()->edition().c_str() ) <
-                         QString (other->zyppObj()->edition().c_str() ) );
-            else
-                return ( thisPoints < otherPoints );
+            return _versionSortKey < other->_versionSortKey;
         }
     }
 
@@ -1425,7 +1526,8 @@ YQPkgObjList::ExcludeRule::ExcludeRule( YQPkgObjList *             parent,
     , _enabled( true )
     , _savedEnabled( true )
 {
-    _parent->addExcludeRule( this );
+    if ( _parent )
+        _parent->addExcludeRule( this );
 }
 
 
@@ -1477,7 +1579,15 @@ YQPkgObjList::ExcludeRule::match( QTreeWidgetItem * item )
     if ( ! _enabled )
         return false;
 
-    QString text = item->text( _column );
+    return match( item->text( _column ) );
+}
+
+
+bool
+YQPkgObjList::ExcludeRule::match( const QString & text ) const
+{
+    if ( ! _enabled )
+        return false;
 
     if ( text.isEmpty() )
         return false;
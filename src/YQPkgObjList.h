@@ -17,13 +17,17 @@
 #ifndef YQPkgObjList_h
 #define YQPkgObjList_h
 
+#include <QByteArray>
+#include <QCollatorSortKey>
 #include <QColor>
+#include <QMultiHash>
 #include <QPixmap>
 #include <QRegularExpression>
 #include <QMenu>
 #include <QEvent>
 
 #include <list>
+#include <optional>
 #include <string>
 
 #include <zypp/ResTraits.h>
@@ -137,6 +141,40 @@ public:
      **/
     virtual QString statusText( ZyppStatus status ) const;
 
+    /**
+     * Static version of statusIcon() for classes that are not derived from
+     * YQPkgObjList, but need the same icons (e.g. YQPkgListModel).
+     **/
+    static QPixmap pkgStatusIcon( ZyppStatus status,
+                                  bool       enabled     = true,
+                                  bool       bySelection = false );
+
+    /**
+     * Static version of statusText() for classes that are not derived from
+     * YQPkgObjList.
+     **/
+    static QString pkgStatusText( ZyppStatus status );
+
+    /**
+     * Return a sort key for a package name: The name with ASCII letters
+     * folded to lowercase, so a plain byte comparison gives the same order
+     * as strcasecmp().
+     **/
+    static QByteArray nameSortKey( const string & name );
+
+    /**
+     * Return a locale aware sort key for a summary.
+     **/
+    static QCollatorSortKey summarySortKey( const string & summary );
+
+    /**
+     * Return a sort key for the version columns: The version points (see
+     * YQPkgObjListItem::versionPoints()) as a fixed width number followed by
+     * the edition, so a plain byte comparison sorts by version points first
+     * and then by edition.
+     **/
+    static QByteArray versionSortKey( int versionPoints, const zypp::Edition & edition );
+
 
     class ExcludeRule;
     typedef std::list<ExcludeRule *> ExcludeRuleList;
@@ -164,6 +202,13 @@ public:
      **/
     void exclude( YQPkgObjListItem * item, bool exclude );
 
+    /**
+     * Add 'item' to the index of items by selectable that is used in
+     * updateChangedItems(). This is called in the YQPkgObjListItem
+     * constructor.
+     **/
+    void addToItemIndex( YQPkgObjListItem * item );
+
     /**
      * Make the inherited QTreeWidget::itemFromIndex() method public
      **/
@@ -215,6 +260,12 @@ public slots:
      **/
     virtual void resetContent();
 
+    /**
+     * Update the status display of the items for 'selectables' only.
+     * Unlike updateItemStates(), this does not iterate over all items.
+     **/
+    void updateChangedItems( const ZyppSelSet & selectables );
+
     /**
      * Update the internal actions for the currently selected item (if any).
      * This only calls updateActions( YQPkgObjListItem * ) with the currently
@@ -404,6 +455,8 @@ protected:
 
     ExcludeRuleList _excludeRules;
 
+    QMultiHash<const zypp::ui::Selectable *, YQPkgObjListItem *> _itemIndex;
+
 
 public:
 
@@ -432,6 +485,11 @@ class YQPkgObjListItem: public QY2ListViewItem
 {
 public:
 
+    /**
+     * QTreeWidgetItem type of all YQPkgObjListItems and derived classes.
+     **/
+    enum { ItemType = QTreeWidgetItem::UserType + 1 };
+
     /**
      * Constructor for root items: Creates a YQPkgObjList item that corresponds
      * to the ZYPP selectable that 'selectable' refers to. 'zyppObj' has to be
@@ -682,6 +740,14 @@ protected:
     bool           _candidateIsNewer:1;
     bool           _installedIsNewer:1;
     bool           _excluded:1;
+
+    // Sort keys, calculated in init() so operator<() can compare them
+    // directly without going to the zypp objects every time.
+
+    QByteArray                      _nameSortKey;
+    std::optional<QCollatorSortKey> _summarySortKey;
+    qint64                          _sizeSortKey;
+    QByteArray                      _versionSortKey;
 };
 
 
@@ -697,6 +763,9 @@ public:
      *
      * The parent YQPkgObjList will assume ownership of this exclude rule
      * and destroy it when the parent is destroyed.
+     *
+     * 'parent' may be 0 if the rule is to be added to a different kind of
+     * list, e.g. with YQPkgListView::addExcludeRule().
      **/
     ExcludeRule( YQPkgObjList *             parent,
                  const QRegularExpression & regexp,
@@ -765,6 +834,13 @@ public:
      **/
     bool match( QTreeWidgetItem * item );
 
+    /**
+     * Check a column text against this exclude rule.
+     * Returns 'true' if the text matches this exclude rule,
+     * i.e. if the corresponding item should be excluded.
+     **/
+    bool match( const QString & text ) const;
+
 private:
 
     YQPkgObjList *      _parent;
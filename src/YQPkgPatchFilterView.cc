@@ -35,7 +35,7 @@
 
 
 
-YQPkgPatchFilterView::YQPkgPatchFilterView( QWidget * parent )
+YQPkgPatchFilterView::YQPkgPatchFilterView( QWidget * parent, bool autoFill )
     : QWidget( parent )
 {
     QVBoxLayout *layout = new QVBoxLayout();
@@ -47,7 +47,7 @@ YQPkgPatchFilterView::YQPkgPatchFilterView( QWidget * parent )
 
     QWidget *     upper_box = new QWidget( _splitter );
     QVBoxLayout * vbox      = new QVBoxLayout( upper_box );
-    _patchList = new YQPkgPatchList( upper_box );
+    _patchList = new YQPkgPatchList( upper_box, autoFill );
 
     vbox->addWidget( _patchList );
 
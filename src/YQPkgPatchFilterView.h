@@ -38,9 +38,12 @@ class YQPkgPatchFilterView : public QWidget
 public:
 
     /**
-     * Constructor
+     * Constructor.
+     *
+     * Set 'autoFill' to 'false' if you don't want the list to be filled in the
+     * constructor. In that case, use reset() when it is needed.
      **/
-    YQPkgPatchFilterView( QWidget * parent );
+    YQPkgPatchFilterView( QWidget * parent, bool autoFill = true );
 
     /**
      * Destructor
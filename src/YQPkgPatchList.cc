@@ -20,6 +20,8 @@
 #include <QTreeWidgetItem>
 
 #include "Logger.h"
+#include "PoolReaderThread.h"
+#include "PoolStats.h"
 #include "YQIconPool.h"
 #include "YQi18n.h"
 #include "utf8.h"
@@ -33,7 +35,7 @@
 #define ENABLE_DELETING_PATCHES 1
 
 
-YQPkgPatchList::YQPkgPatchList( QWidget * parent )
+YQPkgPatchList::YQPkgPatchList( QWidget * parent, bool autoFill )
     : YQPkgObjList( parent )
 {
     logDebug() << "Creating patch list" << endl;
@@ -59,7 +61,8 @@ YQPkgPatchList::YQPkgPatchList( QWidget * parent )
                                                QTreeWidgetItem* ) ),
              this, SLOT  ( filter() ) );
 
-    fillList();
+    if ( autoFill )
+        fillList();
 
     logDebug() << "Creating patch list done" << endl;
 }
@@ -107,38 +110,14 @@ YQPkgPatchList::haveAnyPatches()
 bool
 YQPkgPatchList::haveNeededPatches()
 {
-    for ( ZyppPoolIterator it = zyppPatchesBegin();
-          it != zyppPatchesEnd();
-          ++it )
-    {
-        ZyppSel   selectable = *it;
-        ZyppPatch zyppPatch  = tryCastToZyppPatch( selectable->theObj() );
-
-        if ( isNeeded( selectable, zyppPatch ) )
-            return true;
-    }
-
-    return false; // No needed patches found
+    return PoolStats::instance()->haveNeededPatches();
 }
 
 
 int
 YQPkgPatchList::countNeededPatches()
 {
-    int count = 0;
-
-    for ( ZyppPoolIterator it = zyppPatchesBegin();
-          it != zyppPatchesEnd();
-          ++it )
-    {
-        ZyppSel   selectable = *it;
-        ZyppPatch zyppPatch  = tryCastToZyppPatch( selectable->theObj() );
-
-        if ( isNeeded( selectable, zyppPatch ) )
-            ++count;
-    }
-
-    return count;
+    return PoolStats::instance()->neededPatchesCount();
 }
 
 
@@ -497,6 +476,9 @@ YQPkgPatchListItem::cycleStatus()
 QString
 YQPkgPatchListItem::toolTip( int col )
 {
+    if ( PoolReaderThread::isBlocked() ) // The resolver is busy with the pool
+        return QString();
+
     QString text;
 
     if ( col == statusCol() )
@@ -53,9 +53,12 @@ class YQPkgPatchList : public YQPkgObjList
 public:
 
     /**
-     * Constructor
+     * Constructor.
+     *
+     * Set 'autoFill' to 'false' if you don't want the list to be filled in the
+     * constructor. In that case, use fillList() when it is needed.
      **/
-    YQPkgPatchList( QWidget * parent );
+    YQPkgPatchList( QWidget * parent, bool autoFill = true );
 
     /**
      * Destructor
@@ -89,9 +92,19 @@ public:
     /**
      * Return the number of needed patches in the pool, i.e. patches that are
      * relevant and not installed or satisfied yet.
+     * This is cached in PoolStats.
      **/
     static int countNeededPatches();
 
+    /**
+     * Return 'true' if 'zyppPatch' is non-null and a needed patch, i.e. a
+     * relevant patch that is not installed or satisfied yet.
+     *
+     * A patch is relevant if the packages that it consists of are installed,
+     * but in older versions than the ones that the patch brings.
+     **/
+    static bool isNeeded( ZyppSel selectable, ZyppPatch zyppPatch );
+
 
 public slots:
 
@@ -189,15 +202,6 @@ protected:
      */
     YQPkgPatchCategoryItem * category( YQPkgPatchCategory category );
 
-    /**
-     * Return 'true' if 'zyppPatch' is non-null and a needed patch, i.e. a
-     * relevant patch that is not installed or satisfied yet.
-     *
-     * A patch is relevant if the packages that it consists of are installed,
-     * but in older versions than the ones that the patch brings.
-     **/
-    static bool isNeeded( ZyppSel selectable, ZyppPatch zyppPatch );
-
     /**
      * Create the context menu for items that are not installed.
      *
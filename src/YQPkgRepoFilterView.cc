@@ -21,10 +21,10 @@
 #include "YQPkgRepoFilterView.h"
 
 
-YQPkgRepoFilterView::YQPkgRepoFilterView( QWidget * parent )
+YQPkgRepoFilterView::YQPkgRepoFilterView( QWidget * parent, bool autoFill )
     : YQPkgSecondaryFilterView( parent )
 {
-    _repoList = new YQPkgRepoList( this );
+    _repoList = new YQPkgRepoList( this, autoFill );
     CHECK_NEW( _repoList );
 
     init( _repoList) ;
@@ -49,6 +49,12 @@ YQPkgRepoFilterView::selectedRepo() const
 }
 
 
+void YQPkgRepoFilterView::fillRepoList()
+{
+    _repoList->fillList();
+}
+
+
 void YQPkgRepoFilterView::primaryFilter()
 {
     _repoList->filter();
@@ -29,9 +29,12 @@ class YQPkgRepoFilterView : public YQPkgSecondaryFilterView
 public:
 
     /**
-     * Constructor
+     * Constructor.
+     *
+     * Set 'autoFill' to 'false' if you don't want the list to be filled in the
+     * constructor. In that case, use fillRepoList() when it is needed.
      **/
-    YQPkgRepoFilterView( QWidget * parent );
+    YQPkgRepoFilterView( QWidget * parent, bool autoFill = true );
 
     /**
      * Destructor
@@ -43,6 +46,11 @@ public:
      **/
     zypp::Repository selectedRepo() const;
 
+    /**
+     * Fill the repo list again, e.g. after repos were reloaded.
+     **/
+    void fillRepoList();
+
 
 protected:
 
@@ -35,7 +35,7 @@ using std::string;
 // This is the simple version used in YQPkgRepoFilterView, not to confuse with
 // the more complex RepoTable in the RepoEditor.
 
-YQPkgRepoList::YQPkgRepoList( QWidget * parent )
+YQPkgRepoList::YQPkgRepoList( QWidget * parent, bool autoFill )
     : QY2ListView( parent )
 {
     // logVerbose() << "Creating repository list" << endl;
@@ -57,7 +57,9 @@ YQPkgRepoList::YQPkgRepoList( QWidget * parent )
     connect( this, SIGNAL( itemSelectionChanged() ),
 	     this, SLOT  ( filter()               ) );
 
-    fillList();
+    if ( autoFill )
+        fillList();
+
     setSortingEnabled( true );
     sortByColumn( nameCol(), Qt::AscendingOrder );
 
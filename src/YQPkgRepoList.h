@@ -42,9 +42,12 @@ class YQPkgRepoList : public QY2ListView
 public:
 
     /**
-     * Constructor
+     * Constructor.
+     *
+     * Set 'autoFill' to 'false' if you don't want the list to be filled in the
+     * constructor. In that case, use fillList() when it is needed.
      **/
-    YQPkgRepoList( QWidget * parent );
+    YQPkgRepoList( QWidget * parent, bool autoFill = true );
 
     /**
      * Destructor
@@ -73,6 +76,11 @@ public slots:
      **/
     void addRepo( ZyppRepo repo );
 
+    /**
+     * Fill the list.
+     **/
+    void fillList();
+
 
 public:
 
@@ -115,14 +123,6 @@ signals:
     void filterFinished();
 
 
-protected slots:
-
-    /**
-     * Fill the list.
-     **/
-    void fillList();
-
-
 private:
 
 
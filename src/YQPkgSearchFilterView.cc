@@ -27,9 +27,15 @@
 #include <QSettings>
 
 #include <zypp/PoolQuery.h>
+#include <zypp/sat/Pool.h>
 
 #include "Exception.h"
 #include "Logger.h"
+#include "MyrlynApp.h"
+#include "MyrlynRepoManager.h"
+#include "PkgSearchIndex.h"
+#include "PkgSearchWorker.h"
+#include "PoolReaderThread.h"
 #include "SearchFilter.h"
 #include "YQi18n.h"
 #include "utf8.h"
@@ -41,6 +47,16 @@
 #  define VERBOSE_FILTER_VIEWS  0
 #endif
 
+// Wait this long after the last keystroke before searching
+#define TYPE_AHEAD_DELAY_MILLISEC       150
+
+// Don't search for single characters while typing: That would match
+// almost everything
+#define TYPE_AHEAD_MIN_LEN              2
+
+// Try again this often to start a search while the resolver is busy
+#define READER_RETRY_MILLISEC           100
+
 
 using std::string;
 
@@ -48,6 +64,17 @@ using std::string;
 YQPkgSearchFilterView::YQPkgSearchFilterView( QWidget * parent )
     : QWidget( parent )
     , _ui( new Ui::SearchFilterView )
+    , _searchFilter( "" )
+    , _searchInFlags( 0 )
+    , _lastSearchFilter( "" )
+    , _lastSearchInFlags( 0 )
+    , _haveLastResults( false )
+    , _checkFilter( "" )
+    , _checkFlags( 0 )
+    , _checkPrepared( false )
+    , _worker( 0 )
+    , _overrideExcludeRuleDevel( false )
+    , _overrideExcludeRuleDebugInfo( false )
 {
     CHECK_NEW( _ui );
     _ui->setupUi( this ); // Actually create the widgets from the .ui form
@@ -66,19 +93,47 @@ YQPkgSearchFilterView::YQPkgSearchFilterView( QWidget * parent )
     connect( _ui->searchButton, SIGNAL( clicked() ),
              this,              SLOT  ( filter()  ) );
 
+    connect( _ui->cancelButton, SIGNAL( clicked()      ),
+             this,              SLOT  ( cancelSearch() ) );
+
     connect( _ui->searchMode,   SIGNAL( currentIndexChanged( int ) ),
              this,              SLOT  ( searchModeChanged  ( int ) ) );
 
     connect( _ui->searchText,   SIGNAL( textEdited              ( QString ) ),
              this,              SLOT  ( updateDetectedFilterMode( QString ) ) );
 
+    _typeAheadTimer.setSingleShot( true );
+    _typeAheadTimer.setInterval( TYPE_AHEAD_DELAY_MILLISEC );
+
+    connect( _ui->searchText,   SIGNAL( textEdited( QString ) ),
+             &_typeAheadTimer,  SLOT  ( start()               ) );
+
+    connect( &_typeAheadTimer,  SIGNAL( timeout()         ),
+             this,              SLOT  ( typeAheadSearch() ) );
+
+    _readerRetryTimer.setSingleShot( true );
+    _readerRetryTimer.setInterval( READER_RETRY_MILLISEC );
+
+    connect( &_readerRetryTimer, SIGNAL( timeout() ),
+             this,               SLOT  ( filter()  ) );
+
     readSettings();
     updateDetectedFilterMode();
+    showSearchProgress( false );
 }
 
 
 YQPkgSearchFilterView::~YQPkgSearchFilterView()
 {
+    _readerRetryTimer.stop();
+
+    if ( _worker )
+    {
+        _worker->disconnect( this );
+        _worker->requestInterruption();
+        delete _worker; // This waits for the thread to finish
+    }
+
     writeSettings();
     delete _ui;
 }
@@ -178,6 +233,12 @@ YQPkgSearchFilterView::keyPressEvent( QKeyEvent * event )
                 _ui->searchButton->animateClick();
                 return;
             }
+
+            if ( event->key() == Qt::Key_Escape && _worker )
+            {
+                cancelSearch();
+                return;
+            }
         }
 
     }
@@ -204,11 +265,63 @@ YQPkgSearchFilterView::showFilter( QWidget * newFilter )
 }
 
 
+void
+YQPkgSearchFilterView::typeAheadSearch()
+{
+    int len = _ui->searchText->text().length();
+
+    if ( len > 0 && len < TYPE_AHEAD_MIN_LEN )
+        return;
+
+    filter();
+}
+
+
 void
 YQPkgSearchFilterView::filter()
 {
-    bool overrideExcludeRuleDevel     = false;
-    bool overrideExcludeRuleDebugInfo = false;
+    _typeAheadTimer.stop();
+    _readerRetryTimer.stop();
+
+    if ( _worker )
+    {
+        // Preempt the search that is still running
+
+        logInfo() << "Canceling the previous search" << endl;
+
+        stopWorker();
+        restoreExcludeRules();
+    }
+
+    if ( ! PoolReaderThread::canStart() )
+    {
+        // The resolver is busy with the pool in its worker thread, or
+        // another thread still reads it, e.g. the previous search until it
+        // notices that it was canceled. Even the searches that don't use a
+        // worker thread read the pool, so all of them have to wait.
+        //
+        // When the previous search is finished, previousSearchFinished()
+        // tries again right away; the timer is for everything else.
+
+        logDebug() << "Pool busy; searching later" << endl;
+
+        _ui->matchCountLabel->setText( PoolReaderThread::isBlocked() ?
+                                       _( "Waiting for the dependency resolver..." ) :
+                                       _( "Waiting for the previous search..." ) );
+        showSearchProgress( true );
+        _readerRetryTimer.start();
+
+        return;
+    }
+
+    overrideExcludeRules();
+    filterInternal();
+}
+
+
+void
+YQPkgSearchFilterView::overrideExcludeRules()
+{
     QString searchText = _ui->searchText->text().toLower();
 
     if ( searchText.contains( "-devel" ) )
@@ -221,7 +334,7 @@ YQPkgSearchFilterView::filter()
             logInfo() << "Overriding -devel exclude rule" << endl;
 
             excludeRule->overrideEnabled( false );
-            overrideExcludeRuleDevel = true;
+            _overrideExcludeRuleDevel = true;
         }
     }
 
@@ -237,22 +350,27 @@ YQPkgSearchFilterView::filter()
             logInfo() << "Overriding -debuginfo / -debugsource exclude rule" << endl;
 
             excludeRule->overrideEnabled( false );
-            overrideExcludeRuleDebugInfo = true;
+            _overrideExcludeRuleDebugInfo = true;
         }
     }
+}
 
-    filterInternal();
 
-    if ( overrideExcludeRuleDevel )
+void
+YQPkgSearchFilterView::restoreExcludeRules()
+{
+    if ( _overrideExcludeRuleDevel )
     {
         logInfo() << "Restoring -devel exclude rule" << endl;
         YQPkgSelector::instance()->excludeRuleDevelPkgs()->restoreEnabled();
+        _overrideExcludeRuleDevel = false;
     }
 
-    if ( overrideExcludeRuleDebugInfo )
+    if ( _overrideExcludeRuleDebugInfo )
     {
         logDebug() << "Restoring -debuginfo / -debugsource exclude rule" << endl;
         YQPkgSelector::instance()->excludeRuleDebugInfoPkgs()->restoreEnabled();
+        _overrideExcludeRuleDebugInfo = false;
     }
 }
 
@@ -265,140 +383,446 @@ YQPkgSearchFilterView::filterInternal()
 #endif
 
     emit filterStart();
-    int matchCount = 0;
+    _results.clear();
 
-    try
+    if ( _ui->searchText->text().isEmpty() )
     {
-        if ( ! _ui->searchText->text().isEmpty() )
-        {
-            //
-            // Build the query
-            //
+        finishSearch();
+        return;
+    }
 
-            SearchFilter searchFilter( buildSearchFilterFromWidgets() );
+    //
+    // Build the query
+    //
 
-            // Use a zypp::PoolQuery for improved performance
-            zypp::PoolQuery query;
-            query.addKind( zypp::ResKind::package );
-            string searchPattern = toUTF8( searchFilter.pattern() );
-            query.setCaseSensitive( searchFilter.isCaseSensitive() );
+    SearchFilter searchFilter( buildSearchFilterFromWidgets() );
 
-            switch ( searchFilter.filterMode() )
-            {
-                case SearchFilter::Contains:
-                    query.setMatchSubstring();
-                    break;
-
-                case SearchFilter::StartsWith:
-                    query.setMatchRegex();
-                    searchPattern = "^" + searchPattern;
-                    break;
-
-                case SearchFilter::ExactMatch:
-                    query.setMatchExact();
-                    break;
-
-                case SearchFilter::Wildcard:
-                    query.setMatchGlob();
-                    break;
-
-                case SearchFilter::RegExp:
-                    query.setMatchRegex();
-                    break;
-
-                default:
-                    logError() << "Unexpected search mode "
-                               << SearchFilter::toString( searchFilter.filterMode() )
-                               << " - falling back to 'Contains'"
-                               << endl;
-                    query.setMatchSubstring();
-                    break;
-            }
+    _searchFilter  = searchFilter;
+    _searchInFlags = searchInFlags();
 
-            query.addString( searchPattern );
+    if ( canRefineResults( searchFilter ) )
+    {
+        refineResults( searchFilter );
+        return;
+    }
 
-            if ( _ui->searchInName->isChecked()        ) query.addAttribute( zypp::sat::SolvAttr::name );
-            if ( _ui->searchInDescription->isChecked() ) query.addAttribute( zypp::sat::SolvAttr::description );
-            if ( _ui->searchInSummary->isChecked()     ) query.addAttribute( zypp::sat::SolvAttr::summary );
-            if ( _ui->searchInRequires->isChecked()    ) query.addAttribute( zypp::sat::SolvAttr( "solvable:requires" ) );
-            if ( _ui->searchInProvides->isChecked()    ) query.addAttribute( zypp::sat::SolvAttr( "solvable:provides" ) );
-            if ( _ui->searchInFileList->isChecked()    ) query.addAttribute( zypp::sat::SolvAttr::filelist );
+    if ( searchWithIndex( searchFilter ) )
+        return;
 
-            _ui->searchText->setEnabled( false );   // Disable for the duration of the search
-            _ui->searchButton->setEnabled( false );
+    // Use a zypp::PoolQuery for improved performance
+    zypp::PoolQuery query;
+    query.addKind( zypp::ResKind::package );
+    string searchPattern = toUTF8( searchFilter.pattern() );
+    query.setCaseSensitive( searchFilter.isCaseSensitive() );
 
-            QElapsedTimer queryTimer;
-            queryTimer.start();
+    switch ( searchFilter.filterMode() )
+    {
+        case SearchFilter::Contains:
+            query.setMatchSubstring();
+            break;
+
+        case SearchFilter::StartsWith:
+            query.setMatchRegex();
+            searchPattern = "^" + searchPattern;
+            break;
+
+        case SearchFilter::ExactMatch:
+            query.setMatchExact();
+            break;
+
+        case SearchFilter::Wildcard:
+            query.setMatchGlob();
+            break;
+
+        case SearchFilter::RegExp:
+            query.setMatchRegex();
+            break;
+
+        default:
+            logError() << "Unexpected search mode "
+                       << SearchFilter::toString( searchFilter.filterMode() )
+                       << " - falling back to 'Contains'"
+                       << endl;
+            query.setMatchSubstring();
+            break;
+    }
 
-            //
-            // Start the query and iterate over the results
-            //
+    query.addString( searchPattern );
 
-            for ( zypp::PoolQuery::Selectable_iterator it = query.selectableBegin();
-                  it != query.selectableEnd();
-                  ++it )
-            {
-                ZyppSel selectable = *it;
-                ZyppPkg zyppPkg    = tryCastToZyppPkg( selectable->theObj() );
-
-                if ( zyppPkg )
-                {
-                    matchCount++;
-                    emit filterMatch( selectable, zyppPkg );
-                }
-
-
-                if ( queryTimer.elapsed() > 300 ) // milisec
-                {
-                    // Process events only every 300 milliseconds - this is very
-                    // expensive since both the progress dialog and the package
-                    // list change all the time, thus display updates are necessary
-                    // each time.
-
-                    qApp->processEvents();
-                    queryTimer.restart();
-                }
-            }
+    if ( _ui->searchInName->isChecked()        ) query.addAttribute( zypp::sat::SolvAttr::name );
+    if ( _ui->searchInDescription->isChecked() ) query.addAttribute( zypp::sat::SolvAttr::description );
+    if ( _ui->searchInSummary->isChecked()     ) query.addAttribute( zypp::sat::SolvAttr::summary );
+    if ( _ui->searchInRequires->isChecked()    ) query.addAttribute( zypp::sat::SolvAttr( "solvable:requires" ) );
+    if ( _ui->searchInProvides->isChecked()    ) query.addAttribute( zypp::sat::SolvAttr( "solvable:provides" ) );
+    if ( _ui->searchInFileList->isChecked()    ) query.addAttribute( zypp::sat::SolvAttr::filelist );
 
-            if ( matchCount == 0 )
-                emit message( _( "No Results." ) );
-        }
+    //
+    // Start the query in a worker thread; the results are collected in
+    // collectResults() and searchFinished().
+    //
+
+    _worker = new PkgSearchWorker( query, this );
+    CHECK_NEW( _worker );
+
+    connect( _worker, SIGNAL( resultsReady()   ),
+             this,    SLOT  ( collectResults() ) );
+
+    connect( _worker, SIGNAL( finished()       ),
+             this,    SLOT  ( searchFinished() ) );
+
+    _ui->matchCountLabel->setText( _( "%1 matches so far" ).arg( 0 ) );
+    showSearchProgress( true );
+
+    _worker->start();
+}
+
+
+void
+YQPkgSearchFilterView::collectResults()
+{
+    if ( ! _worker )
+        return;
+
+    // Getting the objects of the results reads the pool; not while the
+    // resolver is busy with it. They are discarded anyway in that case:
+    // The worker was interrupted, and searchFinished() starts over.
+
+    if ( PoolReaderThread::isBlocked() )
+        return;
+
+    const QVector<ZyppSel> results = _worker->takeResults();
+
+    for ( const ZyppSel & selectable: results )
+        emit filterMatch( selectable, tryCastToZyppPkg( selectable->theObj() ) );
+
+    _results += results;
+
+    _ui->matchCountLabel->setText( _( "%1 matches so far" ).arg( _worker->matchCount() ) );
+}
+
+
+void
+YQPkgSearchFilterView::searchFinished()
+{
+    if ( ! _worker )
+        return;
+
+    if ( _worker->isInterruptionRequested() )
+    {
+        // The user canceling the search disconnects the worker first, so
+        // this was the resolver: It needs the pool. The results so far are
+        // incomplete, so search again when the resolver is done.
+
+        logInfo() << "Search interrupted for the resolver; restarting it" << endl;
+
+        _worker->deleteLater();
+        _worker = 0;
+        restoreExcludeRules();
+        filter();
+
+        return;
     }
-    catch ( const std::exception & exception )
+
+    collectResults();
+
+    int     matchCount   = _worker->matchCount();
+    QString errorMessage = _worker->errorMessage();
+
+    _worker->deleteLater();
+    _worker = 0;
+
+    if ( ! errorMessage.isEmpty() )
+    {
+        showQueryError( errorMessage );
+    }
+    else
     {
-        logWarning() << "CAUGHT zypp exception: " << exception.what() << endl;
+        rememberResults();
+
+        if ( matchCount == 0 )
+            emit message( _( "No Results." ) );
+    }
+
+    finishSearch();
+}
+
+
+void
+YQPkgSearchFilterView::rememberResults()
+{
+    // Keep the results so they can be refined when the user types more
+
+    _lastSearchFilter  = _searchFilter;
+    _lastSearchInFlags = _searchInFlags;
+    _lastResults.swap( _results );
+    _results.clear();
+    _haveLastResults   = true;
 
-        QMessageBox msgBox;
+    // The selectables are only valid for the current pool content
+    _lastResultsPoolSerial.remember( zypp::sat::Pool::instance().serial() );
+}
 
-        // Translators: This is a (short) text indicating that something went
-        // wrong while searching for packages. At this point, it is not clear
-        // if it's a user error (e.g., syntax error in regular expression) or
-        // an internal error. But there is a "Details" button that will return
-        // the original (translated) error message.
 
-        QString heading = _( "Query Error" );
+bool
+YQPkgSearchFilterView::searchWithIndex( const SearchFilter & searchFilter )
+{
+    // The index only covers names and summaries
+
+    const int indexedFlags = SearchInName | SearchInSummary;
+
+    if ( _searchInFlags == 0 || ( _searchInFlags & ~indexedFlags ) != 0 )
+        return false;
+
+    const PkgSearchIndex & searchIndex = MyrlynApp::instance()->repoManager()->searchIndex();
+
+    if ( ! searchIndex.canSearch( searchFilter ) )
+        return false;
 
-        if ( heading.length() < 25 )    // Avoid very narrow message boxes
+    QElapsedTimer timer;
+    timer.start();
+
+    _results = searchIndex.find( searchFilter,
+                                 _searchInFlags & SearchInName,
+                                 _searchInFlags & SearchInSummary );
+
+    logDebug() << "Found " << _results.size() << " matches for " << searchFilter
+               << " in the search index in " << timer.elapsed() << " millisec" << endl;
+
+    for ( const ZyppSel & selectable: _results )
+        emit filterMatch( selectable, tryCastToZyppPkg( selectable->theObj() ) );
+
+    if ( _results.isEmpty() )
+        emit message( _( "No Results." ) );
+
+    rememberResults();
+    finishSearch();
+
+    return true;
+}
+
+
+void
+YQPkgSearchFilterView::forgetLastResults()
+{
+    _lastResults.clear();
+    _haveLastResults = false;
+}
+
+
+bool
+YQPkgSearchFilterView::canRefineResults( const SearchFilter & searchFilter ) const
+{
+    if ( ! _haveLastResults )
+        return false;
+
+    if ( ! _lastResultsPoolSerial.isClean( zypp::sat::Pool::instance().serial() ) )
+    {
+        logDebug() << "The pool changed; not refining the last results" << endl;
+        return false;
+    }
+
+    // Only those attributes can be checked in memory that can be retrieved
+    // quickly from the zypp objects. Dependencies and file lists need a
+    // PoolQuery.
+
+    const int refinableFlags = SearchInName | SearchInSummary | SearchInDescription;
+
+    if ( ( _searchInFlags & ~refinableFlags ) != 0 ||
+         _searchInFlags != _lastSearchInFlags )
+    {
+        return false;
+    }
+
+    return searchFilter.isRefinementOf( _lastSearchFilter );
+}
+
+
+void
+YQPkgSearchFilterView::refineResults( const SearchFilter & searchFilter )
+{
+    logDebug() << "Refining " << _lastResults.size()
+               << " previous results with " << searchFilter << endl;
+
+    for ( const ZyppSel & selectable: _lastResults )
+    {
+        if ( matchesInMemory( selectable, searchFilter ) )
         {
-            QString blanks;
-            blanks.fill( ' ', 50 - heading.length() );
-            heading += blanks;
+            _results.append( selectable );
+            emit filterMatch( selectable, tryCastToZyppPkg( selectable->theObj() ) );
         }
+    }
+
+    _lastSearchFilter = searchFilter;
+    _lastResults.swap( _results );
+    _results.clear();
+
+    if ( _lastResults.isEmpty() )
+        emit message( _( "No Results." ) );
+
+    finishSearch();
+}
+
+
+bool
+YQPkgSearchFilterView::matchesInMemory( ZyppSel              selectable,
+                                        const SearchFilter & searchFilter ) const
+{
+    ZyppObj zyppObj = selectable->theObj();
+
+    if ( ! zyppObj )
+        return false;
+
+    return
+        ( ( _searchInFlags & SearchInName        ) && searchFilter.matches( zyppObj->name()        ) ) ||
+        ( ( _searchInFlags & SearchInSummary     ) && searchFilter.matches( zyppObj->summary()     ) ) ||
+        ( ( _searchInFlags & SearchInDescription ) && searchFilter.matches( zyppObj->description() ) );
+}
+
+
+int
+YQPkgSearchFilterView::searchInFlags() const
+{
+    int flags = 0;
+
+    if ( _ui->searchInName->isChecked()        ) flags |= SearchInName;
+    if ( _ui->searchInSummary->isChecked()     ) flags |= SearchInSummary;
+    if ( _ui->searchInDescription->isChecked() ) flags |= SearchInDescription;
+    if ( _ui->searchInProvides->isChecked()    ) flags |= SearchInProvides;
+    if ( _ui->searchInRequires->isChecked()    ) flags |= SearchInRequires;
+    if ( _ui->searchInFileList->isChecked()    ) flags |= SearchInFileList;
+
+    return flags;
+}
+
+
+void
+YQPkgSearchFilterView::cancelSearch()
+{
+    if ( _readerRetryTimer.isActive() )
+    {
+        logInfo() << "Waiting search canceled by the user" << endl;
 
-        msgBox.setText( heading );
-        msgBox.setIcon( QMessageBox::Warning );
-        msgBox.setInformativeText( fromUTF8( exception.what() ) );
-        msgBox.exec();
+        _readerRetryTimer.stop();
+        showSearchProgress( false );
+
+        emit message( _( "Search canceled." ) );
+
+        return;
     }
 
-    _ui->searchText->setEnabled(true);   // Re-enable the widgets we disabled earlier
-    _ui->searchButton->setEnabled(true);
+    if ( ! _worker )
+        return;
+
+    logInfo() << "Search canceled by the user" << endl;
+
+    collectResults();
+    stopWorker();
+
+    emit message( _( "Search canceled." ) );
+    finishSearch();
+}
+
+
+void
+YQPkgSearchFilterView::stopWorker()
+{
+    if ( ! _worker )
+        return;
+
+    // Don't wait for the thread to notice the interruption request:
+    // It might be in the middle of a lengthy file list search.
+    // Let it delete itself when it's done.
+
+    _worker->disconnect( this );
+    _worker->requestInterruption();
+
+    connect( _worker, SIGNAL( finished()    ),
+             _worker, SLOT  ( deleteLater() ) );
+
+    connect( _worker, SIGNAL( finished()               ),
+             this,    SLOT  ( previousSearchFinished() ) );
+
+    if ( _worker->isFinished() ) // Too late for the finished() signal?
+        _worker->deleteLater();
+
+    _worker = 0;
+}
+
+
+void
+YQPkgSearchFilterView::previousSearchFinished()
+{
+    // Start the search that waits for this one to finish
+
+    if ( _readerRetryTimer.isActive() )
+        filter();
+}
+
+
+void
+YQPkgSearchFilterView::finishSearch()
+{
+    restoreExcludeRules();
+    showSearchProgress( false );
     parentWidget()->parentWidget()->setCursor( Qt::ArrowCursor );
 
     emit filterFinished();
 }
 
 
+void
+YQPkgSearchFilterView::showSearchProgress( bool show )
+{
+    _ui->matchCountLabel->setVisible( show );
+    _ui->cancelButton->setVisible( show );
+}
+
+
+void
+YQPkgSearchFilterView::showQueryError( const QString & details )
+{
+    QMessageBox msgBox;
+
+    // Translators: This is a (short) text indicating that something went
+    // wrong while searching for packages. At this point, it is not clear
+    // if it's a user error (e.g., syntax error in regular expression) or
+    // an internal error. But there is a "Details" button that will return
+    // the original (translated) error message.
+
+    QString heading = _( "Query Error" );
+
+    if ( heading.length() < 25 )    // Avoid very narrow message boxes
+    {
+        QString blanks;
+        blanks.fill( ' ', 50 - heading.length() );
+        heading += blanks;
+    }
+
+    msgBox.setText( heading );
+    msgBox.setIcon( QMessageBox::Warning );
+    msgBox.setInformativeText( details );
+    msgBox.exec();
+}
+
+
+void
+YQPkgSearchFilterView::prepareCheck()
+{
+    _checkFilter   = buildSearchFilterFromWidgets();
+    _checkFlags    = searchInFlags();
+    _checkPrepared = true;
+
+    _checkFilter.optimize();
+}
+
+
+void
+YQPkgSearchFilterView::finishCheck()
+{
+    _checkPrepared = false;
+}
+
+
 bool
 YQPkgSearchFilterView::check( ZyppSel   selectable,
                               ZyppObj   zyppObj )
@@ -406,14 +830,20 @@ YQPkgSearchFilterView::check( ZyppSel   selectable,
     if ( ! zyppObj )
         return false;
 
-    SearchFilter searchFilter( buildSearchFilterFromWidgets() );
+    bool prepared = _checkPrepared;
+
+    if ( ! prepared )
+        prepareCheck();
 
     bool match =
-        ( _ui->searchInName->isChecked()        && searchFilter.matches( zyppObj->name()         ) ) ||
-        ( _ui->searchInSummary->isChecked()     && searchFilter.matches( zyppObj->summary()      ) ) ||
-        ( _ui->searchInDescription->isChecked() && searchFilter.matches( zyppObj->description()  ) ) ||
-        ( _ui->searchInProvides->isChecked()    && checkCap( zyppObj->provides(), searchFilter   ) ) ||
-        ( _ui->searchInRequires->isChecked()    && checkCap( zyppObj->requires(), searchFilter   ) );
+        ( ( _checkFlags & SearchInName        ) && _checkFilter.matches( zyppObj->name()        ) ) ||
+        ( ( _checkFlags & SearchInSummary     ) && _checkFilter.matches( zyppObj->summary()     ) ) ||
+        ( ( _checkFlags & SearchInDescription ) && _checkFilter.matches( zyppObj->description() ) ) ||
+        ( ( _checkFlags & SearchInProvides    ) && checkCap( zyppObj->provides(), _checkFilter  ) ) ||
+        ( ( _checkFlags & SearchInRequires    ) && checkCap( zyppObj->requires(), _checkFilter  ) );
+
+    if ( ! prepared )
+        finishCheck();
 
     return match;
 }
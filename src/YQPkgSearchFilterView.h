@@ -17,9 +17,13 @@
 #ifndef YQPkgSearchFilterView_h
 #define YQPkgSearchFilterView_h
 
+#include <zypp/base/SerialNumber.h>
+
 #include "YQZypp.h"
 #include <QWidget>
 #include <QEvent>
+#include <QTimer>
+#include <QVector>
 #include <QWidget>
 
 #include "SearchFilter.h"
@@ -37,6 +41,7 @@ class QComboBox;
 class QCheckBox;
 class QPushButton;
 class QRadioButton;
+class PkgSearchWorker;
 
 
 /**
@@ -61,10 +66,37 @@ public:
     /**
      * Check one ResObject against the currently selected values.
      * Returns true if the package matches, false if not.
+     *
+     * When checking many packages in a row (e.g. as a secondary filter),
+     * call prepareCheck() before and finishCheck() after them.
      **/
     bool check( ZyppSel selectable,
                 ZyppObj zyppObj );
 
+    /**
+     * Build the SearchFilter for check() from the widgets once for a
+     * complete filter pass rather than for each package, and remember the
+     * "Search In" check boxes.
+     **/
+    void prepareCheck();
+
+    /**
+     * Discard the SearchFilter prepared with prepareCheck() so the next
+     * check() uses the current values from the widgets again.
+     **/
+    void finishCheck();
+
+    /**
+     * Return 'true' if a search is currently running in a worker thread.
+     **/
+    bool isSearching() const { return _worker != 0; }
+
+    /**
+     * Forget the results of the last search that are kept for refining
+     * them, e.g. because the pool changed.
+     **/
+    void forgetLastResults();
+
 
 public slots:
 
@@ -79,9 +111,19 @@ public slots:
      *    filterStart()
      *    filterMatch() for each pkg that matches the filter
      *    filterFinished()
+     *
+     * The search runs in a worker thread, so this returns immediately;
+     * filterMatch() and filterFinished() are emitted later from the event
+     * loop. A search that is still running is canceled.
      **/
     void filter();
 
+    /**
+     * Cancel the search that is currently running (if there is any).
+     * This emits filterFinished() with the results that were found so far.
+     **/
+    void cancelSearch();
+
     /**
      * Check if 'searchFilter' matches a zypp capabilites container 'capSet'
      * such as its 'provides()' or 'requires()'.
@@ -114,6 +156,29 @@ protected slots:
      **/
     void updateDetectedFilterMode( const QString & searchPattern );
 
+    /**
+     * Fetch the latest results from the search worker thread and emit a
+     * filterMatch() signal for each of them.
+     **/
+    void collectResults();
+
+    /**
+     * Notification that the search worker thread is finished.
+     **/
+    void searchFinished();
+
+    /**
+     * Notification that the user stopped typing in the search field for a
+     * moment: Search for the new text.
+     **/
+    void typeAheadSearch();
+
+    /**
+     * Called when a search that was canceled is finished: Start the search
+     * that waits for it, if there is one.
+     **/
+    void previousSearchFinished();
+
 
 signals:
 
@@ -144,9 +209,87 @@ protected:
 
     /**
      * The filtering without overriding and restoring any exclude rules.
+     * This only starts the search worker thread unless the results of the
+     * previous search can simply be refined.
      **/
     void filterInternal();
 
+    /**
+     * Search for 'searchFilter' in the search index of the package names and
+     * summaries if possible. Return 'false' if the index can't be used for
+     * this search and a PoolQuery is needed.
+     **/
+    bool searchWithIndex( const SearchFilter & searchFilter );
+
+    /**
+     * Keep the results of the current search as the last results that may
+     * be refined later.
+     **/
+    void rememberResults();
+
+    /**
+     * Check the results of the previous search against 'searchFilter'
+     * instead of searching the complete pool again and emit filterMatch()
+     * for each one that still matches.
+     **/
+    void refineResults( const SearchFilter & searchFilter );
+
+    /**
+     * Return 'true' if the previous results can be refined for
+     * 'searchFilter' with refineResults(), 'false' if a new PoolQuery is
+     * needed.
+     **/
+    bool canRefineResults( const SearchFilter & searchFilter ) const;
+
+    /**
+     * Check if 'selectable' matches 'searchFilter' in any of the attributes
+     * (name, summary, description) that are selected in the "Search In"
+     * check boxes. This is for refining previous search results, so it
+     * does not support all attributes.
+     **/
+    bool matchesInMemory( ZyppSel              selectable,
+                          const SearchFilter & searchFilter ) const;
+
+    /**
+     * Return the attributes to search in from the "Search In" check boxes
+     * as a combination of SearchIn flags.
+     **/
+    int searchInFlags() const;
+
+    /**
+     * Stop the search worker thread (if there is one) without waiting for
+     * it and without collecting any more results from it.
+     **/
+    void stopWorker();
+
+    /**
+     * Finish the current search: Restore the exclude rules, reset the
+     * widgets and emit filterFinished().
+     **/
+    void finishSearch();
+
+    /**
+     * Temporarily disable the exclude rules for -devel or -debuginfo
+     * packages if the user explicitly searches for such packages.
+     **/
+    void overrideExcludeRules();
+
+    /**
+     * Restore the exclude rules that were disabled with
+     * overrideExcludeRules().
+     **/
+    void restoreExcludeRules();
+
+    /**
+     * Show or hide the widgets that display the search progress.
+     **/
+    void showSearchProgress( bool show );
+
+    /**
+     * Show an error message about a failed query.
+     **/
+    void showQueryError( const QString & details );
+
     /**
      * Build a SearchFilter object from the widgets.
      **/
@@ -177,11 +320,48 @@ protected:
     void writeSettings();
 
 
+    enum SearchIn
+    {
+        SearchInName        = 0x01,
+        SearchInSummary     = 0x02,
+        SearchInDescription = 0x04,
+        SearchInProvides    = 0x08,
+        SearchInRequires    = 0x10,
+        SearchInFileList    = 0x20
+    };
+
+
     //
     // Data members
     //
 
     Ui::SearchFilterView * _ui;
+    QTimer                 _typeAheadTimer;
+    QTimer                 _readerRetryTimer;
+
+    // The current search and its results so far
+
+    SearchFilter           _searchFilter;
+    int                    _searchInFlags;
+    QVector<ZyppSel>       _results;
+
+    // The last complete search and its results
+
+    SearchFilter           _lastSearchFilter;
+    int                    _lastSearchInFlags;
+    QVector<ZyppSel>       _lastResults;
+    bool                   _haveLastResults;
+    zypp::SerialNumberWatcher _lastResultsPoolSerial;
+
+    // The prepared filter for check()
+
+    SearchFilter           _checkFilter;
+    int                    _checkFlags;
+    bool                   _checkPrepared;
+
+    PkgSearchWorker *      _worker;
+    bool                   _overrideExcludeRuleDevel;
+    bool                   _overrideExcludeRuleDebugInfo;
 };
 
 
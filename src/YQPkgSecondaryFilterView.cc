@@ -32,6 +32,10 @@
 
 YQPkgSecondaryFilterView::YQPkgSecondaryFilterView( QWidget * parent )
     : QWidget( parent )
+    , _secondaryFilters( 0 )
+    , _allPackages( 0 )
+    , _searchFilterView( 0 )
+    , _statusFilterView( 0 )
 {
 }
 
@@ -59,6 +63,14 @@ void YQPkgSecondaryFilterView::init(QWidget * primaryWidget)
     connect( primaryWidget, SIGNAL( filterFinished() ),
              this,          SIGNAL( filterFinished() ) );
 
+    // Prepare the secondary filter once for each pass of the primary filter
+
+    connect( primaryWidget, SIGNAL( filterStart()        ),
+             this,          SLOT  ( primaryFilterStart() ) );
+
+    connect( primaryWidget, SIGNAL( filterFinished()        ),
+             this,          SLOT  ( primaryFilterFinished() ) );
+
     // Redirect filterMatch() and filterNearMatch() signals to the secondary filter
 
     connect( primaryWidget, SIGNAL( filterMatch             ( ZyppSel, ZyppPkg ) ),
@@ -162,6 +174,24 @@ void YQPkgSecondaryFilterView::filter()
 }
 
 
+void YQPkgSecondaryFilterView::primaryFilterStart()
+{
+    // Build the search filter only once, not for every single package that
+    // the primary filter finds. This is cheap enough to also do it when the
+    // search filter view is not visible.
+
+    if ( _searchFilterView )
+        _searchFilterView->prepareCheck();
+}
+
+
+void YQPkgSecondaryFilterView::primaryFilterFinished()
+{
+    if ( _searchFilterView )
+        _searchFilterView->finishCheck();
+}
+
+
 void YQPkgSecondaryFilterView::primaryFilterMatch( ZyppSel selectable,
                                                    ZyppPkg pkg )
 {
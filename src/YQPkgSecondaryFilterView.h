@@ -100,6 +100,17 @@ public slots:
 
 protected slots:
 
+    /**
+     * Notification that the primary filter starts filtering:
+     * Prepare the secondary filter for checking many packages.
+     **/
+    void primaryFilterStart();
+
+    /**
+     * Notification that the primary filter is finished.
+     **/
+    void primaryFilterFinished();
+
     /**
      * Propagate a filter match from the primary filter
      * and appy any selected secondary filter(s) to it
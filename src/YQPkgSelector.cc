@@ -49,7 +49,13 @@
 #include "Logger.h"
 #include "QY2CursorHelper.h"
 #include "MyrlynApp.h"
+#include "MyrlynRepoManager.h"
+#include "PkgResolverScheduler.h"
+#include "PoolReaderThread.h"
+#include "PoolStats.h"
 #include "RepoConfigDialog.h"
+#include "SolverStatsDialog.h"
+#include "StartupTimer.h"
 #include "YQPkgChangeLogView.h"
 #include "YQPkgChangesDialog.h"
 #include "YQPkgClassificationFilterView.h"
@@ -62,6 +68,7 @@
 #include "YQPkgHistoryDialog.h"
 #include "YQPkgLangList.h"
 #include "YQPkgList.h"
+#include "YQPkgListView.h"
 #include "YQPkgPatchFilterView.h"
 #include "YQPkgPatchList.h"
 #include "YQPkgPatternList.h"
@@ -86,6 +93,14 @@
 #define DEPENDENCY_FEEDBACK_IF_OK              1
 #define GLOBAL_UPDATE_CONFIRMATION_THRESHOLD  20
 
+// Collect repos that changed in the background refresh for this long
+// before reloading them, so several repos are reloaded in one go.
+#define REPO_RELOAD_DELAY_MILLISEC          2000
+
+// Show at most this many names of packages whose changes were lost
+// when reloading repos
+#define MAX_LOST_CHANGES_SHOWN                20
+
 using std::max;
 using std::string;
 using std::map;
@@ -111,6 +126,8 @@ YQPkgSelector::YQPkgSelector( QWidget * parent )
     , _notificationsArea(0)
     , _switchToRepoLabel(0)
     , _cancelSwitchingToRepoLabel(0)
+    , _resolvingLabel(0)
+    , _repoReloadTimer(0)
     , _menuBar(0)
     , _pkgMenu(0)
     , _patchMenu(0)
@@ -131,25 +148,44 @@ YQPkgSelector::YQPkgSelector( QWidget * parent )
 
     logDebug() << "Creating YQPkgSelector..." << endl;
 
-    basicLayout();
-    addMenus();         // Only after all widgets are created!
-    readSettings();     // Only after menus are created!
-    makeConnections();
-    _filters->readSettings();
+    {
+        StartupPhase phase( "basicLayout" );
+        basicLayout();
+    }
 
-    if ( _filters->tabCount() == 0 )
     {
-        logDebug() << "No page configuration saved, using fallbacks" << endl;
-        showFallbackPages();
+        StartupPhase phase( "menusAndConnections" );
+        addMenus();         // Only after all widgets are created!
+        readSettings();     // Only after menus are created!
+        makeConnections();
+        connectRepoManager();
     }
 
-    overrideInitialPage(); // Only for very important special cases!
+    {
+        StartupPhase phase( "filterPages" );
+        _filters->readSettings();
+
+        if ( _filters->tabCount() == 0 )
+        {
+            logDebug() << "No page configuration saved, using fallbacks" << endl;
+            showFallbackPages();
+        }
+
+        overrideInitialPage(); // Only for very important special cases!
+    }
 
     if ( _filters->diskUsageList() )
-        _filters->diskUsageList()->updateDiskUsage();
+    {
+        StartupPhase phase( "diskUsage" );
+        _filters->diskUsageList()->updateDiskUsageNow();
+    }
 
     _blockResolver = false;
-    firstSolverRun();
+
+    {
+        StartupPhase phase( "firstSolverRun" );
+        firstSolverRun();
+    }
 
     logDebug() << "YQPkgSelector init done" << endl;
 }
@@ -238,6 +274,142 @@ void YQPkgSelector::firstSolverRun()
 }
 
 
+void YQPkgSelector::connectRepoManager()
+{
+    MyrlynRepoManager * repoManager = MyrlynApp::instance()->repoManager();
+
+    if ( ! repoManager || ! repoManager->isFastStart() )
+        return;
+
+    _repoReloadTimer = new QTimer( this );
+    CHECK_NEW( _repoReloadTimer );
+
+    _repoReloadTimer->setSingleShot( true );
+    _repoReloadTimer->setInterval( REPO_RELOAD_DELAY_MILLISEC );
+
+    connect( _repoReloadTimer, SIGNAL( timeout()            ),
+             this,             SLOT  ( reloadChangedRepos() ) );
+
+    connect( repoManager,      SIGNAL( repoCacheChanged( ZyppRepoInfo ) ),
+             _repoReloadTimer, SLOT  ( start()                        ) );
+
+    if ( repoManager->haveChangedRepos() )
+        _repoReloadTimer->start();
+}
+
+
+bool YQPkgSelector::canModifyPool() const
+{
+    // Not while the package commit is in progress or in any other workflow
+    // step: This page is not visible then.
+
+    if ( ! isVisible() )
+        return false;
+
+    // Not while a modal dialog like the conflict dialog shows pool items
+
+    if ( QApplication::activeModalWidget() )
+        return false;
+
+    // Not while a search or a details view worker thread is reading the
+    // pool; that includes abandoned ones that are not finished yet.
+
+    if ( ( _searchFilterView && _searchFilterView->isSearching() ) ||
+         PoolReaderThread::activeCount() > 0 )
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
+void YQPkgSelector::reloadChangedRepos()
+{
+    MyrlynRepoManager * repoManager = MyrlynApp::instance()->repoManager();
+
+    if ( ! repoManager->haveChangedRepos() )
+        return;
+
+    if ( ! canModifyPool() )
+    {
+        logDebug() << "Can't reload repos right now; trying again later" << endl;
+        _repoReloadTimer->start();
+        return;
+    }
+
+    busyCursor();
+
+    // The resolver works on the pool in a worker thread
+    _resolverScheduler->waitForIdle();
+
+    QStringList lostChanges;
+    int count = repoManager->reloadChangedRepos( &lostChanges );
+
+    if ( count > 0 )
+    {
+        // All views that keep ZyppSel pointers need to get new ones
+
+        if ( _searchFilterView )
+            _searchFilterView->forgetLastResults();
+
+        if ( isFilled( _repoFilterView ) )
+            _repoFilterView->fillRepoList();
+
+        if ( isFilled( _serviceFilterView ) )
+            _serviceFilterView->fillServiceList();
+
+        if ( isFilled( _patternList ) )
+            _patternList->fillList();
+
+        if ( isFilled( _patchFilterView ) )
+            _patchFilterView->reset();
+
+        if ( _pkgList )
+            _pkgList->clear();
+
+        if ( _filters )
+            _filters->reloadCurrentPage();
+
+        updatePageLabels();
+
+        if ( _filters->diskUsageList() )
+            _filters->diskUsageList()->updateDiskUsage();
+
+        logInfo() << "Reloaded " << count << " repos" << endl;
+
+        // The solver's changes for packages from those repos are gone
+        autoResolveDependencies();
+    }
+
+    normalCursor();
+
+    if ( ! lostChanges.isEmpty() )
+        showLostChanges( lostChanges );
+}
+
+
+void YQPkgSelector::showLostChanges( const QStringList & lostChanges )
+{
+    QStringList names = lostChanges;
+
+    if ( names.size() > MAX_LOST_CHANGES_SHOWN )
+    {
+        names = names.mid( 0, MAX_LOST_CHANGES_SHOWN );
+        names << "...";
+    }
+
+    QString msg = _( "Updated repository data were loaded in the background.\n"
+                     "Some of your changes are no longer possible with the new\n"
+                     "data and were reset:\n\n" );
+    msg += names.join( "\n" );
+
+    QMessageBox::information( this,                 // parent
+                              _( "Changes Reset" ), // window title
+                              msg );
+}
+
+
 void YQPkgSelector::basicLayout()
 {
     QVBoxLayout *layout = new QVBoxLayout();
@@ -254,6 +426,13 @@ void YQPkgSelector::basicLayout()
 
     layout->addWidget( _filters );
     createFilterViews();
+
+    // This needs to be connected before any filter view is connected to
+    // the same signal (see makeConnections()) so the page is filled first.
+
+    connect( _filters, SIGNAL( currentChanged( QWidget * ) ),
+             this,     SLOT  ( fillFilterPage( QWidget * ) ) );
+
     updatePageLabels();
     _filters->showPage( 0 );
 
@@ -302,8 +481,9 @@ void YQPkgSelector::createPatchFilterView( bool force )
     {
         if ( ! _patchFilterView )
         {
-            _patchFilterView = new YQPkgPatchFilterView( this );
+            _patchFilterView = new YQPkgPatchFilterView( this, false ); // autoFill
             CHECK_NEW( _patchFilterView );
+            _unfilledPages.insert( _patchFilterView );
 
             _filters->addPage( _( "Patc&hes" ), _patchFilterView,
                                "patches", Qt::CTRL | Qt::SHIFT | Qt::Key_H  );
@@ -324,8 +504,9 @@ void YQPkgSelector::createUpdatesFilterView()
 
 void YQPkgSelector::createRepoFilterView()
 {
-    _repoFilterView = new YQPkgRepoFilterView( this );
+    _repoFilterView = new YQPkgRepoFilterView( this, false ); // autoFill
     CHECK_NEW( _repoFilterView );
+    _unfilledPages.insert( _repoFilterView );
 
     _filters->addPage( _( "&Repositories" ), _repoFilterView,
                        "repos", Qt::CTRL | Qt::SHIFT | Qt::Key_R );
@@ -338,8 +519,9 @@ void YQPkgSelector::createServiceFilterView()
     if ( MyrlynApp::isOptionSet( OptForceServiceView ) ||
          YQPkgServiceFilterView::any_service() ) // Only if a service is present
     {
-        _serviceFilterView = new YQPkgServiceFilterView( this );
+        _serviceFilterView = new YQPkgServiceFilterView( this, false ); // autoFill
         CHECK_NEW( _serviceFilterView );
+        _unfilledPages.insert( _serviceFilterView );
 
         _filters->addPage( _( "Repository Index Ser&vices" ), _serviceFilterView,
                            "services", Qt::CTRL | Qt::SHIFT | Qt::Key_V );
@@ -351,8 +533,9 @@ void YQPkgSelector::createPatternsFilterView()
 {
     if ( ! zyppPool().empty<zypp::Pattern>() )
     {
-        _patternList = new YQPkgPatternList( this );
+        _patternList = new YQPkgPatternList( this, false ); // autoFill
         CHECK_NEW( _patternList );
+        _unfilledPages.insert( _patternList );
 
         _filters->addPage( _( "Pa&tterns" ), _patternList,
                            "patterns", Qt::CTRL | Qt::SHIFT | Qt::Key_T );
@@ -372,8 +555,9 @@ void YQPkgSelector::createPkgClassificationFilterView()
 
 void YQPkgSelector::createLanguagesFilterView()
 {
-    _langList = new YQPkgLangList( this );
+    _langList = new YQPkgLangList( this, false ); // autoFill
     CHECK_NEW( _langList );
+    _unfilledPages.insert( _langList );
     _langList->setSizePolicy( QSizePolicy( QSizePolicy::Ignored, QSizePolicy::Ignored ) ); // hor/vert
 
     _filters->addPage( _( "&Languages" ), _langList,
@@ -391,6 +575,40 @@ void YQPkgSelector::createStatusFilterView()
 }
 
 
+void YQPkgSelector::fillFilterPage( QWidget * page )
+{
+    if ( ! _unfilledPages.remove( page ) ) // Not lazy or already filled
+        return;
+
+    if ( page == _patchFilterView )
+    {
+        logDebug() << "Filling the patch list on first use" << endl;
+        _patchFilterView->reset();
+    }
+    else if ( page == _repoFilterView )
+    {
+        logDebug() << "Filling the repo list on first use" << endl;
+        _repoFilterView->fillRepoList();
+    }
+    else if ( page == _serviceFilterView )
+    {
+        logDebug() << "Filling the service list on first use" << endl;
+        _serviceFilterView->fillServiceList();
+    }
+    else if ( page == _patternList )
+    {
+        logDebug() << "Filling the pattern list on first use" << endl;
+        _patternList->fillList();
+    }
+    else if ( page == _langList )
+    {
+        logDebug() << "Filling the language list on first use" << endl;
+        _langList->fillList();
+        _langList->selectSomething();
+    }
+}
+
+
 // --- Filter views END ---
 
 
@@ -436,12 +654,34 @@ YQPkgSelector::layoutPkgList( QWidget * parent )
     pkgListVBox->addWidget( _notificationsArea );
 
 
+    // Message while the resolver runs in the background
+
+    _resolvingLabel = new QLabel( _( "Resolving package dependencies..." ), pkgListPane );
+    CHECK_NEW( _resolvingLabel );
+    _resolvingLabel->setVisible( false );
+    pkgListVBox->addWidget( _resolvingLabel );
+
+    connect( this,            SIGNAL( resolvingStarted()  ),
+             _resolvingLabel, SLOT  ( show()              ) );
+
+    connect( this,            SIGNAL( resolvingFinished() ),
+             _resolvingLabel, SLOT  ( hide()              ) );
+
+
     // Package list
 
-    _pkgList= new YQPkgList( pkgListPane );
+    _pkgList = new YQPkgListView( pkgListPane );
     CHECK_NEW( _pkgList );
     pkgListVBox->addWidget( _pkgList );
 
+    // The list still repaints while the resolver changes the pool
+
+    connect( this,     SIGNAL( resolvingStarted()  ),
+             _pkgList, SLOT  ( freezeStates()      ) );
+
+    connect( this,     SIGNAL( resolvingFinished() ),
+             _pkgList, SLOT  ( thawStates()        ) );
+
     connect( _pkgList,  SIGNAL( statusChanged()           ),
              this,      SLOT  ( autoResolveDependencies() ) );
 }
@@ -779,8 +1019,9 @@ YQPkgSelector::addMenus()
                                                 this, SLOT( pkgExcludeDevelChanged( bool ) ) );
     _showDevelAction->setCheckable( true );
 
-    _excludeDevelPkgs = new YQPkgObjList::ExcludeRule( _pkgList, QRegularExpression( ".*(\\d+bit)?-devel(-\\d+bit)?$" ), _pkgList->nameCol() );
+    _excludeDevelPkgs = new YQPkgObjList::ExcludeRule( 0, QRegularExpression( ".*(\\d+bit)?-devel(-\\d+bit)?$" ), _pkgList->nameCol() );
     CHECK_NEW( _excludeDevelPkgs );
+    _pkgList->addExcludeRule( _excludeDevelPkgs );
     _excludeDevelPkgs->enable( false );
 
     // Translators: This is about packages ending in "-debuginfo", so don't translate that "-debuginfo"!
@@ -788,8 +1029,9 @@ YQPkgSelector::addMenus()
                                                 Qt::Key_F8,
                                                 this, SLOT( pkgExcludeDebugChanged( bool ) ) );
     _showDebugAction->setCheckable(true);
-    _excludeDebugInfoPkgs = new YQPkgObjList::ExcludeRule( _pkgList, QRegularExpression( ".*(-\\d+bit)?-(debuginfo|debugsource)(-32bit)?$" ), _pkgList->nameCol() );
+    _excludeDebugInfoPkgs = new YQPkgObjList::ExcludeRule( 0, QRegularExpression( ".*(-\\d+bit)?-(debuginfo|debugsource)(-32bit)?$" ), _pkgList->nameCol() );
     CHECK_NEW( _excludeDebugInfoPkgs );
+    _pkgList->addExcludeRule( _excludeDebugInfoPkgs );
     _excludeDebugInfoPkgs->enable( false );
 
 
@@ -852,6 +1094,8 @@ YQPkgSelector::addMenus()
         extrasMenu->addSeparator();
         extrasMenu->addAction( _( "Generate Dependency Resolver &Test Case" ),
                                _pkgConflictDialog, SLOT( askCreateSolverTestCase() ) );
+        extrasMenu->addAction( _( "Dependency Resolver &Statistics" ),
+                               this, SLOT( showSolverStats() ) );
     }
 
 
@@ -1015,14 +1259,14 @@ YQPkgSelector::makeConnections()
     {
         if (_pkgList )
         {
-            connect( _pkgConflictDialog,        SIGNAL( updatePackages()   ),
-                     _pkgList,                  SLOT  ( updateItemStates() ) );
+            connect( _pkgConflictDialog,        SIGNAL( selectablesChanged( ZyppSelSet ) ),
+                     _pkgList,                  SLOT  ( updateChangedItems( ZyppSelSet ) ) );
         }
 
         if ( _patternList )
         {
-            connect( _pkgConflictDialog,        SIGNAL( updatePackages()   ),
-                     _patternList,              SLOT  ( updateItemStates() ) );
+            connect( _pkgConflictDialog,        SIGNAL( selectablesChanged( ZyppSelSet ) ),
+                     _patternList,              SLOT  ( updateChangedItems( ZyppSelSet ) ) );
         }
 
         if ( _filters->diskUsageList() )
@@ -1076,10 +1320,13 @@ YQPkgSelector::makeConnections()
 void
 YQPkgSelector::autoResolveDependencies()
 {
+    // This is called for every status change by the user
+    PoolStats::instance()->invalidate();
+
     if ( _autoDependenciesAction && ! _autoDependenciesAction->isChecked() )
         return;
 
-    resolveDependencies();
+    scheduleResolveDependencies();
 }
 
 
@@ -1092,9 +1339,16 @@ YQPkgSelector::manualResolvePackageDependencies()
         return QDialog::Accepted;
     }
 
-    busyCursor();
-    int result = _pkgConflictDialog->solveAndShowConflicts();
-    normalCursor();
+    _resolverScheduler->waitForIdle();
+    int result;
+
+    {
+        PoolReaderBlocker readerBlocker;
+
+        busyCursor();
+        result = _pkgConflictDialog->solveAndShowConflicts();
+        normalCursor();
+    }
 
 #if DEPENDENCY_FEEDBACK_IF_OK
 
@@ -1140,8 +1394,8 @@ YQPkgSelector::connectPatchFilterView()
 
         if ( _pkgConflictDialog )
         {
-            connect( _pkgConflictDialog, SIGNAL( updatePackages()   ),
-                     patchList,          SLOT  ( updateItemStates() ) );
+            connect( _pkgConflictDialog, SIGNAL( selectablesChanged( ZyppSelSet ) ),
+                     patchList,          SLOT  ( updateChangedItems( ZyppSelSet ) ) );
         }
     }
 
@@ -1164,8 +1418,8 @@ YQPkgSelector::connectPatternList()
 
     if ( _pkgConflictDialog )
     {
-        connect( _pkgConflictDialog, SIGNAL( updatePackages()   ),
-                 _patternList,       SLOT  ( updateItemStates() ) );
+        connect( _pkgConflictDialog, SIGNAL( selectablesChanged( ZyppSelSet ) ),
+                 _patternList,       SLOT  ( updateChangedItems( ZyppSelSet ) ) );
     }
 }
 
@@ -1177,8 +1431,13 @@ YQPkgSelector::reset()
 
     resetResolver();
     LicenseCache::confirmed()->clear();
+    PoolStats::instance()->invalidate();
 
-    if ( _patchFilterView )
+    // The last search results have ZyppSel pointers from the old pool
+    if ( _searchFilterView )
+        _searchFilterView->forgetLastResults();
+
+    if ( isFilled( _patchFilterView ) )
         _patchFilterView->reset();
 
     if ( _pkgList )
@@ -1231,8 +1490,14 @@ YQPkgSelector::configRepos()
 void
 YQPkgSelector::updatePageLabels()
 {
-    updatePageLabel( _( "Patc&hes" ), _patchFilterView,   YQPkgPatchList::countNeededPatches()   );
-    updatePageLabel( _( "&Updates" ), _updatesFilterView, YQPkgUpdatesFilterView::countUpdates() );
+    // The counts don't need the lists of those filter views, so this works
+    // even if they were not filled yet.
+
+    if ( _patchFilterView )
+        updatePageLabel( _( "Patc&hes" ), _patchFilterView, YQPkgPatchList::countNeededPatches() );
+
+    if ( _updatesFilterView )
+        updatePageLabel( _( "&Updates" ), _updatesFilterView, YQPkgUpdatesFilterView::countUpdates() );
 }
 
 
@@ -1257,8 +1522,7 @@ YQPkgSelector::globalUpdatePkg( bool force )
     if ( ! _pkgList )
         return;
 
-    int count = _pkgList->globalSetPkgStatus( S_Update, force,
-                                              true ); // countOnly
+    int count = PoolStats::instance()->updateCandidatesCount( force );
     logInfo() << count << " pkgs found for update" << endl;
 
     if ( count >= GLOBAL_UPDATE_CONFIRMATION_THRESHOLD )
@@ -1394,7 +1658,7 @@ YQPkgSelector::switchToRepo( const QString & link )
     else
         logDebug() << "unknown link operation " << url.scheme() << endl;
 
-    resolveDependencies();
+    resolveDependencies( SolverRun::RepoSwitch );
 }
 
 
@@ -1412,6 +1676,13 @@ YQPkgSelector::showHistory()
 }
 
 
+void
+YQPkgSelector::showSolverStats()
+{
+    SolverStatsDialog::showSolverStatsDialog( this );
+}
+
+
 void
 YQPkgSelector::installDevelPkgs()
 {
@@ -1626,20 +1897,14 @@ YQPkgSelector::installSubPkgs( const QString & suffix )
 bool
 YQPkgSelector::anyRetractedPkgInstalled()
 {
-    // logVerbose() << "Checking for retracted installed packages..." << endl;
-
-    for ( ZyppPoolIterator it = zyppPkgBegin(); it != zyppPkgEnd(); ++it )
-    {
-        if ( (*it)->hasRetractedInstalled() )
-        {
-            logInfo() << "Found a retracted installed package" << endl;
-            return true;
-        }
-    }
+    bool found = PoolStats::instance()->anyRetractedPkgInstalled();
 
-    logDebug() << "No retracted packages installed." << endl;
+    if ( found )
+        logInfo() << "Found a retracted installed package" << endl;
+    else
+        logDebug() << "No retracted packages installed." << endl;
 
-    return false;
+    return found;
 }
 
 
@@ -1737,6 +2002,7 @@ YQPkgSelector::writeResolverSettings()
 
     settings.setValue( "autoCheckDependencies", _autoDependenciesAction->isChecked()   );
     settings.setValue( "installRecommended",    _installRecommendedAction->isChecked() );
+    settings.setValue( "slowRunWarningMillisec", SolverStats::instance()->slowRunMillisec() );
 
     if ( _verifySystemModeAction )
         settings.setValue( "verifySystem",      _verifySystemModeAction->isChecked()   );
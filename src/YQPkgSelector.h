@@ -19,6 +19,8 @@
 
 #include <QWidget>
 #include <QColor>
+#include <QSet>
+#include <QStringList>
 
 #include "YQPkgSelectorBase.h"
 #include "YQPkgObjList.h"
@@ -35,7 +37,7 @@ class YQPkgDescriptionView;
 class YQPkgFileListView;
 class YQPkgFilterTab;
 class YQPkgLangList;
-class YQPkgList;
+class YQPkgListView;
 class YQPkgClassificationFilterView;
 class YQPkgPatchFilterView;
 class YQPkgPatternList;
@@ -76,7 +78,7 @@ public:
      * Return the package list of this istance or 0 if it hasn't been created
      * yet.
      **/
-    YQPkgList * pkgList() const { return _pkgList; }
+    YQPkgListView * pkgList() const { return _pkgList; }
 
     /**
      * Return the exclude rule for "-devel" packages.
@@ -244,6 +246,28 @@ protected slots:
      **/
     void showHistory();
 
+    /**
+     * Show the statistics of the dependency resolver runs
+     **/
+    void showSolverStats();
+
+    /**
+     * Reload the repos that changed in the background refresh into the
+     * pool (see --fast-start) and update all views. If anything else is
+     * using the pool right now, try again later.
+     *
+     * The user's changes are kept; if that is not possible for some of
+     * them, the user is told.
+     **/
+    void reloadChangedRepos();
+
+    /**
+     * Fill the list of filter view page 'page' if this wasn't done yet.
+     * This is connected to the filter tab's currentChanged() signal before
+     * any of the filter views, so each one has its data before it filters.
+     **/
+    void fillFilterPage( QWidget * page );
+
     /**
      * a link in the repo upgrade label was clicked
      **/
@@ -288,6 +312,23 @@ protected:
      **/
     void firstSolverRun();
 
+    /**
+     * Set up reloading repos that changed in the background refresh.
+     **/
+    void connectRepoManager();
+
+    /**
+     * Return 'true' if the pool can be modified right now, i.e. if nothing
+     * else is using it.
+     **/
+    bool canModifyPool() const;
+
+    /**
+     * Tell the user that the changes for the selectables in 'lostChanges'
+     * could not be kept when reloading repos.
+     **/
+    void showLostChanges( const QStringList & lostChanges );
+
 
     // Layout methods - create and layout widgets
 
@@ -328,6 +369,13 @@ protected:
                           QWidget *       page,
                           int             count );
 
+    /**
+     * Return 'true' if filter view page 'page' exists and its list was
+     * already filled, 'false' if not.
+     **/
+    bool isFilled( QWidget * page ) const
+        { return page && ! _unfilledPages.contains( page ); }
+
     /**
      * Establish Qt signal / slot connections.
      *
@@ -419,7 +467,7 @@ protected:
     // Data members
     //
 
-    YQPkgList *                         _pkgList;
+    YQPkgListView *                     _pkgList;
     YQPkgFilterTab *                    _filters;
 
     // Filter Views
@@ -433,11 +481,17 @@ protected:
     YQPkgStatusFilterView *             _statusFilterView;
     YQPkgLangList *                     _langList;
 
+    // Filter views that iterate over the pool to fill their lists are
+    // created empty; they are filled when they are first shown.
+    QSet<QWidget *>                     _unfilledPages;
+
     // Other widgets
     YQPkgVersionsView *                 _pkgVersionsView;
     QWidget *                           _notificationsArea;
     QLabel *                            _switchToRepoLabel;
     QLabel *                            _cancelSwitchingToRepoLabel;
+    QLabel *                            _resolvingLabel;
+    QTimer *                            _repoReloadTimer;
 
     // Menus
     QMenuBar *                          _menuBar;
@@ -23,7 +23,9 @@
 
 #include "LicenseCache.h"
 #include "Logger.h"
+#include "PkgResolverScheduler.h"
 #include "PkgTasks.h"
+#include "PoolReaderThread.h"
 #include "QY2CursorHelper.h"
 #include "MyrlynApp.h"
 #include "YQPkgChangesDialog.h"
@@ -43,8 +45,8 @@ YQPkgSelectorBase::YQPkgSelectorBase( QWidget * parent )
     , _blockResolver( true )
 {
     _pkgConflictDialog = 0;
+    _resolverScheduler = 0;
     _diskUsageList     = 0;
-    _pkgConflictDialog = 0;
 
     // YQUI::setTextdomain( "qt-pkg" );
     // setFont( YQUI::yqApp()->currentFont() );
@@ -52,6 +54,15 @@ YQPkgSelectorBase::YQPkgSelectorBase( QWidget * parent )
     _pkgConflictDialog = new YQPkgConflictDialog( this );
     Q_CHECK_PTR( _pkgConflictDialog );
 
+    _resolverScheduler = new PkgResolverScheduler( _pkgConflictDialog, this );
+    Q_CHECK_PTR( _resolverScheduler );
+
+    connect( _resolverScheduler, SIGNAL( solvingStarted()   ),
+             this,               SIGNAL( resolvingStarted() ) );
+
+    connect( _resolverScheduler, SIGNAL( solvingFinished()   ),
+             this,               SIGNAL( resolvingFinished() ) );
+
     zyppPool().saveState<zypp::Package>();
     zyppPool().saveState<zypp::Pattern>();
     zyppPool().saveState<zypp::Patch  >();
@@ -64,6 +75,7 @@ YQPkgSelectorBase::YQPkgSelectorBase( QWidget * parent )
 YQPkgSelectorBase::~YQPkgSelectorBase()
 {
     logInfo() << "Destroying PackageSelectorBase" << endl;
+    SolverStats::instance()->logSummary();
 }
 
 
@@ -77,6 +89,12 @@ void YQPkgSelectorBase::resetResolver()
 
 
 int YQPkgSelectorBase::resolveDependencies()
+{
+    return resolveDependencies( SolverRun::Resolve );
+}
+
+
+int YQPkgSelectorBase::resolveDependencies( SolverRun::Trigger trigger )
 {
     if ( _blockResolver )
         return QDialog::Rejected;
@@ -88,10 +106,17 @@ int YQPkgSelectorBase::resolveDependencies()
     }
 
 
+    // A background resolver run would be outdated now
+    _resolverScheduler->waitForIdle();
+
+    // Search and details view threads must not read the pool while the
+    // resolver changes it
+    PoolReaderBlocker readerBlocker;
+
     busyCursor();
     emit resolvingStarted();
 
-    int result = _pkgConflictDialog->solveAndShowConflicts();
+    int result = _pkgConflictDialog->solveAndShowConflicts( trigger );
 
     emit resolvingFinished();
     normalCursor();
@@ -100,6 +125,15 @@ int YQPkgSelectorBase::resolveDependencies()
 }
 
 
+void YQPkgSelectorBase::scheduleResolveDependencies()
+{
+    if ( _blockResolver || ! _resolverScheduler )
+        return;
+
+    _resolverScheduler->requestSolve();
+}
+
+
 int YQPkgSelectorBase::verifySystem()
 {
     if ( ! _pkgConflictDialog )
@@ -109,9 +143,16 @@ int YQPkgSelectorBase::verifySystem()
     }
 
 
-    busyCursor();
-    int result = _pkgConflictDialog->verifySystem();
-    normalCursor();
+    _resolverScheduler->waitForIdle();
+    int result;
+
+    {
+        PoolReaderBlocker readerBlocker;
+
+        busyCursor();
+        result = _pkgConflictDialog->verifySystem();
+        normalCursor();
+    }
 
     if ( result == QDialog::Accepted )
     {
@@ -19,6 +19,7 @@
 
 #include <QFrame>
 
+#include "SolverStats.h"
 #include "YQZypp.h"
 
 
@@ -26,6 +27,7 @@ class QObject;
 class QWidget;
 class QAction;
 
+class PkgResolverScheduler;
 class YQPkgConflictDialog;
 class YQPkgDiskUsageList;
 
@@ -53,6 +55,15 @@ protected:
     virtual ~YQPkgSelectorBase();
 
 
+public:
+
+    /**
+     * Return the scheduler for the background resolver runs. Use its
+     * waitForIdle() before running the resolver synchronously.
+     **/
+    PkgResolverScheduler * resolverScheduler() const { return _resolverScheduler; }
+
+
 public slots:
 
     /**
@@ -71,6 +82,22 @@ public slots:
      **/
     int resolveDependencies();
 
+    /**
+     * The same as resolveDependencies(), but with a different trigger for
+     * the solver statistics.
+     **/
+    int resolveDependencies( SolverRun::Trigger trigger );
+
+    /**
+     * Resolve dependencies in the background after a short delay.
+     * Several calls in quick succession result in only one resolver run.
+     *
+     * Use this for automatic resolver runs after status changes;
+     * resolvingStarted() and resolvingFinished() are emitted when the
+     * resolver actually runs.
+     **/
+    void scheduleResolveDependencies();
+
     /**
      * Verifies dependencies of the currently installed system.
      *
@@ -203,9 +230,10 @@ protected:
 
     // Data members
 
-    bool                  _blockResolver;
-    YQPkgConflictDialog * _pkgConflictDialog;
-    YQPkgDiskUsageList *  _diskUsageList;
+    bool                   _blockResolver;
+    YQPkgConflictDialog *  _pkgConflictDialog;
+    PkgResolverScheduler * _resolverScheduler;
+    YQPkgDiskUsageList *   _diskUsageList;
 };
 
 
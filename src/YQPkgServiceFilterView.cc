@@ -22,10 +22,10 @@
 #include "YQPkgServiceFilterView.h"
 
 
-YQPkgServiceFilterView::YQPkgServiceFilterView( QWidget * parent )
+YQPkgServiceFilterView::YQPkgServiceFilterView( QWidget * parent, bool autoFill )
     : YQPkgSecondaryFilterView( parent )
 {
-    _serviceList = new YQPkgServiceList( this );
+    _serviceList = new YQPkgServiceList( this, autoFill );
     CHECK_NEW( _serviceList );
 
     init(_serviceList);
@@ -37,6 +37,13 @@ YQPkgServiceFilterView::~YQPkgServiceFilterView()
 }
 
 
+void YQPkgServiceFilterView::fillServiceList()
+{
+    _serviceList->fillList();
+    _serviceList->selectSomething();
+}
+
+
 void YQPkgServiceFilterView::primaryFilter()
 {
     _serviceList->filter();
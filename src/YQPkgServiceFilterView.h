@@ -33,9 +33,12 @@ class YQPkgServiceFilterView : public YQPkgSecondaryFilterView
 public:
 
     /**
-     * Constructor
+     * Constructor.
+     *
+     * Set 'autoFill' to 'false' if you don't want the list to be filled in the
+     * constructor. In that case, use fillServiceList() when it is needed.
      **/
-    YQPkgServiceFilterView( QWidget * parent );
+    YQPkgServiceFilterView( QWidget * parent, bool autoFill = true );
 
     /**
      * Destructor
@@ -47,6 +50,11 @@ public:
      */
     static bool any_service();
 
+    /**
+     * Fill the service list (again).
+     **/
+    void fillServiceList();
+
 protected:
 
     virtual void primaryFilter();
@@ -37,7 +37,7 @@
 using std::string;
 
 
-YQPkgServiceList::YQPkgServiceList( QWidget * parent )
+YQPkgServiceList::YQPkgServiceList( QWidget * parent, bool autoFill )
     : QY2ListView( parent )
 {
     logDebug() << "Creating service list" << endl;
@@ -55,10 +55,14 @@ YQPkgServiceList::YQPkgServiceList( QWidget * parent )
     connect( this, SIGNAL( itemSelectionChanged() ),
              this, SLOT  ( filter()               ) );
 
-    fillList();
     setSortingEnabled( true );
     sortByColumn( nameCol(), Qt::AscendingOrder );
-    selectSomething();
+
+    if ( autoFill )
+    {
+        fillList();
+        selectSomething();
+    }
 
     logDebug() << "Creating service list done" << endl;
 }
@@ -42,9 +42,12 @@ class YQPkgServiceList : public QY2ListView
 public:
 
     /**
-     * Constructor
+     * Constructor.
+     *
+     * Set 'autoFill' to 'false' if you don't want the list to be filled in the
+     * constructor. In that case, use fillList() when it is needed.
      **/
-    YQPkgServiceList( QWidget * parent );
+    YQPkgServiceList( QWidget * parent, bool autoFill = true );
 
     /**
      * Destructor
@@ -54,6 +57,11 @@ public:
 
 public slots:
 
+    /**
+     * Fill the list.
+     **/
+    void fillList();
+
     /**
      * Filter according to the view's rules and current selection.
      * Emits those signals:
@@ -110,14 +118,6 @@ signals:
     void filterFinished();
 
 
-protected slots:
-
-    /**
-     * Fill the list.
-     **/
-    void fillList();
-
-
 private:
 
     int _nameCol;
@@ -34,21 +34,13 @@ YQPkgTechnicalDetailsView::YQPkgTechnicalDetailsView( QWidget * parent )
 
 YQPkgTechnicalDetailsView::~YQPkgTechnicalDetailsView()
 {
-    // NOP
+    stopRendering();
 }
 
 
-void
-YQPkgTechnicalDetailsView::showDetails( ZyppSel selectable )
+QString
+YQPkgTechnicalDetailsView::renderHtml( ZyppSel selectable )
 {
-    _selectable = selectable;
-
-    if ( ! selectable )
-    {
-        clear();
-        return;
-    }
-
     QString html_text = htmlStart();
 
     html_text += htmlHeading( selectable );
@@ -71,7 +63,7 @@ YQPkgTechnicalDetailsView::showDetails( ZyppSel selectable )
 
     html_text += htmlEnd();
 
-    setHtml( html_text );
+    return html_text;
 }
 
 
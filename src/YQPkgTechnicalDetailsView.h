@@ -47,12 +47,12 @@ public:
 protected:
 
     /**
-     * Show details for the specified zypp::ResObject:
+     * Return the HTML for the specified zypp::ResObject:
      * In this case technical data, very much like "rpm -qi".
      *
      * Reimplemented from YQPkgGenericDetailsView.
      **/
-    virtual void showDetails( ZyppSel selectable ) override;
+    virtual QString renderHtml( ZyppSel selectable ) override;
 
     /**
      * Returns a string containing a HTML table for technical details for one
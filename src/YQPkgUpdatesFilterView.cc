@@ -17,9 +17,10 @@
 #include "Exception.h"
 #include "Logger.h"
 #include "MyrlynApp.h"
+#include "PoolStats.h"
 #include "YQPkgConflictDialog.h"
 #include "YQPkgSelector.h"
-#include "YQPkgList.h"
+#include "YQPkgListView.h"
 #include "YQPkgUpdatesFilterView.h"
 
 #ifndef VERBOSE_FILTER_VIEWS
@@ -132,22 +133,7 @@ YQPkgUpdatesFilterView::filter()
 int
 YQPkgUpdatesFilterView::countUpdates()
 {
-    int count = 0;
-
-    for ( ZyppPoolIterator it = zyppPkgBegin();
-          it != zyppPkgEnd();
-          ++it )
-    {
-        ZyppSel selectable = *it;
-
-        if ( isUpdateAvailableFor( selectable ) &&
-             selectable->status() != S_Protected    )
-        {
-            ++count;
-        }
-    }
-
-    return count;
+    return PoolStats::instance()->updatesCount();
 }
 
 
@@ -176,43 +162,39 @@ YQPkgUpdatesFilterView::isUpdateAvailableFor( ZyppSel selectable )
 void
 YQPkgUpdatesFilterView::markLeftovers()
 {
-    YQPkgList * pkgList = YQPkgSelector::instance()->pkgList();
+    YQPkgListView * pkgList = YQPkgSelector::instance()->pkgList();
 
     if ( ! pkgList )
         return;
 
+    YQPkgListModel * model = pkgList->pkgModel();
     QIcon icon;
     QIcon noIcon;
 
-    for ( int i=0; i < pkgList->topLevelItemCount(); ++i )
+    for ( int row = 0; row < model->pkgCount(); ++row )
     {
-        YQPkgListItem * pkgItem = dynamic_cast<YQPkgListItem *>( pkgList->topLevelItem( i ) );
-
-        if ( pkgItem )
+        // After a general package update or dist upgrade, everything that
+        // can be updated without a package conflict should now have an
+        // "update" package status (S_AutoUpdate or S_Update). Anything
+        // else in the package list on this page (only showing package that
+        // could potentially be updated) that is still in status
+        // "installed" (S_KeepInstalled) is left over, i.e. could not be
+        // updated without a package conflict.
+
+        switch ( model->selectable( row )->status() )
         {
-            // After a general package update or dist upgrade, everything that
-            // can be updated without a package conflict should now have an
-            // "update" package status (S_AutoUpdate or S_Update). Anything
-            // else in the package list on this page (only showing package that
-            // could potentially be updated) that is still in status
-            // "installed" (S_KeepInstalled) is left over, i.e. could not be
-            // updated without a package conflict.
-
-            switch ( pkgItem->selectable()->status() )
-            {
-                case S_Update:
-                case S_AutoUpdate:    icon = _updateOkIcon;
-                    break;
-
-                case S_KeepInstalled: icon = _leftoverPkgIcon;
-                    break;
-
-                default: icon = noIcon;
-                    break;
-            }
-
-            pkgItem->setIcon( pkgList->versionCol(), icon );
+            case S_Update:
+            case S_AutoUpdate:    icon = _updateOkIcon;
+                break;
+
+            case S_KeepInstalled: icon = _leftoverPkgIcon;
+                break;
+
+            default: icon = noIcon;
+                break;
         }
+
+        model->setVersionIcon( row, icon );
     }
 }
 
@@ -56,7 +56,7 @@ public:
     /**
      * Return the number of packages in the pool that have an update available,
      * i.e. that are installed and that have a candidate object that is newer
-     * than the installed one.
+     * than the installed one. This is cached in PoolStats.
      **/
     static int countUpdates();
 
@@ -56,6 +56,7 @@ typedef zypp::Pattern::constPtr                 ZyppPattern;
 typedef zypp::Patch::constPtr                   ZyppPatch;
 typedef zypp::Product::constPtr                 ZyppProduct;
 typedef zypp::PoolItem                          ZyppPoolItem;
+typedef std::set<ZyppSel>                       ZyppSelSet;
 
 
 typedef zypp::ResPoolProxy                      ZyppPool;
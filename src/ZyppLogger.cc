@@ -14,11 +14,9 @@
  */
 
 
-#include <unistd.h>	// getpid()
-#include <QString>
+#include <string>
 
 #include "Logger.h"
-#include "utf8.h"
 #include "ZyppLogger.h"
 
 
@@ -29,6 +27,12 @@ ZyppLogger::ZyppLogger()
 {
     logInfo() << "Installing the zypp logger" << endl;
 
+    // libzypp writes a lot of log lines from its own thread, especially
+    // during the commit and in the solver: Don't let that thread wait for
+    // the log file.
+
+    _zyppThreadLogger.setAsync( true );
+
     zypp::base::LogControl::instance().setLineFormater( _lineFormatter );
     zypp::base::LogControl::instance().setLineWriter  ( _lineWriter    );
 }
@@ -54,9 +58,12 @@ ZyppLogger::~ZyppLogger()
 
 void ZyppLogger::logLine( const std::string & message )
 {
+    // The mutex is only for a clean shutdown (see the destructor); the
+    // logger itself is thread-safe.
+
     QMutexLocker locker( &_mutex );
 
-    _zyppThreadLogger.logStream() << message << endl;
+    _zyppThreadLogger.writeLine( message );
 }
 
 
@@ -82,7 +89,7 @@ ZyppLogLineFormatter::format( const std::string &          log_group,
     if ( log_level <= zypp::base::logger::E_DBG )
         return std::string(); // Ignore log level Zypp E_DBG and lower
 
-    QString severity;
+    const char * severity = "";
 
     switch ( log_level )
     {
@@ -99,28 +106,31 @@ ZyppLogLineFormatter::format( const std::string &          log_group,
     // Sample log lines:
     //   2024-12-06 18:24:59.016 [973] <Debug>   MainWindow.cc:89 showPage():  Showing first page
     //   2024-12-06 18:24:59.018 [973] <Debug>   [zypp-foo] foo_bar.cc:89 zyppify():    zyppifying...
+    //
+    // This is called for every single zypp log line, so this uses plain
+    // std::string operations rather than QString to avoid the conversions.
 
-    QString lineHeader( Logger::timeStamp() );
+    std::string logLine( Logger::cachedTimeStamp() );
+    logLine.reserve( logLine.size() + message.size() + 100 );
 
-    lineHeader += QString( " [%1] " ).arg( (int) getpid() );
-    lineHeader += severity + " ";
+    logLine += " [" + std::to_string( Logger::pid() ) + "] ";
+    logLine += severity;
+    logLine += " [";
 
-    QString logComponent = fromUTF8( log_group );
+    if ( log_group.compare( 0, 4, "zypp" ) != 0 )
+        logLine += "zypp ";
 
-    if ( ! logComponent.startsWith( "zypp" ) )
-        logComponent.prepend( "zypp " );
-
-    lineHeader += QString( "[%1] " ).arg( logComponent.trimmed() );
-    lineHeader += QString( src_file );
+    logLine += log_group;
+    logLine += "] ";
+    logLine += src_file ? src_file : "";
 
     if ( src_line > 0 )  // int
-        lineHeader += QString( ":%1" ).arg( src_line );
-
-    lineHeader += QString( " %1(): " ).arg( fromUTF8( src_func ) );
-
-    std::string logLine( toUTF8( lineHeader ) );
-    logLine += " " + message;
+        logLine += ":" + std::to_string( src_line );
 
+    logLine += " ";
+    logLine += src_func ? src_func : "";
+    logLine += "():  ";
+    logLine += message;
 
     return logLine;
 }
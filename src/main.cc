@@ -21,6 +21,7 @@
 
 #include "Logger.h"
 #include "MyrlynApp.h"
+#include "StartupTimer.h"
 
 
 using std::cerr;
@@ -44,6 +45,7 @@ void usage()
 	 << "  -d | --download-only\n"
          << "  -f | --no-repo-refresh\n"
          << "  -v | --force-service-view\n"
+         << "  --fast-start (root only: refresh repos in the background)\n"
 	 << "  -h | --help \n"
 	 << "\n"
 	 << "Debugging options:\n"
@@ -53,6 +55,7 @@ void usage()
 	 << "  --fake-summary\n"
 	 << "  --fake-translations  (\"xixoxixoxixo\" everywhere)\n"
          << "  --slow-repo-refresh\n"
+         << "  --benchmark-startup  (print startup timings as JSON and quit)\n"
 	 << "\n"
 	 << std::endl;
 
@@ -97,11 +100,13 @@ parseCommandLineOptions( QStringList & argList )
     if ( commandLineOption( "--download-only",      "-d", argList ) ) optFlags |= OptDownloadOnly;
     if ( commandLineOption( "--no-repo-refresh",    "-f", argList ) ) optFlags |= OptNoRepoRefresh;
     if ( commandLineOption( "--force-service-view", "-v", argList ) ) optFlags |= OptForceServiceView;
+    if ( commandLineOption( "--fast-start",         "" ,  argList ) ) optFlags |= OptFastStart;
     if ( commandLineOption( "--fake-root",          "" ,  argList ) ) optFlags |= OptFakeRoot;
     if ( commandLineOption( "--fake-commit",        "" ,  argList ) ) optFlags |= OptFakeCommit;
     if ( commandLineOption( "--fake-summary",       "" ,  argList ) ) optFlags |= OptFakeSummary;
     if ( commandLineOption( "--fake-translations",  "" ,  argList ) ) optFlags |= OptFakeTranslations;
     if ( commandLineOption( "--slow-repo-refresh",  "" ,  argList ) ) optFlags |= OptSlowRepoRefresh;
+    if ( commandLineOption( "--benchmark-startup",  "" ,  argList ) ) optFlags |= OptBenchmarkStartup;
     if ( commandLineOption( "--help",               "-h", argList ) ) usage(); // this will exit
 
     if ( ! argList.isEmpty() )
@@ -127,7 +132,10 @@ void logVersion()
 
 int main( int argc, char *argv[] )
 {
+    StartupTimer::instance(); // Start timing as early as possible
+
     Logger logger( "/tmp/myrlyn-$USER", "myrlyn.log" );
+    logger.setAsync( true ); // Write the log file in a background thread
     logVersion();
 
     // Set org/app name for QSettings
@@ -0,0 +1,127 @@
+/*
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include <stdio.h>      // printf()
+#include <stdlib.h>     // atoi()
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include "../../src/Logger.h"
+
+
+// Measure the cost of log statements below the log level, i.e. of log lines
+// that are never written: With the old log macros, Logger::log() was always
+// called, and the complete '<<' chain was formatted into /dev/null. The log
+// macros now check the log level first and skip all of that.
+//
+// For comparison, this also measures log lines that are actually written,
+// synchronously and in async mode.
+//
+// Usage:
+//
+//   log-benchmark [<disabled-statements> [<enabled-statements>]]
+
+
+/**
+ * Something to log that is not completely free to format.
+ **/
+static QString pkgName( int i )
+{
+    return QString( "benchmark-pkg-%1" ).arg( i );
+}
+
+
+/**
+ * Print one result line.
+ **/
+static void printResult( const char * name, int count, double millisec )
+{
+    printf( "%-28s %10d %12.3f %10.1f\n",
+            name, count, millisec, count > 0 ? millisec * 1000000.0 / count : 0.0 );
+}
+
+
+int main( int argc, char *argv[] )
+{
+    Logger logger( "/tmp/myrlyn-$USER", "log-benchmark.log" );
+
+    int disabledCount = argc > 1 ? atoi( argv[1] ) : 1000000;
+    int enabledCount  = argc > 2 ? atoi( argv[2] ) : 100000;
+
+    logger.setLogLevel( LogSeverityInfo );
+
+    QElapsedTimer timer;
+
+    printf( "%-28s %10s %12s %10s\n", "Log statement", "Count", "Time [ms]", "ns / call" );
+
+
+    // Disabled: What the old logDebug() macro did
+
+    timer.start();
+
+    for ( int i = 0; i < disabledCount; ++i )
+    {
+        Logger::log( 0, QString( __FILE__ ), __LINE__, QString( __FUNCTION__ ), LogSeverityDebug )
+            << "Package " << pkgName( i ) << " status: " << i % 7 << endl;
+    }
+
+    printResult( "Disabled, old macro", disabledCount, timer.nsecsElapsed() / 1000000.0 );
+
+
+    // Disabled: Logger::log() with const char * arguments, but no check first
+
+    timer.restart();
+
+    for ( int i = 0; i < disabledCount; ++i )
+    {
+        Logger::log( 0, LOG_SRC_FILE, __LINE__, __FUNCTION__, LogSeverityDebug )
+            << "Package " << pkgName( i ) << " status: " << i % 7 << endl;
+    }
+
+    printResult( "Disabled, Logger::log()", disabledCount, timer.nsecsElapsed() / 1000000.0 );
+
+
+    // Disabled: The current logDebug() macro
+
+    timer.restart();
+
+    for ( int i = 0; i < disabledCount; ++i )
+        logDebug() << "Package " << pkgName( i ) << " status: " << i % 7 << endl;
+
+    printResult( "Disabled, logDebug()", disabledCount, timer.nsecsElapsed() / 1000000.0 );
+
+
+    // Enabled: Written to the log file in this thread
+
+    timer.restart();
+
+    for ( int i = 0; i < enabledCount; ++i )
+        logInfo() << "Package " << pkgName( i ) << " status: " << i % 7 << endl;
+
+    printResult( "Enabled, sync", enabledCount, timer.nsecsElapsed() / 1000000.0 );
+
+
+    // Enabled: Written to the log file by the background thread
+
+    logger.setAsync( true );
+    timer.restart();
+
+    for ( int i = 0; i < enabledCount; ++i )
+        logInfo() << "Package " << pkgName( i ) << " status: " << i % 7 << endl;
+
+    printResult( "Enabled, async", enabledCount, timer.nsecsElapsed() / 1000000.0 );
+
+    timer.restart();
+    logger.flush();
+
+    printResult( "Enabled, async flush", 0, timer.nsecsElapsed() / 1000000.0 );
+
+    return 0;
+}
@@ -0,0 +1,268 @@
+/*
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include <stdio.h>      // printf()
+#include <stdlib.h>     // atoi()
+
+#include <algorithm>    // std::shuffle()
+#include <random>
+#include <string>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+
+#include <zypp/IdString.h>
+
+#include "../../src/Logger.h"
+#include "../../src/PkgTasks.h"
+#include "../../src/utf8.h"
+
+
+// Simulate the package task bookkeeping of a large commit transaction:
+// Each package is downloaded, then installed, with a number of progress
+// callbacks in each stage, and for each callback, the task is looked up in
+// the list of the current stage.
+//
+// This compares the hash index of PkgTaskList with a linear search by name
+// like PkgTaskList::find( ZyppRes ) used to do.
+//
+// Then it measures moving the tasks from one list to another on its own:
+// Since libzypp uses its own order, the tasks are taken from anywhere in
+// the list, not from the start. This compares PkgTasks::moveTask() with
+// indexOf() and takeAt() on a plain QList like PkgTaskList::take() used
+// to do.
+//
+// Usage:
+//
+//   pkg-tasks-benchmark [<number-of-tasks> [<progress-callbacks-per-stage>]]
+
+
+/**
+ * One package of the simulated transaction, as the commit callbacks see it.
+ **/
+struct SimPkg
+{
+    std::string    name;
+    zypp::IdString ident;
+};
+
+
+/**
+ * Find the task for 'name' in 'list' the way it used to be done:
+ * Convert the name and compare it with every task in the list.
+ **/
+PkgTask * linearFind( const PkgTaskList & list, const std::string & name )
+{
+    QString resName = fromUTF8( name );
+
+    for ( PkgTask * task: list )
+    {
+        if ( task && task->name() == resName )
+            return task;
+    }
+
+    return 0;
+}
+
+
+/**
+ * Fill the 'todo' list of 'tasks' with one task for each of 'pkgs'.
+ **/
+void createTasks( PkgTasks & tasks, const std::vector<SimPkg> & pkgs )
+{
+    tasks.clearAll();
+
+    for ( const SimPkg & pkg: pkgs )
+        tasks.todo().append( new PkgTask( fromUTF8( pkg.name ), PkgUpdate, PkgReqDep ) );
+}
+
+
+/**
+ * Run the simulated transaction for 'pkgs' in the order of that vector and
+ * return the number of lookups that failed.
+ **/
+template<typename FindFunc>
+int runTransaction( PkgTasks &                  tasks,
+                    const std::vector<SimPkg> & pkgs,
+                    int                         progressCallbacks,
+                    FindFunc                    find )
+{
+    int errors = 0;
+
+    for ( const SimPkg & pkg: pkgs )
+    {
+        // pkgDownloadStart()
+
+        PkgTask * task = find( tasks.todo(), pkg );
+
+        if ( ! task )
+        {
+            ++errors;
+            continue;
+        }
+
+        PkgTasks::moveTask( task, tasks.todo(), tasks.downloads() );
+
+        // pkgDownloadProgress()
+
+        for ( int i = 0; i < progressCallbacks; ++i )
+        {
+            task = find( tasks.downloads(), pkg );
+
+            if ( task )
+                task->setDownloadedPercent( ( 100 * i ) / progressCallbacks );
+            else
+                ++errors;
+        }
+
+        // pkgActionStart()
+
+        task = find( tasks.downloads(), pkg );
+
+        if ( ! task )
+        {
+            ++errors;
+            continue;
+        }
+
+        PkgTasks::moveTask( task, tasks.downloads(), tasks.doing() );
+
+        // pkgActionProgress()
+
+        for ( int i = 0; i < progressCallbacks; ++i )
+        {
+            task = find( tasks.doing(), pkg );
+
+            if ( task )
+                task->setCompletedPercent( ( 100 * i ) / progressCallbacks );
+            else
+                ++errors;
+        }
+
+        // pkgActionEnd()
+
+        task = find( tasks.doing(), pkg );
+
+        if ( task )
+            PkgTasks::moveTask( task, tasks.doing(), tasks.done() );
+        else
+            ++errors;
+    }
+
+    return errors;
+}
+
+
+int main( int argc, char *argv[] )
+{
+    Logger logger( "/tmp/myrlyn-$USER", "pkg-tasks-benchmark.log" );
+
+    int taskCount         = argc > 1 ? atoi( argv[1] ) : 10000;
+    int progressCallbacks = argc > 2 ? atoi( argv[2] ) : 5;
+
+    std::vector<SimPkg> pkgs;
+    pkgs.reserve( taskCount );
+
+    for ( int i = 0; i < taskCount; ++i )
+    {
+        std::string name = "benchmark-pkg-" + std::to_string( i );
+        pkgs.push_back( SimPkg { name, zypp::IdString( name ) } );
+    }
+
+    // libzypp doesn't process the packages in the order of the todo list;
+    // it uses its own order that is determined by the dependencies.
+
+    std::vector<SimPkg> commitOrder( pkgs );
+    std::shuffle( commitOrder.begin(), commitOrder.end(), std::mt19937( 42 ) );
+
+    PkgTasks      tasks;
+    QElapsedTimer timer;
+
+    printf( "Simulated transaction with %d tasks, %d progress callbacks per stage\n\n",
+            taskCount, progressCallbacks );
+
+    printf( "%-16s %12s %8s\n", "Lookup", "Time [ms]", "Errors" );
+
+
+    createTasks( tasks, pkgs );
+    timer.start();
+
+    int errors = runTransaction( tasks, commitOrder, progressCallbacks,
+                                 []( const PkgTaskList & list, const SimPkg & pkg )
+                                 {
+                                     return linearFind( list, pkg.name );
+                                 } );
+
+    double linearMillisec = timer.nsecsElapsed() / 1000000.0;
+    printf( "%-16s %12.3f %8d\n", "Linear by name", linearMillisec, errors );
+
+
+    createTasks( tasks, pkgs );
+    timer.restart();
+
+    errors = runTransaction( tasks, commitOrder, progressCallbacks,
+                             []( const PkgTaskList & list, const SimPkg & pkg )
+                             {
+                                 return list.find( pkg.ident );
+                             } );
+
+    double indexMillisec = timer.nsecsElapsed() / 1000000.0;
+    printf( "%-16s %12.3f %8d\n", "Hash index", indexMillisec, errors );
+
+    printf( "\nSpeedup: %.1fx\n\n", indexMillisec > 0.0 ? linearMillisec / indexMillisec : 0.0 );
+
+
+    printf( "%-16s %12s %8s\n", "Move tasks", "Time [ms]", "Errors" );
+
+    createTasks( tasks, pkgs );
+    std::vector<PkgTask *> moveOrder;
+    moveOrder.reserve( taskCount );
+
+    for ( const SimPkg & pkg: commitOrder )
+        moveOrder.push_back( tasks.todo().find( pkg.ident ) );
+
+    QList<PkgTask *> fromList;
+    QList<PkgTask *> toList;
+
+    for ( PkgTask * task: tasks.todo() )
+        fromList.append( task );
+
+    timer.restart();
+
+    for ( PkgTask * task: moveOrder )
+    {
+        fromList.takeAt( fromList.indexOf( task ) );
+        toList.append( task );
+    }
+
+    double takeAtMillisec = timer.nsecsElapsed() / 1000000.0;
+    printf( "%-16s %12.3f\n", "indexOf/takeAt", takeAtMillisec );
+
+    timer.restart();
+
+    for ( PkgTask * task: moveOrder )
+        PkgTasks::moveTask( task, tasks.todo(), tasks.downloads() );
+
+    // Iterating over the old list removes the holes that moveTask() left
+    // there; that is part of the cost.
+
+    errors = taskCount - tasks.downloads().size();
+
+    for ( PkgTask * task: tasks.todo() )
+        errors += task ? 1 : 0;
+
+    double moveMillisec = timer.nsecsElapsed() / 1000000.0;
+    printf( "%-16s %12.3f %8d\n", "moveTask()", moveMillisec, errors );
+
+    printf( "\nSpeedup: %.1fx\n", moveMillisec > 0.0 ? takeAtMillisec / moveMillisec : 0.0 );
+
+    return 0;
+}
@@ -0,0 +1,226 @@
+/*
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include <stdio.h>      // printf()
+#include <stdlib.h>     // atoi()
+#include <unistd.h>     // getpid()
+
+#include <string>
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QTimer>
+
+#include <zypp/RepoInfo.h>
+#include <zypp/RepoManagerOptions.h>
+#include <zypp/Url.h>
+
+#include "../../src/Logger.h"
+#include "../../src/RepoRefresher.h"
+
+
+// Refresh a number of local dir:// repos with synthetic rpm-md metadata
+// in the RepoRefresher worker thread, with an artificial latency for each
+// repo to simulate slow mirrors.
+//
+// libzypp can't refresh several repos at the same time, so the total time
+// is the same as refreshing them in the GUI thread. What the worker thread
+// is for is keeping the event loop running in the meantime: This measures
+// the longest time that a 10 ms timer in the event loop was delayed, and it
+// checks that all repos are refreshed correctly.
+//
+// Everything happens below a temporary directory in /tmp with a zypp test
+// setup for the repo manager, so this doesn't touch the system's repos and
+// it doesn't need root permissions.
+//
+// Usage:
+//
+//   repo-refresh-benchmark [<repos> [<latency-millisec>]]
+
+
+#define PACKAGES_PER_REPO       500
+
+// Interval of the timer that checks if the event loop is still responsive
+#define TICK_MILLISEC           10
+
+
+/**
+ * Write 'content' to the file 'path'. Return the SHA256 checksum of the
+ * content as a hex string.
+ **/
+QString writeFile( const QString & path, const QByteArray & content )
+{
+    QFile file( path );
+
+    if ( ! file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+    {
+        fprintf( stderr, "Can't write %s\n", qPrintable( path ) );
+        exit( 1 );
+    }
+
+    file.write( content );
+
+    return QString::fromLatin1( QCryptographicHash::hash( content, QCryptographicHash::Sha256 ).toHex() );
+}
+
+
+/**
+ * Create a local repo with synthetic rpm-md metadata in 'dir' and return
+ * the RepoInfo for it.
+ **/
+zypp::RepoInfo createRepo( const QString & dir, int repoNo )
+{
+    QDir().mkpath( dir + "/repodata" );
+
+    QByteArray primary;
+    primary += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<metadata xmlns=\"http://linux.duke.edu/metadata/common\""
+        " xmlns:rpm=\"http://linux.duke.edu/metadata/rpm\""
+        " packages=\"" + QByteArray::number( PACKAGES_PER_REPO ) + "\">\n";
+
+    for ( int i = 0; i < PACKAGES_PER_REPO; ++i )
+    {
+        QByteArray name = "bench-" + QByteArray::number( repoNo ) + "-" + QByteArray::number( i );
+        QByteArray checksum = QCryptographicHash::hash( name, QCryptographicHash::Sha256 ).toHex();
+
+        primary +=
+            "<package type=\"rpm\">\n"
+            "  <name>" + name + "</name>\n"
+            "  <arch>noarch</arch>\n"
+            "  <version epoch=\"0\" ver=\"1.0\" rel=\"1\"/>\n"
+            "  <checksum type=\"sha256\" pkgid=\"YES\">" + checksum + "</checksum>\n"
+            "  <summary>Synthetic benchmark package " + name + "</summary>\n"
+            "  <description>Synthetic package for the repo refresh benchmark</description>\n"
+            "  <location href=\"noarch/" + name + "-1.0-1.noarch.rpm\"/>\n"
+            "  <format>\n"
+            "    <rpm:provides>\n"
+            "      <rpm:entry name=\"" + name + "\" flags=\"EQ\" epoch=\"0\" ver=\"1.0\" rel=\"1\"/>\n"
+            "    </rpm:provides>\n"
+            "  </format>\n"
+            "</package>\n";
+    }
+
+    primary += "</metadata>\n";
+
+    QString primaryChecksum = writeFile( dir + "/repodata/primary.xml", primary );
+
+    QByteArray repomd;
+    repomd += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<repomd xmlns=\"http://linux.duke.edu/metadata/repo\""
+        " xmlns:rpm=\"http://linux.duke.edu/metadata/rpm\">\n"
+        "  <revision>1</revision>\n"
+        "  <data type=\"primary\">\n"
+        "    <checksum type=\"sha256\">" + primaryChecksum.toLatin1() + "</checksum>\n"
+        "    <open-checksum type=\"sha256\">" + primaryChecksum.toLatin1() + "</open-checksum>\n"
+        "    <location href=\"repodata/primary.xml\"/>\n"
+        "    <timestamp>1700000000</timestamp>\n"
+        "    <size>" + QByteArray::number( primary.size() ) + "</size>\n"
+        "  </data>\n"
+        "</repomd>\n";
+
+    writeFile( dir + "/repodata/repomd.xml", repomd );
+
+    std::string alias = "benchmark-" + std::to_string( repoNo );
+
+    zypp::RepoInfo repo;
+    repo.setAlias( alias );
+    repo.setName( alias );
+    repo.setBaseUrl( zypp::Url( "dir://" + dir.toStdString() ) );
+    repo.setType( zypp::repo::RepoType::RPMMD );
+    repo.setGpgCheck( false );
+    repo.setEnabled( true );
+
+    return repo;
+}
+
+
+/**
+ * Refresh 'repos' and return the elapsed time in milliseconds. Return the
+ * number of failed repos in 'failedRet' and the longest delay of the event
+ * loop in milliseconds in 'maxStallRet'.
+ **/
+double runRefresh( const zypp::RepoManagerOptions & options,
+                   const RepoInfoList &             repos,
+                   int                              latencyMillisec,
+                   int &                            failedRet,
+                   double &                         maxStallRet )
+{
+    RepoRefresher refresher( options );
+    refresher.setLatencyMillisec( latencyMillisec );
+    refresher.setForceRefresh( true );
+
+    // The event loop of refresh() calls this every TICK_MILLISEC
+    // if it is not blocked
+
+    QElapsedTimer tickTimer;
+    QTimer        ticker;
+
+    maxStallRet = 0.0;
+    ticker.setInterval( TICK_MILLISEC );
+
+    QObject::connect( &ticker, &QTimer::timeout, [&]()
+        {
+            double stall = tickTimer.nsecsElapsed() / 1000000.0 - TICK_MILLISEC;
+
+            if ( stall > maxStallRet )
+                maxStallRet = stall;
+
+            tickTimer.restart();
+        });
+
+    QElapsedTimer timer;
+    timer.start();
+    tickTimer.start();
+    ticker.start();
+
+    refresher.refresh( repos );
+
+    ticker.stop();
+    failedRet = (int) refresher.failedRepos().size();
+
+    return timer.nsecsElapsed() / 1000000.0;
+}
+
+
+int main( int argc, char *argv[] )
+{
+    QCoreApplication app( argc, argv ); // for the event loop in RepoRefresher
+    Logger logger( "/tmp/myrlyn-$USER", "repo-refresh-benchmark.log" );
+
+    int repoCount       = argc > 1 ? atoi( argv[1] ) : 15;
+    int latencyMillisec = argc > 2 ? atoi( argv[2] ) : 1000;
+
+    QString baseDir = QString( "/tmp/myrlyn-repo-refresh-benchmark-%1" ).arg( getpid() );
+    zypp::RepoManagerOptions options =
+        zypp::RepoManagerOptions::makeTestSetup( ( baseDir + "/root" ).toStdString() );
+
+    RepoInfoList repos;
+
+    for ( int i = 0; i < repoCount; ++i )
+        repos.push_back( createRepo( QString( "%1/repos/repo-%2" ).arg( baseDir ).arg( i ), i ) );
+
+    printf( "Refreshing %d local repos with %d packages each, %d ms latency each\n\n",
+            repoCount, PACKAGES_PER_REPO, latencyMillisec );
+
+    printf( "%12s %8s %16s\n", "Time [ms]", "Failed", "Max. stall [ms]" );
+
+    int    failed   = 0;
+    double maxStall = 0.0;
+    double millisec = runRefresh( options, repos, latencyMillisec, failed, maxStall );
+
+    printf( "%12.1f %8d %16.1f\n", millisec, failed, maxStall );
+
+    QDir( baseDir ).removeRecursively();
+
+    return 0;
+}
@@ -0,0 +1,250 @@
+/*
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) 2024-25 SUSE LLC
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include <stdio.h>      // printf()
+#include <stdlib.h>     // atoi()
+
+#include <random>
+#include <string>
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <zypp/PoolQuery.h>
+#include <zypp/Repository.h>
+#include <zypp/sat/Pool.h>
+
+#include <solv/knownid.h>
+#include <solv/pool.h>
+#include <solv/repo.h>
+
+#include "../../src/Logger.h"
+#include "../../src/PkgSearchIndex.h"
+#include "../../src/SearchFilter.h"
+
+
+// Compare the latency of the PkgSearchIndex with a zypp::PoolQuery for the
+// same search on a synthetic pool of package solvables.
+//
+// Usage:
+//
+//   search-index-benchmark [<number-of-packages> [<repetitions>]]
+
+
+static const char * prefixes[] =
+{
+    "", "", "", "lib", "lib", "python3-", "python311-", "perl-", "ruby3.4-rubygem-",
+    "golang-github-", "texlive-", "kernel-", "xorg-x11-", "gnome-", "kf6-",
+    "rust-", "nodejs-", "ghc-", "qt6-", "yast2-"
+};
+
+static const char * syllables[] =
+{
+    "ab", "ac", "al", "an", "ar", "ba", "be", "bo", "ca", "ce", "co", "cu",
+    "da", "de", "di", "do", "el", "en", "er", "fa", "fi", "fo", "ga", "ge",
+    "gi", "ha", "he", "in", "is", "ja", "ka", "ke", "la", "le", "li", "lo",
+    "ma", "me", "mi", "mo", "na", "ne", "ni", "no", "or", "pa", "pe", "pi",
+    "ra", "re", "ri", "ro", "sa", "se", "si", "so", "ta", "te", "ti", "to",
+    "un", "va", "ve", "xo", "za", "ze", "zo", "xml", "gtk", "ssl", "dbus"
+};
+
+static const char * suffixes[] =
+{
+    "", "", "", "", "-devel", "-devel", "-lang", "-doc", "-32bit",
+    "-debuginfo", "-debugsource", "-tools", "-utils"
+};
+
+static const char * words[] =
+{
+    "library", "tool", "tools", "for", "the", "and", "of", "a", "to",
+    "development", "files", "documentation", "translations", "plugin",
+    "Python", "Perl", "Ruby", "Go", "Rust", "module", "bindings", "support",
+    "XML", "parser", "network", "server", "client", "GNOME", "KDE", "Qt",
+    "kernel", "driver", "font", "fonts", "utility", "utilities", "command",
+    "line", "interface", "graphical", "image", "audio", "video", "codec",
+    "compression", "encryption", "shared", "static", "debug", "information",
+    "sources", "headers", "package", "manager", "system", "configuration"
+};
+
+
+template<typename T, size_t N> size_t arraySize( T (&)[N] ) { return N; }
+
+
+/**
+ * Create a repo with 'count' synthetic package solvables with random names
+ * and summaries in the zypp pool.
+ **/
+void createSyntheticPool( int count )
+{
+    std::mt19937 random( 42 ); // Fixed seed: Reproducible results
+
+    auto pick = [&]( const char ** array, size_t size ) -> const char *
+        {
+            return array[ random() % size ];
+        };
+
+    zypp::Repository repo  = zypp::sat::Pool::instance().reposInsert( "benchmark" );
+    ::Repo *         cRepo = repo.get();
+    ::Pool *         cPool = zypp::sat::Pool::instance().get();
+
+    Id archId = pool_str2id( cPool, "x86_64", 1 );
+    Id evrId  = pool_str2id( cPool, "1.0-1",  1 );
+
+    for ( int i = 0; i < count; ++i )
+    {
+        std::string name = pick( prefixes, arraySize( prefixes ) );
+        int syllableCount = 2 + random() % 3;
+
+        for ( int j = 0; j < syllableCount; ++j )
+            name += pick( syllables, arraySize( syllables ) );
+
+        name += std::to_string( i % 100 );
+        name += pick( suffixes, arraySize( suffixes ) );
+
+        std::string summary;
+        int wordCount = 4 + random() % 6;
+
+        for ( int j = 0; j < wordCount; ++j )
+        {
+            if ( j > 0 )
+                summary += " ";
+
+            summary += pick( words, arraySize( words ) );
+        }
+
+        Id         id       = repo_add_solvable( cRepo );
+        ::Solvable * solvable = pool_id2solvable( cPool, id );
+
+        solvable->name     = pool_str2id( cPool, name.c_str(), 1 );
+        solvable->evr      = evrId;
+        solvable->arch     = archId;
+        solvable->provides = repo_addid_dep( cRepo, solvable->provides,
+                                             pool_rel2id( cPool, solvable->name, evrId, REL_EQ, 1 ),
+                                             0 );
+
+        repo_set_str( cRepo, id, SOLVABLE_SUMMARY, summary.c_str() );
+    }
+
+    repo_internalize( cRepo );
+}
+
+
+/**
+ * Run a PoolQuery for 'searchFilter' in names and summaries and return the
+ * number of matching solvables.
+ **/
+int poolQueryCount( const SearchFilter & searchFilter )
+{
+    zypp::PoolQuery query;
+    query.addKind( zypp::ResKind::package );
+    query.setCaseSensitive( searchFilter.isCaseSensitive() );
+
+    std::string pattern = searchFilter.pattern().toStdString();
+
+    switch ( searchFilter.filterMode() )
+    {
+        case SearchFilter::StartsWith:
+            query.setMatchRegex();
+            pattern = "^" + pattern;
+            break;
+
+        case SearchFilter::Wildcard:
+            query.setMatchGlob();
+            break;
+
+        default:
+            query.setMatchSubstring();
+            break;
+    }
+
+    query.addString( pattern );
+    query.addAttribute( zypp::sat::SolvAttr::name    );
+    query.addAttribute( zypp::sat::SolvAttr::summary );
+
+    int count = 0;
+
+    for ( zypp::PoolQuery::const_iterator it = query.begin(); it != query.end(); ++it )
+        ++count;
+
+    return count;
+}
+
+
+int main( int argc, char *argv[] )
+{
+    Logger logger( "/tmp/myrlyn-$USER", "search-index-benchmark.log" );
+
+    int pkgCount    = argc > 1 ? atoi( argv[1] ) : 100000;
+    int repetitions = argc > 2 ? atoi( argv[2] ) : 10;
+
+    QElapsedTimer timer;
+    timer.start();
+    createSyntheticPool( pkgCount );
+    printf( "Created %d synthetic packages in %lld ms\n", pkgCount, (long long) timer.elapsed() );
+
+    PkgSearchIndex searchIndex;
+
+    timer.restart();
+    searchIndex.build();
+    printf( "Built the search index in %lld ms\n\n", (long long) timer.elapsed() );
+
+    SearchFilter filters[] =
+    {
+        SearchFilter( "lib",            SearchFilter::Contains   ),
+        SearchFilter( "devel",          SearchFilter::Contains   ),
+        SearchFilter( "python3-",       SearchFilter::StartsWith ),
+        SearchFilter( "kernel-ma",      SearchFilter::StartsWith ),
+        SearchFilter( "xml",            SearchFilter::Contains   ),
+        SearchFilter( "bindings",       SearchFilter::Contains   ),
+        SearchFilter( "gtkssl",         SearchFilter::Contains   ),
+        SearchFilter( "*dbus*-devel",   SearchFilter::Wildcard   ),
+        SearchFilter( "nonexistent",    SearchFilter::Contains   )
+    };
+
+    printf( "%-16s %-10s %8s %8s %12s %12s %8s\n",
+            "Pattern", "Mode", "Index", "Query", "Index [ms]", "Query [ms]", "Speedup" );
+
+    for ( const SearchFilter & searchFilter: filters )
+    {
+        if ( ! searchIndex.canSearch( searchFilter ) )
+        {
+            printf( "%-16s: Not supported by the index\n", qPrintable( searchFilter.pattern() ) );
+            continue;
+        }
+
+        int indexCount = 0;
+        int queryCount = 0;
+
+        timer.restart();
+
+        for ( int i = 0; i < repetitions; ++i )
+            indexCount = (int) searchIndex.findSolvables( searchFilter, true, true ).size();
+
+        double indexMillisec = timer.nsecsElapsed() / 1000000.0 / repetitions;
+
+        timer.restart();
+
+        for ( int i = 0; i < repetitions; ++i )
+            queryCount = poolQueryCount( searchFilter );
+
+        double queryMillisec = timer.nsecsElapsed() / 1000000.0 / repetitions;
+
+        printf( "%-16s %-10s %8d %8d %12.3f %12.3f %7.1fx%s\n",
+                qPrintable( searchFilter.pattern() ),
+                qPrintable( SearchFilter::toString( searchFilter.filterMode() ) ),
+                indexCount,
+                queryCount,
+                indexMillisec,
+                queryMillisec,
+                indexMillisec > 0.0 ? queryMillisec / indexMillisec : 0.0,
+                indexCount == queryCount ? "" : "  MISMATCH" );
+    }
+
+    return 0;
+}